@@ -0,0 +1,52 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Arena.hpp"
+#include "Stats.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	constexpr size_t MIN_BLOCK_SIZE = 64 * 1024;
+
+	// Offset of the first suitably aligned address at or after data + offset
+	size_t AlignOffset(const std::byte *data, const size_t offset, const size_t alignment) noexcept
+	{
+		const auto address = reinterpret_cast<uintptr_t>(data) + offset;
+		return offset + ((alignment - (address % alignment)) % alignment);
+	}
+}
+
+void Arena::Reset() noexcept
+{
+	m_currentBlock = 0;
+	m_offset = 0;
+}
+
+void *Arena::do_allocate(const size_t bytes, const size_t alignment)
+{
+	Stats::Add(Counter::ArenaAllocations, 1);
+
+	// Continue in the current block, or move on to the next block that is large enough
+	for (size_t block = m_currentBlock; block < m_blocks.size(); block++)
+	{
+		const size_t offset = AlignOffset(m_blocks[block].data.get(), (block == m_currentBlock) ? m_offset : 0, alignment);
+		if (offset <= m_blocks[block].size && bytes <= m_blocks[block].size - offset)
+		{
+			m_currentBlock = block;
+			m_offset = offset + bytes;
+			return m_blocks[block].data.get() + offset;
+		}
+	}
+
+	// Grow geometrically so that the number of blocks stays small
+	const size_t blockSize = std::max({bytes + alignment, MIN_BLOCK_SIZE, m_blocks.empty() ? size_t(0) : m_blocks.back().size * 2});
+	Block &block = m_blocks.emplace_back(Block{std::make_unique_for_overwrite<std::byte[]>(blockSize), blockSize});
+	m_currentBlock = m_blocks.size() - 1;
+	const size_t offset = AlignOffset(block.data.get(), 0, alignment);
+	m_offset = offset + bytes;
+	return block.data.get() + offset;
+}
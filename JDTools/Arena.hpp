@@ -0,0 +1,41 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+// Memory resource for the temporary buffers of a job that repeats the same work, e.g. writing one bank after another.
+// Allocations are carved out of larger blocks, and deallocation does nothing.
+// Reset() makes all blocks available again without returning them to the heap, so once the first iteration of a job
+// has grown the arena to its working size, the following iterations no longer allocate any memory from the heap.
+// An arena must only be used by one thread at a time.
+class Arena final : public std::pmr::memory_resource
+{
+public:
+	Arena() = default;
+	Arena(const Arena &) = delete;
+	Arena &operator=(const Arena &) = delete;
+
+	// All memory handed out by the arena must no longer be in use
+	void Reset() noexcept;
+
+private:
+	void *do_allocate(size_t bytes, size_t alignment) override;
+	void do_deallocate(void *, size_t, size_t) noexcept override { }
+	bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override { return this == &other; }
+
+	struct Block
+	{
+		std::unique_ptr<std::byte[]> data;
+		size_t size = 0;
+	};
+
+	std::vector<Block> m_blocks;
+	size_t m_currentBlock = 0;
+	size_t m_offset = 0;  // Within current block
+};
@@ -0,0 +1,420 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Arrow.hpp"
+#include "JDTools.hpp"
+#include "Stats.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <initializer_list>
+#include <iostream>
+#include <span>
+#include <type_traits>
+
+namespace
+{
+	// Record batches are sized so that all columns of a batch fit into a typical L2 cache
+	constexpr size_t BATCH_SIZE_BYTES = 256 * 1024;
+	// Arrow requires all buffers to be 8-byte aligned
+	constexpr size_t ALIGNMENT = 8;
+
+	// Enum values from Schema.fbs and Message.fbs
+	constexpr int16_t METADATA_VERSION_V5 = 4;
+	constexpr uint8_t MESSAGE_HEADER_SCHEMA = 1;
+	constexpr uint8_t MESSAGE_HEADER_RECORD_BATCH = 3;
+	constexpr uint8_t TYPE_INT = 2;
+	constexpr uint8_t TYPE_UTF8 = 5;
+
+	// Parameters of other formats that have no equivalent in JD-800 patches
+	bool IsExtraParameter(const Patch990 *, const ParameterInfo &param) { return param.name.starts_with("structureType."); }
+	bool IsExtraParameter(const PatchVST *, const ParameterInfo &param) { return param.name == "unison" || param.name.find("Sync") != std::string_view::npos; }
+
+	// Minimal FlatBuffers serializer for the Arrow IPC metadata.
+	// Unlike the official builder, objects are written front to back: A table is written before the objects it refers to,
+	// and each reference is filled in once the referenced object has been written, so that references always point forward.
+	class FlatBufferWriter
+	{
+	public:
+		struct Field
+		{
+			uint16_t slot;
+			uint8_t size;
+			int64_t value;
+			size_t *reference;  // Receives the position of the reference if this is a reference field
+
+			static Field Scalar(const uint16_t slot, const uint8_t size, const int64_t value) { return {slot, size, value, nullptr}; }
+			static Field Reference(const uint16_t slot, size_t &position) { return {slot, 4, 0, &position}; }
+		};
+
+		FlatBufferWriter()
+			: m_data(4, 0)  // Reference to root table
+		{
+		}
+
+		size_t WriteTable(std::initializer_list<Field> fields)
+		{
+			// Largest fields first, so that every field is naturally aligned if the first field is 8-byte aligned
+			std::vector<Field> sortedFields{fields};
+			std::stable_sort(sortedFields.begin(), sortedFields.end(), [](const Field &l, const Field &r) { return l.size > r.size; });
+
+			uint16_t numSlots = 0;
+			for (const Field &field : fields)
+			{
+				numSlots = std::max(numSlots, static_cast<uint16_t>(field.slot + 1));
+			}
+			std::vector<uint16_t> fieldOffsets(numSlots, 0);
+			uint16_t tableSize = 4;
+			for (const Field &field : sortedFields)
+			{
+				fieldOffsets[field.slot] = tableSize;
+				tableSize += field.size;
+			}
+
+			Align(2, 0);
+			const size_t vtablePos = m_data.size();
+			Put(static_cast<uint16_t>(4 + 2 * numSlots), 2);
+			Put(tableSize, 2);
+			for (const uint16_t offset : fieldOffsets)
+			{
+				Put(offset, 2);
+			}
+
+			// The table starts with the offset to its vtable, followed by the first field
+			Align(8, 4);
+			const size_t tablePos = m_data.size();
+			Put(tablePos - vtablePos, 4);
+			for (const Field &field : sortedFields)
+			{
+				if (field.reference)
+					*field.reference = m_data.size();
+				Put(field.value, field.size);
+			}
+			return tablePos;
+		}
+
+		// Writes a vector of references to tables, which need to be resolved later
+		size_t WriteReferenceVector(const size_t count, std::vector<size_t> &references)
+		{
+			Align(4, 0);
+			const size_t pos = m_data.size();
+			Put(count, 4);
+			references.clear();
+			for (size_t i = 0; i < count; i++)
+			{
+				references.push_back(m_data.size());
+				Put(0, 4);
+			}
+			return pos;
+		}
+
+		// Arrow's FieldNode and Buffer structs both consist of two 64-bit values
+		size_t WriteStructVector(const std::vector<std::array<int64_t, 2>> &structs)
+		{
+			Align(8, 4);
+			const size_t pos = m_data.size();
+			Put(structs.size(), 4);
+			for (const auto &s : structs)
+			{
+				Put(s[0], 8);
+				Put(s[1], 8);
+			}
+			return pos;
+		}
+
+		size_t WriteString(std::string_view str)
+		{
+			Align(4, 0);
+			const size_t pos = m_data.size();
+			Put(str.size(), 4);
+			m_data.insert(m_data.end(), str.begin(), str.end());
+			m_data.push_back(0);
+			return pos;
+		}
+
+		void SetReference(const size_t reference, const size_t target)
+		{
+			const uint32_t offset = static_cast<uint32_t>(target - reference);
+			for (size_t i = 0; i < 4; i++)
+			{
+				m_data[reference + i] = static_cast<uint8_t>(offset >> (i * 8));
+			}
+		}
+
+		void SetRoot(const size_t table) { SetReference(0, table); }
+
+		const std::vector<uint8_t> &Data() const noexcept { return m_data; }
+
+	private:
+		// Pads the data so that its size modulo alignment equals remainder
+		void Align(const size_t alignment, const size_t remainder)
+		{
+			while (m_data.size() % alignment != remainder)
+				m_data.push_back(0);
+		}
+
+		// Writes a little-endian value
+		void Put(const uint64_t value, const size_t size)
+		{
+			for (size_t i = 0; i < size; i++)
+			{
+				m_data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+			}
+		}
+
+		std::vector<uint8_t> m_data;
+	};
+
+	using Field = FlatBufferWriter::Field;
+
+	void PutUint32(std::ostream &f, const uint32_t value)
+	{
+		const std::array<char, 4> bytes = {static_cast<char>(value), static_cast<char>(value >> 8), static_cast<char>(value >> 16), static_cast<char>(value >> 24)};
+		f.write(bytes.data(), bytes.size());
+	}
+
+	uint8_t BitWidth(const ParameterType type) noexcept
+	{
+		return (type == ParameterType::U16LE || type == ParameterType::S16LE) ? 16 : 8;
+	}
+
+	bool IsSigned(const ParameterType type) noexcept
+	{
+		return type == ParameterType::S8 || type == ParameterType::S16LE;
+	}
+
+	// JD-990 and VST patches are converted only to fill the common columns, which is not a conversion the user asked for.
+	// The converters' lossy conversion warnings would just be noise here, so they are discarded.
+	template<typename Source>
+	void ConvertSilently(void (*convert)(const Source &, Patch800 &), const Source &source, Patch800 &p800)
+	{
+		ThreadLocalCapture capture;
+		std::streambuf *oldBuf = std::cerr.rdbuf(&capture);
+		convert(source, p800);
+		std::cerr.rdbuf(oldBuf);
+		ThreadLocalCapture::Buffer().clear();
+	}
+}
+
+ArrowPatchWriter::ArrowPatchWriter(std::ostream &outFile)
+	: m_file{outFile}
+{
+	m_columns.push_back({"format", Column::Source::Format});
+	m_columns.push_back({"index", Column::Source::Index});
+	m_columns.push_back({"name", Column::Source::Name});
+
+	const auto addColumns = [this](const std::span<const ParameterGroup> groups, const Column::Source source, std::string_view prefix, const auto *patch)
+	{
+		for (const ParameterGroup &group : groups)
+		{
+			for (const ParameterInfo &param : group.parameters)
+			{
+				if constexpr (!std::is_same_v<decltype(patch), const Patch800 *>)
+				{
+					if (!IsExtraParameter(patch, param))
+						continue;
+				}
+				Column &column = m_columns.emplace_back();
+				column.name.append(prefix).append(ParameterPath(group, param));
+				column.source = source;
+				column.type = param.type;
+				column.offset = group.offset + param.offset;
+			}
+		}
+	};
+	addColumns(ParameterGroups<Patch800>(), Column::Source::Patch800, "", static_cast<const Patch800 *>(nullptr));
+	addColumns(ParameterGroups<Patch990>(), Column::Source::Patch990, "jd990.", static_cast<const Patch990 *>(nullptr));
+	addColumns(ParameterGroups<PatchVST>(), Column::Source::PatchVST, "vst.", static_cast<const PatchVST *>(nullptr));
+
+	// Patch names are 16 characters, the other strings are not much longer
+	size_t rowSize = 0;
+	for (const Column &column : m_columns)
+	{
+		rowSize += column.IsString() ? (sizeof(int32_t) + 16) : (BitWidth(column.type) / 8u);
+	}
+	m_maxBatchRows = static_cast<uint32_t>(std::max(BATCH_SIZE_BYTES / rowSize, size_t(64)) & ~size_t(63));
+
+	for (Column &column : m_columns)
+	{
+		if (column.IsString())
+			column.stringOffsets.push_back(0);
+	}
+	WriteSchema();
+}
+
+void ArrowPatchWriter::Add(std::string_view patchIndex, const Patch800 &patch)
+{
+	AddRow("JD-800", patchIndex, ToString(patch.common.name), patch, nullptr, nullptr);
+}
+
+void ArrowPatchWriter::Add(std::string_view patchIndex, const Patch990 &patch)
+{
+	Patch800 p800;
+	ConvertSilently(ConvertPatch990To800, patch, p800);
+	AddRow("JD-990", patchIndex, ToString(patch.common.name), p800, &patch, nullptr);
+}
+
+void ArrowPatchWriter::Add(std::string_view patchIndex, const PatchVST &patch)
+{
+	Patch800 p800;
+	ConvertSilently(ConvertPatchVSTTo800, patch, p800);
+	AddRow("JD-800 VST / JD-08 / ZC1", patchIndex, ToString(patch.name), p800, nullptr, &patch);
+}
+
+bool ArrowPatchWriter::Finish()
+{
+	if (m_batchRows)
+		WriteRecordBatch();
+	// End-of-stream marker
+	PutUint32(m_file, 0xFFFFFFFF);
+	PutUint32(m_file, 0);
+	Stats::Add(Counter::BytesWritten, 8);
+	return static_cast<bool>(m_file.flush());
+}
+
+void ArrowPatchWriter::AddRow(std::string_view format, std::string_view patchIndex, std::string_view name, const Patch800 &p800, const Patch990 *p990, const PatchVST *pVST)
+{
+	const size_t validityByte = m_batchRows / 8u;
+	const uint8_t validityBit = static_cast<uint8_t>(1u << (m_batchRows % 8u));
+	for (Column &column : m_columns)
+	{
+		if (column.IsString())
+		{
+			std::string_view str = (column.source == Column::Source::Format) ? format : ((column.source == Column::Source::Index) ? patchIndex : name);
+			if (column.source == Column::Source::Name)
+				str = str.substr(0, str.find_last_not_of(' ') + 1);
+			// Utf8 columns must contain valid UTF-8, but patch names may contain arbitrary bytes
+			for (const char c : str)
+			{
+				column.data.push_back((c >= 0x20 && c < 0x7F) ? static_cast<uint8_t>(c) : uint8_t('?'));
+			}
+			column.stringOffsets.push_back(static_cast<int32_t>(column.data.size()));
+			continue;
+		}
+
+		const void *patch = &p800;
+		if (column.source == Column::Source::Patch990)
+			patch = p990;
+		else if (column.source == Column::Source::PatchVST)
+			patch = pVST;
+
+		if (column.IsNullable())
+		{
+			if (validityByte >= column.validity.size())
+				column.validity.push_back(0);
+			if (patch)
+				column.validity[validityByte] |= validityBit;
+			else
+				column.nullCount++;
+		}
+
+		const int32_t value = patch ? GetParameter(patch, column.offset, column.type) : 0;
+		column.data.push_back(static_cast<uint8_t>(value));
+		if (BitWidth(column.type) == 16)
+			column.data.push_back(static_cast<uint8_t>(value >> 8));
+	}
+
+	m_numRows++;
+	if (++m_batchRows == m_maxBatchRows)
+		WriteRecordBatch();
+}
+
+void ArrowPatchWriter::WriteSchema()
+{
+	FlatBufferWriter fb;
+	size_t headerRef = 0, fieldsRef = 0;
+	fb.SetRoot(fb.WriteTable({
+		Field::Scalar(0, 2, METADATA_VERSION_V5),
+		Field::Scalar(1, 1, MESSAGE_HEADER_SCHEMA),
+		Field::Reference(2, headerRef),
+		Field::Scalar(3, 8, 0),
+	}));
+	fb.SetReference(headerRef, fb.WriteTable({Field::Scalar(0, 2, 0), Field::Reference(1, fieldsRef)}));  // Little endian
+
+	std::vector<size_t> fieldRefs, noChildren;
+	fb.SetReference(fieldsRef, fb.WriteReferenceVector(m_columns.size(), fieldRefs));
+	for (size_t i = 0; i < m_columns.size(); i++)
+	{
+		const Column &column = m_columns[i];
+		size_t nameRef = 0, typeRef = 0, childrenRef = 0;
+		fb.SetReference(fieldRefs[i], fb.WriteTable({
+			Field::Reference(0, nameRef),
+			Field::Scalar(1, 1, column.IsNullable() ? 1 : 0),
+			Field::Scalar(2, 1, column.IsString() ? TYPE_UTF8 : TYPE_INT),
+			Field::Reference(3, typeRef),
+			Field::Reference(5, childrenRef),
+		}));
+		fb.SetReference(nameRef, fb.WriteString(column.name));
+		if (column.IsString())
+			fb.SetReference(typeRef, fb.WriteTable({}));
+		else
+			fb.SetReference(typeRef, fb.WriteTable({Field::Scalar(0, 4, BitWidth(column.type)), Field::Scalar(1, 1, IsSigned(column.type) ? 1 : 0)}));
+		// Readers expect a children vector even for primitive types
+		fb.SetReference(childrenRef, fb.WriteReferenceVector(0, noChildren));
+	}
+
+	m_body.clear();
+	WriteMessage(fb.Data());
+}
+
+void ArrowPatchWriter::WriteRecordBatch()
+{
+	StageTimer timer{Stage::Write};
+	std::vector<std::array<int64_t, 2>> nodes, buffers;
+	m_body.clear();
+	const auto addBuffer = [this, &buffers](const void *data, const size_t size)
+	{
+		buffers.push_back({static_cast<int64_t>(m_body.size()), static_cast<int64_t>(size)});
+		m_body.insert(m_body.end(), static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + size);
+		m_body.resize((m_body.size() + ALIGNMENT - 1) & ~(ALIGNMENT - 1), 0);
+	};
+
+	for (Column &column : m_columns)
+	{
+		nodes.push_back({m_batchRows, column.nullCount});
+		// Without nulls, the validity bitmap can be omitted
+		if (column.nullCount)
+			addBuffer(column.validity.data(), column.validity.size());
+		else
+			addBuffer(nullptr, 0);
+		if (column.IsString())
+			addBuffer(column.stringOffsets.data(), column.stringOffsets.size() * sizeof(int32_t));
+		addBuffer(column.data.data(), column.data.size());
+
+		column.data.clear();
+		column.validity.clear();
+		column.nullCount = 0;
+		if (column.IsString())
+			column.stringOffsets.assign(1, 0);
+	}
+
+	FlatBufferWriter fb;
+	size_t headerRef = 0, nodesRef = 0, buffersRef = 0;
+	fb.SetRoot(fb.WriteTable({
+		Field::Scalar(0, 2, METADATA_VERSION_V5),
+		Field::Scalar(1, 1, MESSAGE_HEADER_RECORD_BATCH),
+		Field::Reference(2, headerRef),
+		Field::Scalar(3, 8, static_cast<int64_t>(m_body.size())),
+	}));
+	fb.SetReference(headerRef, fb.WriteTable({Field::Scalar(0, 8, m_batchRows), Field::Reference(1, nodesRef), Field::Reference(2, buffersRef)}));
+	fb.SetReference(nodesRef, fb.WriteStructVector(nodes));
+	fb.SetReference(buffersRef, fb.WriteStructVector(buffers));
+
+	WriteMessage(fb.Data());
+	m_batchRows = 0;
+}
+
+// Encapsulated message: continuation marker, metadata size, metadata padded to 8 bytes, message body
+void ArrowPatchWriter::WriteMessage(const std::vector<uint8_t> &metadata)
+{
+	const size_t paddedSize = (metadata.size() + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	PutUint32(m_file, 0xFFFFFFFF);
+	PutUint32(m_file, static_cast<uint32_t>(paddedSize));
+	m_file.write(reinterpret_cast<const char *>(metadata.data()), metadata.size());
+	static constexpr std::array<char, ALIGNMENT> PADDING{};
+	m_file.write(PADDING.data(), paddedSize - metadata.size());
+	m_file.write(reinterpret_cast<const char *>(m_body.data()), m_body.size());
+	Stats::Add(Counter::BytesWritten, 8 + paddedSize + m_body.size());
+}
@@ -0,0 +1,69 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include "ParameterTables.hpp"
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Writes patches as rows of an Apache Arrow IPC stream, with one column per JD-800 patch and tone parameter.
+// JD-990 and JD-800 VST patches are converted to JD-800 patches first. Parameters that only exist in these formats
+// (JD-990 structure type, VST unison and tempo sync) go into additional columns, which are null for patches of other formats.
+// Rows are collected into record batches that are small enough to stay in the CPU cache while they are being built.
+class ArrowPatchWriter
+{
+public:
+	explicit ArrowPatchWriter(std::ostream &outFile);
+
+	void Add(std::string_view patchIndex, const Patch800 &patch);
+	void Add(std::string_view patchIndex, const Patch990 &patch);
+	void Add(std::string_view patchIndex, const PatchVST &patch);
+
+	// Writes all remaining rows and the end-of-stream marker. Returns false if the file could not be written.
+	bool Finish();
+
+	uint64_t NumRows() const noexcept { return m_numRows; }
+
+private:
+	struct Column
+	{
+		enum class Source : uint8_t
+		{
+			Format,
+			Index,
+			Name,
+			Patch800,
+			Patch990,
+			PatchVST,
+		};
+
+		std::string name;
+		Source source;
+		ParameterType type = ParameterType::U8;
+		uint32_t offset = 0;  // Of the parameter in the source patch
+
+		std::vector<uint8_t> data, validity;
+		std::vector<int32_t> stringOffsets;
+		uint32_t nullCount = 0;
+
+		bool IsString() const noexcept { return source == Source::Format || source == Source::Index || source == Source::Name; }
+		bool IsNullable() const noexcept { return source == Source::Patch990 || source == Source::PatchVST; }
+	};
+
+	void AddRow(std::string_view format, std::string_view patchIndex, std::string_view name, const Patch800 &p800, const Patch990 *p990, const PatchVST *pVST);
+	void WriteSchema();
+	void WriteRecordBatch();
+	void WriteMessage(const std::vector<uint8_t> &metadata);
+
+	std::ostream &m_file;
+	std::vector<Column> m_columns;
+	std::vector<uint8_t> m_body;
+	uint32_t m_batchRows = 0, m_maxBatchRows = 0;
+	uint64_t m_numRows = 0;
+};
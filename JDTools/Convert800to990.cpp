@@ -4,95 +4,35 @@
 
 #include "JD-800.hpp"
 #include "JD-990.hpp"
+#include "ParameterTables.hpp"
+#include "Stats.hpp"
 #include "Utils.hpp"
 
 #include <cstring>
 
 static void ConvertTone800To990(const uint8_t aTouchBend800, const Tone800 &t800, Tone990 &t990)
 {
-	t990.wg.waveSource = t800.wg.waveSource;
-	t990.wg.waveformMSB = t800.wg.waveformMSB;
-	t990.wg.waveformLSB = t800.wg.waveformLSB;
-	t990.wg.fxmColor = 0;         // 990 only
-	t990.wg.fxmDepth = 0;         // 990 only
-	t990.wg.syncSlaveSwitch = 0;  // 990 only
-	t990.wg.toneDelayMode = 0;    // 990 only
-	t990.wg.toneDelayTime = 0;    // 990 only
-	t990.wg.pitchCoarse = t800.wg.pitchCoarse;
-	t990.wg.pitchFine = t800.wg.pitchFine;
-	t990.wg.pitchRandom = t800.wg.pitchRandom;
-	t990.wg.keyFollow = t800.wg.keyFollow;
-	t990.wg.envDepth = 24;  // 990 only
-	t990.wg.benderSwitch = t800.wg.benderSwitch;
-
-	t990.pitchEnv.velo = t800.pitchEnv.velo;
-	t990.pitchEnv.timeVelo = t800.pitchEnv.timeVelo;
-	t990.pitchEnv.timeKF = t800.pitchEnv.timeKF;
-	t990.pitchEnv.level0 = t800.pitchEnv.level0;
-	t990.pitchEnv.time1 = t800.pitchEnv.time1;
-	t990.pitchEnv.level1 = t800.pitchEnv.level1;
-	t990.pitchEnv.time2 = t800.pitchEnv.time2;
-	t990.pitchEnv.sustainLevel = 50;  // 990 only
-	t990.pitchEnv.time3 = t800.pitchEnv.time3;
-	t990.pitchEnv.level3 = t800.pitchEnv.level2;
-
-	t990.tvf.filterMode = t800.tvf.filterMode;
-	t990.tvf.cutoffFreq = t800.tvf.cutoffFreq;
-	t990.tvf.resonance = t800.tvf.resonance;
-	t990.tvf.keyFollow = t800.tvf.keyFollow;
-	t990.tvf.envDepth = t800.tvf.envDepth;
-
-	t990.tvfEnv.velo = t800.tvfEnv.velo;
-	t990.tvfEnv.timeVelo = t800.tvfEnv.timeVelo;
-	t990.tvfEnv.timeKF = t800.tvfEnv.timeKF;
-	t990.tvfEnv.time1 = t800.tvfEnv.time1;
-	t990.tvfEnv.level1 = t800.tvfEnv.level1;
-	t990.tvfEnv.time2 = t800.tvfEnv.time2;
-	t990.tvfEnv.level2 = t800.tvfEnv.level2;
-	t990.tvfEnv.time3 = t800.tvfEnv.time3;
-	t990.tvfEnv.sustainLevel = t800.tvfEnv.sustainLevel;
-	t990.tvfEnv.time4 = t800.tvfEnv.time4;
-	t990.tvfEnv.level4 = t800.tvfEnv.level4;
-
-	t990.tva.level = t800.tva.level;
-	t990.tva.biasDirection = t800.tva.biasDirection;
-	t990.tva.biasPoint = t800.tva.biasPoint;
-	t990.tva.biasLevel = t800.tva.biasLevel;
-	t990.tva.pan = 50;          // 990 only
-	t990.tva.panKeyFollow = 7;  // 990 only
-
-	t990.tvaEnv.velo = t800.tvaEnv.velo;
-	t990.tvaEnv.timeVelo = t800.tvaEnv.timeVelo;
-	t990.tvaEnv.timeKF = t800.tvaEnv.timeKF;
-	t990.tvaEnv.time1 = t800.tvaEnv.time1;
-	t990.tvaEnv.level1 = t800.tvaEnv.level1;
-	t990.tvaEnv.time2 = t800.tvaEnv.time2;
-	t990.tvaEnv.level2 = t800.tvaEnv.level2;
-	t990.tvaEnv.time3 = t800.tvaEnv.time3;
-	t990.tvaEnv.sustainLevel = t800.tvaEnv.sustainLevel;
-	t990.tvaEnv.time4 = t800.tvaEnv.time4;
-
-	t990.common.velocityCurve = t800.common.velocityCurve;
-	t990.common.holdControl = t800.common.holdControl;
+	ApplyMapping(TONE800_TO_990, &t800, &t990);
+
+	// 990 only
+	t990.wg.fxmColor = 0;
+	t990.wg.fxmDepth = 0;
+	t990.wg.syncSlaveSwitch = 0;
+	t990.wg.toneDelayMode = 0;
+	t990.wg.toneDelayTime = 0;
+	t990.wg.envDepth = 24;
+	t990.pitchEnv.sustainLevel = 50;
+	t990.tva.pan = 50;
+	t990.tva.panKeyFollow = 7;
 
 	static constexpr uint8_t LfoWaveform800to990[] = { 0, 2, 3, 5, 6 };
 
 	t990.lfo1.waveform = SafeTable(LfoWaveform800to990, t800.lfo1.waveform);
-	t990.lfo1.rate = t800.lfo1.rate;
-	t990.lfo1.delay = t800.lfo1.delay;
-	t990.lfo1.fade = t800.lfo1.fade;
-	t990.lfo1.offset = t800.lfo1.offset;
-	t990.lfo1.keyTrigger = t800.lfo1.keyTrigger;
 	t990.lfo1.depthPitch = t800.wg.lfo1Sens;
 	t990.lfo1.depthTVF = (t800.tvf.lfoSelect == 0) ? t800.tvf.lfoDepth : 50;
 	t990.lfo1.depthTVA = (t800.tva.lfoSelect == 0) ? t800.tva.lfoDepth : 50;
 
 	t990.lfo2.waveform = SafeTable(LfoWaveform800to990, t800.lfo2.waveform);
-	t990.lfo2.rate = t800.lfo2.rate;
-	t990.lfo2.delay = t800.lfo2.delay;
-	t990.lfo2.fade = t800.lfo2.fade;
-	t990.lfo2.offset = t800.lfo2.offset;
-	t990.lfo2.keyTrigger = t800.lfo2.keyTrigger;
 	t990.lfo2.depthPitch = t800.wg.lfo2Sens;
 	t990.lfo2.depthTVF = (t800.tvf.lfoSelect == 1) ? t800.tvf.lfoDepth : 50;
 	t990.lfo2.depthTVA = (t800.tva.lfoSelect == 1) ? t800.tva.lfoDepth : 50;
@@ -133,6 +73,9 @@ static void ConvertTone800To990(const uint8_t aTouchBend800, const Tone800 &t800
 
 void ConvertPatch800To990(const Patch800 &p800, Patch990 &p990)
 {
+	StageTimer timer{Stage::Convert};
+	Stats::Add(Counter::PatchesConverted, 1);
+
 	p990.common.name = p800.common.name;
 	p990.common.patchLevel = p800.common.patchLevel;
 	p990.common.patchPan = 50;      // 990 only
@@ -261,6 +204,9 @@ void ConvertPatch800To990(const Patch800 &p800, Patch990 &p990)
 
 void ConvertSetup800To990(const SpecialSetup800 &s800, SpecialSetup990 &s990)
 {
+	StageTimer timer{Stage::Convert};
+	Stats::Add(Counter::PatchesConverted, 1);
+
 	std::memcpy(s990.common.name.data(), "JD-800 Drum Set ", s990.common.name.size());
 	s990.common.level = 80;
 	s990.common.pan = 50;
@@ -2,12 +2,16 @@
 // 2022 - 2024 by Johannes Schultz
 // License: BSD 3-clause
 
+#include "JDTools.hpp"
 #include "JD-800.hpp"
 #include "JD-08.hpp"
+#include "ParameterTables.hpp"
 #include "PrecomputedTablesVST.hpp"
+#include "Stats.hpp"
 #include "Utils.hpp"
 
 #include <iostream>
+#include <string_view>
 
 template<typename T, size_t N>
 static T SignedTable(const T (&table)[N], int8_t offset)
@@ -39,26 +43,15 @@ static void ConvertTone800ToVST(const Tone800 &t800, const bool enabled, const b
 {
 	tVST.common.layerEnabled = enabled;
 	tVST.common.layerSelected = selected;
-	tVST.common.velocityCurve = t800.common.velocityCurve;
-	tVST.common.holdControl = t800.common.holdControl;
+	ApplyMapping(TONE800_TO_VST, &t800, &tVST);
 
-	tVST.lfo1.waveform = t800.lfo1.waveform;
 	tVST.lfo1.tempoSync = 0;  // Extended feature
-	tVST.lfo1.rate = t800.lfo1.rate;
 	tVST.lfo1.rateWithTempoSync = 6;  // Extended feature
-	tVST.lfo1.delay = t800.lfo1.delay;
-	tVST.lfo1.fade = t800.lfo1.fade - 50;
 	tVST.lfo1.offset = 2 - t800.lfo1.offset;
-	tVST.lfo1.keyTrigger = t800.lfo1.keyTrigger;
 
-	tVST.lfo2.waveform = t800.lfo2.waveform;
 	tVST.lfo2.tempoSync = 0;  // Extended feature
-	tVST.lfo2.rate = t800.lfo2.rate;
 	tVST.lfo2.rateWithTempoSync = 6;  // Extended feature
-	tVST.lfo2.delay = t800.lfo2.delay;
-	tVST.lfo2.fade = t800.lfo2.fade - 50;
 	tVST.lfo2.offset = 2 - t800.lfo2.offset;
-	tVST.lfo2.keyTrigger = t800.lfo2.keyTrigger;
 
 	if (t800.wg.waveSource != 0 && tVST.common.layerEnabled)
 	{
@@ -68,21 +61,11 @@ static void ConvertTone800ToVST(const Tone800 &t800, const bool enabled, const b
 	tVST.wg.unknown1637_00 = 0;
 	tVST.wg.unknown1638_00 = 0;
 	tVST.wg.gain = 3;  // Extended feature
-	tVST.wg.pitchCoarse = t800.wg.pitchCoarse - 48;
-	tVST.wg.pitchFine= t800.wg.pitchFine - 50;
-	tVST.wg.pitchRandom = t800.wg.pitchRandom;
 	if (tVST.wg.pitchRandom > 0 && tVST.wg.pitchRandom < 20)
 	{
 		tVST.wg.pitchRandom = 20;
 		std::cerr << "LOSSY CONVERSION! Pitch Random values 1-19 do nothing, setting to 20 instead" << std::endl;
 	}
-	tVST.wg.keyFollow = t800.wg.keyFollow;
-	tVST.wg.benderSwitch = t800.wg.benderSwitch;
-	tVST.wg.aTouchBend = t800.wg.aTouchBend;
-	tVST.wg.lfo1Sens = t800.wg.lfo1Sens - 50;
-	tVST.wg.lfo2Sens = t800.wg.lfo2Sens - 50;
-	tVST.wg.leverSens = t800.wg.leverSens - 50;
-	tVST.wg.aTouchModSens = t800.wg.aTouchModSens - 50;
 
 	// Why, Roland, why
 	if (tVST.wg.waveformLSB == 88)
@@ -116,59 +99,15 @@ static void ConvertTone800ToVST(const Tone800 &t800, const bool enabled, const b
 			std::cerr << "LOSSY CONVERSION! Tone coarse pitch too high (maybe due to waveform transposition)" << std::endl;
 	}
 
-	tVST.pitchEnv.velo = t800.pitchEnv.velo - 50;
-	tVST.pitchEnv.timeVelo = t800.pitchEnv.timeVelo - 50;
-	tVST.pitchEnv.timeKF = t800.pitchEnv.timeKF - 10;
 	tVST.pitchEnv.level0 = ConvertPitchEnvLevel(t800.pitchEnv.level0);
 	tVST.pitchEnv.level1 = ConvertPitchEnvLevel(t800.pitchEnv.level1);
 	tVST.pitchEnv.level2 = ConvertPitchEnvLevel(t800.pitchEnv.level2);
-	tVST.pitchEnv.time1 = t800.pitchEnv.time1;
-	tVST.pitchEnv.time2 = t800.pitchEnv.time2;
-	tVST.pitchEnv.time3 = t800.pitchEnv.time3;
 	if (t800.pitchEnv.level0 < 4 || t800.pitchEnv.level1 < 4 || t800.pitchEnv.level2 < 4)
 	{
 		std::cerr << "LOSSY CONVERSION! Pitch envelope cannot go lower than one octave" << std::endl;
 	}
 
 	tVST.tvf.filterMode = 2 - t800.tvf.filterMode;
-	tVST.tvf.cutoffFreq = t800.tvf.cutoffFreq;
-	tVST.tvf.resonance = t800.tvf.resonance;
-	tVST.tvf.keyFollow = t800.tvf.keyFollow;
-	tVST.tvf.aTouchSens = t800.tvf.aTouchSens - 50;
-	tVST.tvf.lfoSelect = t800.tvf.lfoSelect;
-	tVST.tvf.lfoDepth = t800.tvf.lfoDepth - 50;
-	tVST.tvf.envDepth = t800.tvf.envDepth - 50;
-
-	tVST.tvfEnv.velo = t800.tvfEnv.velo - 50;
-	tVST.tvfEnv.timeVelo = t800.tvfEnv.timeVelo - 50;
-	tVST.tvfEnv.timeKF = t800.tvfEnv.timeKF - 10;
-	tVST.tvfEnv.level1 = t800.tvfEnv.level1;
-	tVST.tvfEnv.level2 = t800.tvfEnv.level2;
-	tVST.tvfEnv.sustainLevel = t800.tvfEnv.sustainLevel;
-	tVST.tvfEnv.level4 = t800.tvfEnv.level4;
-	tVST.tvfEnv.time1 = t800.tvfEnv.time1;
-	tVST.tvfEnv.time2 = t800.tvfEnv.time2;
-	tVST.tvfEnv.time3 = t800.tvfEnv.time3;
-	tVST.tvfEnv.time4 = t800.tvfEnv.time4;
-
-	tVST.tva.biasDirection = t800.tva.biasDirection;
-	tVST.tva.biasPoint = t800.tva.biasPoint;
-	tVST.tva.biasLevel = t800.tva.biasLevel - 10;
-	tVST.tva.level = t800.tva.level;
-	tVST.tva.aTouchSens = t800.tva.aTouchSens - 50;
-	tVST.tva.lfoSelect = t800.tva.lfoSelect;
-	tVST.tva.lfoDepth = t800.tva.lfoDepth - 50;
-
-	tVST.tvaEnv.velo = t800.tvaEnv.velo - 50;
-	tVST.tvaEnv.timeVelo = t800.tvaEnv.timeVelo - 50;
-	tVST.tvaEnv.timeKF = t800.tvaEnv.timeKF - 10;
-	tVST.tvaEnv.level1 = t800.tvaEnv.level1;
-	tVST.tvaEnv.level2 = t800.tvaEnv.level2;
-	tVST.tvaEnv.sustainLevel = t800.tvaEnv.sustainLevel;
-	tVST.tvaEnv.time1 = t800.tvaEnv.time1;
-	tVST.tvaEnv.time2 = t800.tvaEnv.time2;
-	tVST.tvaEnv.time3 = t800.tvaEnv.time3;
-	tVST.tvaEnv.time4 = t800.tvaEnv.time4;
 
 	tVST.padding = 0;
 }
@@ -335,8 +274,27 @@ static void FillPrecomputedToneVST(const ToneVST &tVST, const PatchVST &pVST, To
 	eq.eqEnabled = pVST.eq.eqEnabled;
 }
 
+void ConvertPatchTone800ToVST(const Tone800 &t800, const bool enabled, const bool selected, const uint8_t tone, PatchVST &pVST)
+{
+	ConvertTone800ToVST(t800, enabled, selected, pVST.tone[tone]);
+
+	// Reset everything that FillPrecomputedToneVST may leave untouched, to get the same result as a full conversion
+	ToneVSTPrecomputed &tpVST = pVST.tonesPrecomputed;
+	tpVST.layer[tone] = {};
+	tpVST.common[tone] = {};
+	tpVST.pitchEnv[tone] = {};
+	tpVST.tvfEnv[tone] = {};
+	tpVST.tvaEnv[tone] = {};
+	tpVST.lfo[tone] = {};
+	tpVST.eq[tone] = {};
+	FillPrecomputedToneVST(pVST.tone[tone], pVST, tpVST, tone);
+}
+
 void ConvertPatch800ToVST(const Patch800 &p800, PatchVST &pVST)
 {
+	StageTimer timer{Stage::Convert};
+	Stats::Add(Counter::PatchesConverted, 1);
+
 	pVST.zenHeader = PatchVST::DEFAULT_ZEN_HEADER;
 	pVST.name = p800.common.name;
 
@@ -348,7 +306,7 @@ void ConvertPatch800ToVST(const Patch800 &p800, PatchVST &pVST)
 
 	static constexpr uint8_t DistortionPos[] = { 0, 0, 0, 0, 0, 0, 1, 1, 3, 2, 2, 3, 2, 3, 1, 1, 3, 2, 3, 2, 2, 3, 1, 1 };
 	static constexpr uint8_t PhaserPos[] = { 1, 1, 3, 2, 2, 3, 0, 0, 0, 0, 0, 0, 1, 1, 3, 2, 2, 3, 1, 1, 3, 2, 2, 3 };
-	static constexpr uint8_t SpectrumPos[] = { 2, 3, 1, 1, 3, 2, 2, 3, 21, 1, 3, 2, 0, 0, 0, 0, 0, 0, 2, 3, 1, 1, 3, 2 };
+	static constexpr uint8_t SpectrumPos[] = { 2, 3, 1, 1, 3, 2, 2, 3, 1, 1, 3, 2, 0, 0, 0, 0, 0, 0, 2, 3, 1, 1, 3, 2 };
 	static constexpr uint8_t EnhancerPos[] = { 3, 2, 2, 3, 1, 1, 3, 2, 2, 3, 1, 1, 3, 2, 2, 3, 1, 1, 0, 0, 0, 0, 0, 0 };
 	const uint8_t BlockEnabledA[] = { p800.effect.groupAblockSwitch1, p800.effect.groupAblockSwitch2, p800.effect.groupAblockSwitch3, p800.effect.groupAblockSwitch4 };
 
@@ -452,8 +410,12 @@ void ConvertPatch800ToVST(const Patch800 &p800, PatchVST &pVST)
 	pVST.eq.eqEnabled = 1;
 	
 	pVST.unison = 0;  // Extended feature
-	pVST.empty.fill(0);
 
+	UpdatePrecomputedVST(pVST);
+}
+
+void UpdatePrecomputedVST(PatchVST &pVST)
+{
 	// Copy stuff to precomputed area
 	pVST.commonPrecomputed = {};  // Lots of zeros to clear
 	pVST.commonPrecomputed.patchCommonLevel = pVST.common.patchLevel;
@@ -486,9 +448,11 @@ void ConvertPatch800ToVST(const Patch800 &p800, PatchVST &pVST)
 	};
 }
 
-std::vector<PatchVST> ConvertSetup800ToVST(const SpecialSetup800 &s800)
+std::pmr::vector<PatchVST> ConvertSetup800ToVST(const SpecialSetup800 &s800, std::pmr::memory_resource *memory)
 {
-	std::vector<PatchVST> patches(64);
+	// Counted as one converted patch by the conversion of the template patch below
+	StageTimer timer{Stage::Convert};
+	std::pmr::vector<PatchVST> patches(64, memory);
 
 	Patch800 p800{};
 	p800.common.patchLevel = 100;
@@ -528,23 +492,29 @@ std::vector<PatchVST> ConvertSetup800ToVST(const SpecialSetup800 &s800)
 	p800.midiTx.holdMode = 2;
 	p800.midiTx.dummy = 0;
 
+	// All keys share everything but the name and the first tone, so convert the patch-level parameters only once
+	PatchVST templatePatch{};
+	p800.common.name.fill(' ');
+	ConvertPatch800ToVST(p800, templatePatch);
+
 	static constexpr std::array<const char *, 12> KeyNames = {"C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"};
+	static constexpr std::string_view DrumKeyPrefix = "Drum Key ";
 
-	for (uint8_t key = 0; key < 61; key++)
+	for (uint8_t key = 0; key < 64; key++)
 	{
-		std::string name = "Drum Key " + (KeyNames[key % 12u] + std::string(1, '2' + key / 12));
-		name.resize(p800.common.name.size(), ' ');
-		std::copy(name.begin(), name.end(), p800.common.name.begin());
-
-		p800.toneA = s800.keys[key].tone;
-
-		ConvertPatch800ToVST(p800, patches[key]);
+		patches[key] = templatePatch;
 	}
-	p800.common.name.fill(' ');
-	p800.toneA = {};
-	for (uint8_t key = 61; key < 64; key++)
+	for (uint8_t key = 0; key < 61; key++)
 	{
-		ConvertPatch800ToVST(p800, patches[key]);
+		PatchVST &pVST = patches[key];
+		auto name = std::copy(DrumKeyPrefix.begin(), DrumKeyPrefix.end(), pVST.name.begin());
+		for (const char *keyName = KeyNames[key % 12u]; *keyName; keyName++)
+		{
+			*name++ = *keyName;
+		}
+		*name = static_cast<char>('2' + key / 12);
+
+		ConvertPatchTone800ToVST(s800.keys[key].tone, p800.common.layerTone & 1, p800.common.activeTone & 1, 0, pVST);
 	}
 	return patches;
 }
@@ -4,6 +4,8 @@
 
 #include "JD-800.hpp"
 #include "JD-990.hpp"
+#include "ParameterTables.hpp"
+#include "Stats.hpp"
 #include "Utils.hpp"
 
 #include <algorithm>
@@ -82,43 +84,24 @@ static void ConvertToneControl(const uint8_t source, const uint8_t dest, uint8_t
 
 static void ConvertTone990To800(const uint8_t toneControlSource1, const uint8_t toneControlSource2, const Tone990 &t990, uint8_t &aTouchBend800, Tone800 &t800, const bool isSetupConversion)
 {
-	t800.common.velocityCurve = t990.common.velocityCurve;
-	t800.common.holdControl = t990.common.holdControl;
+	ApplyMappingReverse(TONE800_TO_990, &t990, &t800);
 
 	static constexpr uint8_t LfoWaveform990to800[] = { 0, 0 | 0x80, 1, 2, 2 | 0x80, 3, 4, 4 | 0x80 };
 
-	t800.lfo1.rate = t990.lfo1.rate;
-	t800.lfo1.delay = t990.lfo1.delay;
-	t800.lfo1.fade = t990.lfo1.fade;
 	t800.lfo1.waveform = SafeTable(LfoWaveform990to800, t990.lfo1.waveform);
-	t800.lfo1.offset = t990.lfo1.offset;
-	t800.lfo1.keyTrigger = t990.lfo1.keyTrigger;
 	if (t800.lfo1.waveform & 0x80)
 	{
 		t800.lfo1.waveform &= 0x7F;
 		std::cerr << "LOSSY CONVERSION! JD-990 tone LFO1 has unsupported LFO waveform: " << int(t990.lfo1.waveform) << std::endl;
 	}
 
-	t800.lfo2.rate = t990.lfo2.rate;
-	t800.lfo2.delay = t990.lfo2.delay;
-	t800.lfo2.fade = t990.lfo2.fade;
 	t800.lfo2.waveform = SafeTable(LfoWaveform990to800, t990.lfo2.waveform);
-	t800.lfo2.offset = t990.lfo2.offset;
-	t800.lfo2.keyTrigger = t990.lfo2.keyTrigger;
 	if (t800.lfo2.waveform & 0x80)
 	{
 		t800.lfo2.waveform &= 0x7F;
 		std::cerr << "LOSSY CONVERSION! JD-990 tone LFO2 has unsupported LFO waveform: " << int(t990.lfo2.waveform) << std::endl;
 	}
 
-	t800.wg.waveSource = t990.wg.waveSource;
-	t800.wg.waveformMSB = t990.wg.waveformMSB;
-	t800.wg.waveformLSB = t990.wg.waveformLSB;
-	t800.wg.pitchCoarse = t990.wg.pitchCoarse;
-	t800.wg.pitchFine = t990.wg.pitchFine;
-	t800.wg.pitchRandom = t990.wg.pitchRandom;
-	t800.wg.keyFollow = t990.wg.keyFollow;
-	t800.wg.benderSwitch = t990.wg.benderSwitch;
 	t800.wg.aTouchBend = 0;  // Will be populated by tone control conversion
 	t800.wg.lfo1Sens = t990.lfo1.depthPitch;
 	t800.wg.lfo2Sens = t990.lfo2.depthPitch;
@@ -157,23 +140,9 @@ static void ConvertTone990To800(const uint8_t toneControlSource1, const uint8_t
 		std::cerr << "LOSSY CONVERSION! JD-990 tone has tone delay enabled!" << std::endl;
 	if (t990.wg.envDepth != 24 && (t990.pitchEnv.level0 != 50 || t990.pitchEnv.level1 != 50 || t990.pitchEnv.sustainLevel != 50 || t990.pitchEnv.level3 != 50))
 		std::cerr << "LOSSY CONVERSION! JD-990 tone has pitch envelope depth level != 24: " << int(t990.wg.envDepth) << std::endl;
-
-	t800.pitchEnv.velo = t990.pitchEnv.velo;
-	t800.pitchEnv.timeVelo = t990.pitchEnv.timeVelo;
-	t800.pitchEnv.timeKF = t990.pitchEnv.timeKF;
-	t800.pitchEnv.level0 = t990.pitchEnv.level0;
-	t800.pitchEnv.time1 = t990.pitchEnv.time1;
-	t800.pitchEnv.level1 = t990.pitchEnv.level1;
-	t800.pitchEnv.time2 = t990.pitchEnv.time2;
-	t800.pitchEnv.time3 = t990.pitchEnv.time3;
-	t800.pitchEnv.level2 = t990.pitchEnv.level3;
 	if (t990.pitchEnv.sustainLevel != 50)
 		std::cerr << "LOSSY CONVERSION! JD-990 tone has pitch envelope sustain level != 50: " << int(t990.pitchEnv.sustainLevel) << std::endl;
 
-	t800.tvf.filterMode = t990.tvf.filterMode;
-	t800.tvf.cutoffFreq = t990.tvf.cutoffFreq;
-	t800.tvf.resonance = t990.tvf.resonance;
-	t800.tvf.keyFollow = t990.tvf.keyFollow;
 	t800.tvf.aTouchSens = 0;  // Will be populated by tone control conversion
 	if (t990.lfo2.depthTVF != 50)
 	{
@@ -187,24 +156,7 @@ static void ConvertTone990To800(const uint8_t toneControlSource1, const uint8_t
 		t800.tvf.lfoSelect = 0;
 		t800.tvf.lfoDepth = t990.lfo1.depthTVF;
 	}
-	t800.tvf.envDepth = t990.tvf.envDepth;
-
-	t800.tvfEnv.velo = t990.tvfEnv.velo;
-	t800.tvfEnv.timeVelo = t990.tvfEnv.timeVelo;
-	t800.tvfEnv.timeKF = t990.tvfEnv.timeKF;
-	t800.tvfEnv.time1 = t990.tvfEnv.time1;
-	t800.tvfEnv.level1 = t990.tvfEnv.level1;
-	t800.tvfEnv.time2 = t990.tvfEnv.time2;
-	t800.tvfEnv.level2 = t990.tvfEnv.level2;
-	t800.tvfEnv.time3 = t990.tvfEnv.time3;
-	t800.tvfEnv.sustainLevel = t990.tvfEnv.sustainLevel;
-	t800.tvfEnv.time4 = t990.tvfEnv.time4;
-	t800.tvfEnv.level4 = t990.tvfEnv.level4;
-
-	t800.tva.biasDirection = t990.tva.biasDirection;
-	t800.tva.biasPoint = t990.tva.biasPoint;
-	t800.tva.biasLevel = t990.tva.biasLevel;
-	t800.tva.level = t990.tva.level;
+
 	t800.tva.aTouchSens = 0;  // Will be populated by tone control conversion
 	if (t990.lfo2.depthTVA != 50)
 	{
@@ -227,17 +179,6 @@ static void ConvertTone990To800(const uint8_t toneControlSource1, const uint8_t
 		std::cerr << "LOSSY CONVERSION! JD-990 tone uses pan key follow: " << int(t990.tva.panKeyFollow) << std::endl;
 	}
 
-	t800.tvaEnv.velo = t990.tvaEnv.velo;
-	t800.tvaEnv.timeVelo = t990.tvaEnv.timeVelo;
-	t800.tvaEnv.timeKF = t990.tvaEnv.timeKF;
-	t800.tvaEnv.time1 = t990.tvaEnv.time1;
-	t800.tvaEnv.level1 = t990.tvaEnv.level1;
-	t800.tvaEnv.time2 = t990.tvaEnv.time2;
-	t800.tvaEnv.level2 = t990.tvaEnv.level2;
-	t800.tvaEnv.time3 = t990.tvaEnv.time3;
-	t800.tvaEnv.sustainLevel = t990.tvaEnv.sustainLevel;
-	t800.tvaEnv.time4 = t990.tvaEnv.time4;
-
 	if (toneControlSource1 > 1)
 	{
 		std::cerr << "LOSSY CONVERSION! JD-990 patch uses tone control source 1 other than mod wheel or aftertouch: " << int(toneControlSource1) << std::endl;
@@ -277,6 +218,9 @@ static void FixupStructure990To800(const uint8_t structureType, Tone800 &tone1,
 
 void ConvertPatch990To800(const Patch990 &p990, Patch800 &p800)
 {
+	StageTimer timer{Stage::Convert};
+	Stats::Add(Counter::PatchesConverted, 1);
+
 	if (p990.structureType.structureAB != 0 && (p990.common.activeTone & (1 | 2)) != 0)
 		std::cerr << "LOSSY CONVERSION! JD-990 patch tones AB have unsupported structure type: " << int(p990.structureType.structureAB) << std::endl;
 	if (p990.structureType.structureCD != 0 && (p990.common.activeTone & (4 | 8)) != 0)
@@ -415,6 +359,9 @@ void ConvertPatch990To800(const Patch990 &p990, Patch800 &p800)
 
 void ConvertSetup990To800(const SpecialSetup990 &s990, SpecialSetup800 &s800)
 {
+	StageTimer timer{Stage::Convert};
+	Stats::Add(Counter::PatchesConverted, 1);
+
 	std::cerr << "(Setup name and effect settings cannot be converted)" << std::endl;
 
 	s800.eq.lowFreq = s990.eq.lowFreq;
@@ -4,7 +4,9 @@
 
 #include "JD-800.hpp"
 #include "JD-08.hpp"
+#include "ParameterTables.hpp"
 #include "PrecomputedTablesVST.hpp"
+#include "Stats.hpp"
 
 #include <algorithm>
 #include <cmath>
@@ -136,40 +138,21 @@ static void ConvertToneVSTTo800(const ToneVST &tVST, Tone800 &t800)
 	if (tVST.wg.gain != 3 && tVST.common.layerEnabled)
 		std::cerr << "LOSSY CONVERSION! Tone uses gain != 0 dB: " << ((static_cast<int>(tVST.wg.gain) - 3) * 6) << " dB" << std::endl;
 
-	t800.common.velocityCurve = tVST.common.velocityCurve;
-	t800.common.holdControl = tVST.common.holdControl;
+	ApplyMappingReverse(TONE800_TO_VST, &tVST, &t800);
 
 	if (tVST.lfo1.tempoSync && tVST.common.layerEnabled)
 		std::cerr << "LOSSY CONVERSION! Tone LFO1 uses tempo sync, approximating LFO rate @ 120 BPM" << std::endl;
 	t800.lfo1.rate = tVST.lfo1.tempoSync ? ApproximateLFORateWithTempoSync(tVST.lfo1.rateWithTempoSync) : tVST.lfo1.rate;
-	t800.lfo1.delay = tVST.lfo1.delay;
-	t800.lfo1.fade = tVST.lfo1.fade + 50;
-	t800.lfo1.waveform = tVST.lfo1.waveform;
 	t800.lfo1.offset = (2 - tVST.lfo1.offset) % 3;
-	t800.lfo1.keyTrigger = tVST.lfo1.keyTrigger;
 
 	if (tVST.lfo2.tempoSync && tVST.common.layerEnabled)
 		std::cerr << "LOSSY CONVERSION! Tone LFO2 uses tempo sync, approximating LFO rate @ 120 BPM" << std::endl;
 	t800.lfo2.rate = tVST.lfo2.tempoSync ? ApproximateLFORateWithTempoSync(tVST.lfo2.rateWithTempoSync) : tVST.lfo2.rate;
-	t800.lfo2.delay = tVST.lfo2.delay;
-	t800.lfo2.fade = tVST.lfo2.fade + 50;
-	t800.lfo2.waveform = tVST.lfo2.waveform;
 	t800.lfo2.offset = (2 - tVST.lfo2.offset) % 3;
-	t800.lfo2.keyTrigger = tVST.lfo2.keyTrigger;
 
 	t800.wg.waveSource = 0;
 	t800.wg.waveformMSB = 0;
 	t800.wg.waveformLSB = (tVST.wg.waveformLSB - 1) & 0x7F;
-	t800.wg.pitchCoarse = tVST.wg.pitchCoarse + 48;
-	t800.wg.pitchFine = tVST.wg.pitchFine + 50;
-	t800.wg.pitchRandom = tVST.wg.pitchRandom;
-	t800.wg.keyFollow = tVST.wg.keyFollow;
-	t800.wg.benderSwitch = tVST.wg.benderSwitch;
-	t800.wg.aTouchBend = tVST.wg.aTouchBend;
-	t800.wg.lfo1Sens = tVST.wg.lfo1Sens + 50;
-	t800.wg.lfo2Sens = tVST.wg.lfo2Sens + 50;
-	t800.wg.leverSens = tVST.wg.leverSens + 50;
-	t800.wg.aTouchModSens = tVST.wg.aTouchModSens + 50;
 
 	// Why, Roland, why
 	if (tVST.wg.waveformLSB == 88)
@@ -203,59 +186,18 @@ static void ConvertToneVSTTo800(const ToneVST &tVST, Tone800 &t800)
 			std::cerr << "LOSSY CONVERSION! Tone coarse pitch too high (maybe due to waveform transposition)" << std::endl;
 	}
 
-	t800.pitchEnv.velo = tVST.pitchEnv.velo + 50;
-	t800.pitchEnv.timeVelo = tVST.pitchEnv.timeVelo + 50;
-	t800.pitchEnv.timeKF = tVST.pitchEnv.timeKF + 10;
 	t800.pitchEnv.level0 = ConvertPitchEnvLevel(tVST.pitchEnv.level0);
-	t800.pitchEnv.time1 = tVST.pitchEnv.time1;
 	t800.pitchEnv.level1 = ConvertPitchEnvLevel(tVST.pitchEnv.level1);
-	t800.pitchEnv.time2 = tVST.pitchEnv.time2;
-	t800.pitchEnv.time3 = tVST.pitchEnv.time3;
 	t800.pitchEnv.level2 = ConvertPitchEnvLevel(tVST.pitchEnv.level2);
 
 	t800.tvf.filterMode = 2 - tVST.tvf.filterMode;
-	t800.tvf.cutoffFreq = tVST.tvf.cutoffFreq;
-	t800.tvf.resonance = tVST.tvf.resonance;
-	t800.tvf.keyFollow = tVST.tvf.keyFollow;
-	t800.tvf.aTouchSens = tVST.tvf.aTouchSens + 50;
-	t800.tvf.lfoSelect = tVST.tvf.lfoSelect;
-	t800.tvf.lfoDepth = tVST.tvf.lfoDepth + 50;
-	t800.tvf.envDepth = tVST.tvf.envDepth + 50;
-
-	t800.tvfEnv.velo = tVST.tvfEnv.velo + 50;
-	t800.tvfEnv.timeVelo = tVST.tvfEnv.timeVelo + 50;
-	t800.tvfEnv.timeKF = tVST.tvfEnv.timeKF + 10;
-	t800.tvfEnv.time1 = tVST.tvfEnv.time1;
-	t800.tvfEnv.level1 = tVST.tvfEnv.level1;
-	t800.tvfEnv.time2 = tVST.tvfEnv.time2;
-	t800.tvfEnv.level2 = tVST.tvfEnv.level2;
-	t800.tvfEnv.time3 = tVST.tvfEnv.time3;
-	t800.tvfEnv.sustainLevel = tVST.tvfEnv.sustainLevel;
-	t800.tvfEnv.time4 = tVST.tvfEnv.time4;
-	t800.tvfEnv.level4 = tVST.tvfEnv.level4;
-
-	t800.tva.biasDirection = tVST.tva.biasDirection;
-	t800.tva.biasPoint = tVST.tva.biasPoint;
-	t800.tva.biasLevel = tVST.tva.biasLevel + 10;
-	t800.tva.level = tVST.tva.level;
-	t800.tva.aTouchSens = tVST.tva.aTouchSens + 50;
-	t800.tva.lfoSelect = tVST.tva.lfoSelect;
-	t800.tva.lfoDepth = tVST.tva.lfoDepth + 50;
-
-	t800.tvaEnv.velo = tVST.tvaEnv.velo + 50;
-	t800.tvaEnv.timeVelo = tVST.tvaEnv.timeVelo + 50;
-	t800.tvaEnv.timeKF = tVST.tvaEnv.timeKF + 10;
-	t800.tvaEnv.time1 = tVST.tvaEnv.time1;
-	t800.tvaEnv.level1 = tVST.tvaEnv.level1;
-	t800.tvaEnv.time2 = tVST.tvaEnv.time2;
-	t800.tvaEnv.level2 = tVST.tvaEnv.level2;
-	t800.tvaEnv.time3 = tVST.tvaEnv.time3;
-	t800.tvaEnv.sustainLevel = tVST.tvaEnv.sustainLevel;
-	t800.tvaEnv.time4 = tVST.tvaEnv.time4;
 }
 
 void ConvertPatchVSTTo800(const PatchVST &pVST, Patch800 &p800)
 {
+	StageTimer timer{Stage::Convert};
+	Stats::Add(Counter::PatchesConverted, 1);
+
 	if (pVST.zenHeader.modelID1 != 3 || pVST.zenHeader.modelID2 != 5)
 	{
 		std::cerr << "Skipping patch, appears to be for another synth model!" << std::endl;
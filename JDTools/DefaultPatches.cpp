@@ -0,0 +1,71 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "DefaultPatches.hpp"
+#include "JDTools.hpp"
+
+#include "JD-800.hpp"
+#include "JD-990.hpp"
+#include "JD-08.hpp"
+
+#include <array>
+#include <cstdint>
+
+namespace
+{
+	constexpr std::array<uint8_t, sizeof(Patch800)> DEFAULT_PATCH_800 =
+	{
+		0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+		0x64, 0x00, 0x7F, 0x00, 0x7F, 0x00, 0x7F, 0x00, 0x7F, 0x02, 0x02, 0x1A, 0x00, 0x00, 0x00, 0x00,
+		0x32, 0x01, 0x01, 0x01, 0x0F, 0x07, 0x00, 0x0F, 0x00, 0x0F, 0x01, 0x24, 0x01, 0x00, 0x40, 0x00,
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x03, 0x32, 0x46, 0x1C,
+		0x13, 0x1E, 0x32, 0x64, 0x05, 0x19, 0x05, 0x19, 0x05, 0x19, 0x02, 0x32, 0x32, 0x6E, 0x32, 0x5F,
+		0x32, 0x69, 0x32, 0x4A, 0x02, 0x3C, 0x4F, 0x4A, 0x64, 0x02, 0x1E, 0x32, 0x0C, 0x18, 0x46, 0x00,
+		0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01, 0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00,
+		0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32, 0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32,
+		0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E, 0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00,
+		0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00, 0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32,
+		0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01,
+		0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32,
+		0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E,
+		0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00,
+		0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32,
+		0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01, 0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00,
+		0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32, 0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32,
+		0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E, 0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00,
+		0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00, 0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32,
+		0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01,
+		0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32,
+		0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E,
+		0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00,
+		0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32,
+	};
+}
+
+const Patch800 &DefaultPatch800() noexcept
+{
+	return reinterpret_cast<const Patch800 &>(DEFAULT_PATCH_800);
+}
+
+const Patch990 &DefaultPatch990()
+{
+	static const Patch990 p990 = []()
+	{
+		Patch990 patch{};
+		ConvertPatch800To990(DefaultPatch800(), patch);
+		return patch;
+	}();
+	return p990;
+}
+
+const PatchVST &DefaultPatchVST()
+{
+	static const PatchVST pVST = []()
+	{
+		PatchVST patch{};
+		ConvertPatch800ToVST(DefaultPatch800(), patch);
+		return patch;
+	}();
+	return pVST;
+}
@@ -0,0 +1,15 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+struct Patch800;
+struct Patch990;
+struct PatchVST;
+
+// Initial patch as found on a factory-reset JD-800, and its conversions to the other formats.
+// The converted patches are built on first use and shared afterwards, so that unused bank slots can simply be copied from them.
+const Patch800 &DefaultPatch800() noexcept;
+const Patch990 &DefaultPatch990();
+const PatchVST &DefaultPatchVST();
@@ -0,0 +1,391 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Delta.hpp"
+#include "InputFile.hpp"
+#include "JD-08.hpp"
+#include "SVZ.hpp"
+#include "Stats.hpp"
+#include "Utils.hpp"
+
+#include "miniz.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	enum class DeltaMode : uint8_t
+	{
+		FileBytes = 0,      // Slots are blocks of the file itself (SYX, MID, SVD, ZC1 SVZ)
+		PluginPatches = 1,  // Slots are the decompressed patches of a JD-800 VST BIN file
+	};
+
+	struct DeltaHeader
+	{
+		static constexpr std::array<char, 4> MAGIC{ 'J', 'D', 'D', 'a' };
+
+		std::array<char, 4> magic = MAGIC;
+		uint8_t version = 1;
+		DeltaMode mode = DeltaMode::FileBytes;
+		std::array<uint8_t, 2> reserved{};
+		uint32le slotSize;
+		uint32le baseSize;    // Size of the complete base file
+		uint32le baseCRC;     // CRC32 of the complete base file
+		uint32le resultSize;  // Size of the result, for BIN files the size of the decompressed, padded patch data
+		uint32le resultCRC;   // CRC32 of the result, for BIN files of the decompressed, padded patch data
+		uint32le numSlots;    // Number of changed slots following the header
+
+		bool IsValid() const noexcept
+		{
+			static_assert(sizeof(DeltaHeader) == 32);
+			return magic == MAGIC && version == 1 && (mode == DeltaMode::FileBytes || mode == DeltaMode::PluginPatches)
+				&& slotSize > 0 && slotSize <= 65535;
+		}
+	};
+
+	// Followed by numRanges ranges
+	struct DeltaSlotHeader
+	{
+		uint32le slot;
+		uint32le numRanges;
+	};
+
+	// Followed by the new contents of the range
+	struct DeltaRangeHeader
+	{
+		uint16le offset;  // Relative to the start of the slot
+		uint16le size;
+	};
+
+	// The size of a JD-08 / ZC1 patch
+	constexpr uint32_t FILE_SLOT_SIZE = 2048;
+	// The size of a patch in the decompressed data of a BIN file. Only the first sizeof(PatchVST) bytes are used, the rest is zero padding.
+	// This keeps the package format independent of the in-memory layout of PatchVST.
+	constexpr uint32_t PLUGIN_SLOT_SIZE = static_cast<uint32_t>(PatchVST::FILE_SIZE);
+	static_assert(sizeof(PatchVST) <= PLUGIN_SLOT_SIZE);
+
+	uint32_t CRC32(std::span<const uint8_t> data)
+	{
+		StageTimer timer{Stage::Checksum};
+		return static_cast<uint32_t>(mz_crc32(MZ_CRC32_INIT, data.data(), data.size()));
+	}
+
+	template<typename T>
+	void Append(std::vector<uint8_t> &buffer, const T &value)
+	{
+		static_assert(alignof(T) == 1);
+		const auto *bytes = reinterpret_cast<const uint8_t *>(&value);
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	bool ReadFile(const std::string &filename, std::vector<uint8_t> &data)
+	{
+		std::ifstream f{filename, std::ios::binary};
+		if (!f)
+			return false;
+		f.seekg(0, std::ios::end);
+		const auto size = static_cast<size_t>(f.tellg());
+		f.seekg(0);
+		return ReadVector(f, data, size) || size == 0;
+	}
+
+	// Reads a file completely, and determines on which data the delta is computed: the file itself, or the decompressed patches of a BIN file
+	int LoadFile(const std::string &filename, std::vector<uint8_t> &fileData, InputFile::Type &type, std::vector<uint8_t> &slotData)
+	{
+		if (!ReadFile(filename, fileData))
+		{
+			std::cout << "Could not open " << filename << " for reading!" << std::endl;
+			return 2;
+		}
+
+		std::ifstream inFile{filename, std::ios::binary};
+		InputFile inputFile{inFile};
+		type = inputFile.GetType();
+		if (type != InputFile::Type::SVZplugin)
+		{
+			slotData = fileData;
+			return 0;
+		}
+
+		const auto patches = ReadSVZ(inFile);
+		if (patches.empty())
+			return 2;
+		slotData.assign(patches.size() * size_t(PLUGIN_SLOT_SIZE), 0);
+		for (size_t i = 0; i < patches.size(); i++)
+		{
+			std::memcpy(slotData.data() + i * PLUGIN_SLOT_SIZE, &patches[i], sizeof(PatchVST));
+		}
+		return 0;
+	}
+
+	// Finds a name for a temporary file next to the target that does not clash with any existing file, e.g. "bank.svd.tmp" or "bank.svd.2.tmp"
+	bool FindTemporaryFilename(const std::filesystem::path &target, std::filesystem::path &tempFile)
+	{
+		for (int attempt = 1; attempt <= 100; attempt++)
+		{
+			tempFile = target;
+			if (attempt > 1)
+			{
+				tempFile += ".";
+				tempFile += std::to_string(attempt);
+			}
+			tempFile += ".tmp";
+			std::error_code ec;
+			if (!std::filesystem::exists(tempFile, ec) && !ec)
+				return true;
+		}
+		return false;
+	}
+
+	// Writes the result to a temporary file next to the target first, which then replaces the target.
+	// If anything goes wrong, the target is left untouched.
+	template<typename Func>
+	int WriteResultFile(const std::string &filename, const Func &writeFunc)
+	{
+		const std::filesystem::path target{filename};
+		std::filesystem::path tempFile;
+		if (!FindTemporaryFilename(target, tempFile))
+		{
+			std::cout << "Could not find a name for a temporary file next to " << filename << "!" << std::endl;
+			return 2;
+		}
+
+		std::error_code ec;
+		{
+			std::ofstream outFile{tempFile, std::ios::trunc | std::ios::binary};
+			if (!outFile)
+			{
+				std::cout << "Could not open " << tempFile.string() << " for writing!" << std::endl;
+				return 2;
+			}
+			writeFunc(outFile);
+			outFile.close();
+			if (!outFile)
+			{
+				std::cout << "Could not write " << tempFile.string() << "!" << std::endl;
+				std::filesystem::remove(tempFile, ec);
+				return 2;
+			}
+		}
+		std::filesystem::rename(tempFile, target, ec);
+		if (ec)
+		{
+			std::cout << "Could not replace " << filename << ": " << ec.message() << std::endl;
+			std::filesystem::remove(tempFile, ec);
+			return 2;
+		}
+		return 0;
+	}
+
+	// Appends all slots of newData that differ from oldData to the delta, and returns the number of changed slots.
+	// Bytes beyond the end of oldData are treated as zeros.
+	uint32_t EncodeSlots(std::span<const uint8_t> oldData, std::span<const uint8_t> newData, const uint32_t slotSize, std::vector<uint8_t> &delta)
+	{
+		const auto oldByte = [oldData](const size_t pos) -> uint8_t { return pos < oldData.size() ? oldData[pos] : 0; };
+
+		uint32_t numChangedSlots = 0;
+		std::vector<DeltaRangeHeader> ranges;
+		for (size_t slotStart = 0; slotStart < newData.size(); slotStart += slotSize)
+		{
+			const size_t slotEnd = std::min(newData.size(), slotStart + slotSize);
+			// Most slots are usually unchanged
+			if (slotEnd <= oldData.size() && !std::memcmp(oldData.data() + slotStart, newData.data() + slotStart, slotEnd - slotStart))
+				continue;
+
+			// Unchanged bytes between two changes are included in the range if this is cheaper than starting a new range
+			ranges.clear();
+			for (size_t pos = slotStart; pos < slotEnd; pos++)
+			{
+				if (newData[pos] == oldByte(pos))
+					continue;
+				size_t lastChange = pos;
+				for (size_t next = pos + 1; next < slotEnd && next - lastChange <= sizeof(DeltaRangeHeader); next++)
+				{
+					if (newData[next] != oldByte(next))
+						lastChange = next;
+				}
+				ranges.push_back({static_cast<uint16_t>(pos - slotStart), static_cast<uint16_t>(lastChange + 1 - pos)});
+				pos = lastChange;
+			}
+			if (ranges.empty())
+				continue;
+
+			Append(delta, DeltaSlotHeader{static_cast<uint32_t>(slotStart / slotSize), static_cast<uint32_t>(ranges.size())});
+			for (const DeltaRangeHeader &range : ranges)
+			{
+				Append(delta, range);
+				const size_t start = slotStart + range.offset;
+				delta.insert(delta.end(), newData.begin() + start, newData.begin() + start + range.size);
+			}
+			numChangedSlots++;
+		}
+		return numChangedSlots;
+	}
+
+	// Applies the changed slots to the data, which must already have the size of the result. Returns false if the delta is malformed.
+	bool DecodeSlots(std::span<const uint8_t> delta, const uint32_t numSlots, const uint32_t slotSize, std::vector<uint8_t> &data)
+	{
+		size_t pos = 0;
+		const auto read = [&delta, &pos](auto &value)
+		{
+			if (delta.size() - pos < sizeof(value))
+				return false;
+			std::memcpy(&value, delta.data() + pos, sizeof(value));
+			pos += sizeof(value);
+			return true;
+		};
+
+		for (uint32_t i = 0; i < numSlots; i++)
+		{
+			DeltaSlotHeader slotHeader;
+			if (!read(slotHeader))
+				return false;
+			const uint64_t slotStart = uint64_t(slotHeader.slot) * slotSize;
+			for (uint32_t r = 0; r < slotHeader.numRanges; r++)
+			{
+				DeltaRangeHeader range;
+				if (!read(range))
+					return false;
+				const uint64_t start = slotStart + range.offset;
+				if (uint32_t(range.offset) + range.size > slotSize || start + range.size > data.size() || delta.size() - pos < range.size)
+					return false;
+				std::memcpy(data.data() + start, delta.data() + pos, range.size);
+				pos += range.size;
+			}
+		}
+		return pos == delta.size();
+	}
+}
+
+int CreateDelta(std::string_view oldFilename, std::string_view newFilename, std::string_view deltaFilename)
+{
+	std::vector<uint8_t> oldFile, newFile, oldData, newData;
+	InputFile::Type oldType, newType;
+	if (const int result = LoadFile(std::string{oldFilename}, oldFile, oldType, oldData); result != 0)
+		return result;
+	if (const int result = LoadFile(std::string{newFilename}, newFile, newType, newData); result != 0)
+		return result;
+	if ((oldType == InputFile::Type::SVZplugin) != (newType == InputFile::Type::SVZplugin))
+	{
+		std::cout << "Both files must be of the same type!" << std::endl;
+		return 2;
+	}
+
+	DeltaHeader header;
+	header.mode = (newType == InputFile::Type::SVZplugin) ? DeltaMode::PluginPatches : DeltaMode::FileBytes;
+	header.slotSize = (header.mode == DeltaMode::PluginPatches) ? PLUGIN_SLOT_SIZE : FILE_SLOT_SIZE;
+	header.baseSize = static_cast<uint32_t>(oldFile.size());
+	header.baseCRC = CRC32(oldFile);
+	header.resultSize = static_cast<uint32_t>(newData.size());
+	header.resultCRC = CRC32(newData);
+
+	std::vector<uint8_t> delta;
+	Append(delta, header);
+	header.numSlots = EncodeSlots(oldData, newData, header.slotSize, delta);
+	std::memcpy(delta.data(), &header, sizeof(header));
+
+	const std::string outFilename{deltaFilename};
+	std::ofstream outFile{outFilename, std::ios::trunc | std::ios::binary};
+	if (!outFile)
+	{
+		std::cout << "Could not open " << outFilename << " for writing!" << std::endl;
+		return 2;
+	}
+	outFile.write(reinterpret_cast<const char *>(delta.data()), delta.size());
+	if (!outFile)
+	{
+		std::cout << "Could not write " << outFilename << "!" << std::endl;
+		return 2;
+	}
+	Stats::Add(Counter::BytesWritten, delta.size());
+
+	const size_t numSlots = (newData.size() + header.slotSize - 1) / header.slotSize;
+	std::cout << header.numSlots << " of " << numSlots << (header.mode == DeltaMode::PluginPatches ? " patches" : " slots") << " changed, delta package size: " << delta.size() << " bytes." << std::endl;
+	return 0;
+}
+
+int ApplyDelta(std::string_view baseFilename, std::string_view deltaFilename, std::string_view resultFilename)
+{
+	const std::string deltaFilenameStr{deltaFilename}, resultFilenameStr{resultFilename};
+	std::vector<uint8_t> delta;
+	if (!ReadFile(deltaFilenameStr, delta))
+	{
+		std::cout << "Could not open " << deltaFilenameStr << " for reading!" << std::endl;
+		return 2;
+	}
+	DeltaHeader header;
+	if (delta.size() >= sizeof(header))
+		std::memcpy(&header, delta.data(), sizeof(header));
+	if (delta.size() < sizeof(header) || !header.IsValid())
+	{
+		std::cout << deltaFilenameStr << " is not a valid delta package!" << std::endl;
+		return 2;
+	}
+
+	std::vector<uint8_t> baseFile, data;
+	InputFile::Type baseType;
+	if (const int result = LoadFile(std::string{baseFilename}, baseFile, baseType, data); result != 0)
+		return result;
+	if (baseFile.size() != header.baseSize || CRC32(baseFile) != header.baseCRC || (baseType == InputFile::Type::SVZplugin) != (header.mode == DeltaMode::PluginPatches))
+	{
+		std::cout << baseFilename << " is not the file that the delta package was created from!" << std::endl;
+		return 3;
+	}
+
+	// Everything is applied and verified in memory first, so that the target file is never left half-updated
+	data.resize(header.resultSize);
+	if (!DecodeSlots(std::span<const uint8_t>{delta}.subspan(sizeof(header)), header.numSlots, header.slotSize, data))
+	{
+		std::cout << deltaFilenameStr << " is not a valid delta package!" << std::endl;
+		return 2;
+	}
+	if (CRC32(data) != header.resultCRC)
+	{
+		std::cout << "The result does not match the checksum stored in " << deltaFilenameStr << "!" << std::endl;
+		return 3;
+	}
+
+	std::vector<PatchVST> patches;
+	if (header.mode == DeltaMode::PluginPatches)
+	{
+		if (header.slotSize != PLUGIN_SLOT_SIZE || header.resultSize % PLUGIN_SLOT_SIZE != 0)
+		{
+			std::cout << deltaFilenameStr << " is not a valid delta package!" << std::endl;
+			return 2;
+		}
+		patches.resize(header.resultSize / PLUGIN_SLOT_SIZE);
+		for (size_t i = 0; i < patches.size(); i++)
+		{
+			std::memcpy(&patches[i], data.data() + i * PLUGIN_SLOT_SIZE, sizeof(PatchVST));
+		}
+	}
+
+	// The base file may also be the target, so the result never overwrites it directly
+	const int result = WriteResultFile(resultFilenameStr, [&](std::ostream &outFile)
+	{
+		if (header.mode == DeltaMode::PluginPatches)
+		{
+			WriteSVZforPlugin(outFile, patches);
+		}
+		else
+		{
+			outFile.write(reinterpret_cast<const char *>(data.data()), data.size());
+			Stats::Add(Counter::BytesWritten, data.size());
+		}
+	});
+	if (result != 0)
+		return result;
+
+	std::cout << "Applied " << header.numSlots << (header.mode == DeltaMode::PluginPatches ? " changed patches" : " changed slots") << " to " << resultFilenameStr << "." << std::endl;
+	return 0;
+}
@@ -0,0 +1,18 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <string_view>
+
+// Delta packages contain only the parts of a file that differ from an older version of the same file, e.g. to distribute a fix for a single patch.
+// The file is divided into slots of 2048 bytes (the size of a JD-08 / ZC1 patch), and only the changed byte ranges of changed slots are stored.
+// JD-800 VST BIN files are compressed as a whole, so for these the slots are the decompressed patches instead.
+// The size and CRC32 of the base file and the result are stored as well, so that a package is never applied to the wrong file.
+
+// Writes a delta package that turns oldFilename into newFilename. Both files must be of the same type. Returns the program exit code.
+int CreateDelta(std::string_view oldFilename, std::string_view newFilename, std::string_view deltaFilename);
+// Applies a delta package to the file it was created from. If resultFilename refers to the base file, only the changed bytes are written
+// (BIN files are always written completely). Nothing is written if the base file or the package do not match. Returns the program exit code.
+int ApplyDelta(std::string_view baseFilename, std::string_view deltaFilename, std::string_view resultFilename);
@@ -0,0 +1,53 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "DeviceImage.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	constexpr uint8_t UNDEFINED_MEMORY = 0xFE;
+	constexpr size_t MEMORY_SIZE = 0x1'800'000;  // enough to address JD-990 card setup
+}
+
+DeviceImage::DeviceImage()
+	: m_memory(MEMORY_SIZE, UNDEFINED_MEMORY)
+{
+	static_assert(AddressMap800::InternalPatch(NUM_PATCHES) <= AddressMap800::DISPLAY);
+	static_assert(AddressMap990::CardPatch(NUM_PATCHES) <= AddressMap990::SETUP_CARD);
+	static_assert(AddressMap990::SETUP_CARD + sizeof(SpecialSetup990) <= MEMORY_SIZE);
+}
+
+bool DeviceImage::Store(const uint32_t address, const uint8_t *data, const size_t size)
+{
+	if (address > m_memory.size() || size > m_memory.size() - address)
+		return false;
+
+	std::copy(data, data + size, m_memory.begin() + address);
+
+	MarkSlots(m_internal800, AddressMap800::PATCH_INTERNAL, AddressMap800::PATCH_STRIDE, address, size);
+	MarkSlots(m_internal990, AddressMap990::PATCH_INTERNAL, AddressMap990::PATCH_STRIDE, address, size);
+	MarkSlots(m_card990, AddressMap990::PATCH_CARD, AddressMap990::PATCH_STRIDE, address, size);
+	return true;
+}
+
+bool DeviceImage::IsPresent(const uint32_t address) const noexcept
+{
+	return address < m_memory.size() && m_memory[address] != UNDEFINED_MEMORY;
+}
+
+// Mark all patch slots whose first byte is covered by the written range
+void DeviceImage::MarkSlots(SlotMask &mask, const uint32_t base, const uint32_t stride, const uint32_t address, const size_t size)
+{
+	const uint64_t end = uint64_t(address) + size;
+	if (end <= base || address >= base + stride * NUM_PATCHES)
+		return;
+
+	uint32_t index = (address > base) ? (address - base + stride - 1) / stride : 0;
+	for (; index < NUM_PATCHES && base + uint64_t(index) * stride < end; index++)
+	{
+		mask[index] = true;
+	}
+}
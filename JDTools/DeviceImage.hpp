@@ -0,0 +1,175 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include "JD-800.hpp"
+#include "JD-990.hpp"
+
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+// Address maps of the SysEx-addressable memory of each device.
+// Each map describes where patches and setups live and which C++ type is stored there.
+struct AddressMap800
+{
+	using Patch = Patch800;
+	using Setup = SpecialSetup800;
+
+	static constexpr bool IS_JD990 = false;
+	static constexpr uint8_t MODEL_ID = 0x3D;
+	static constexpr uint32_t ADDRESS_BYTES = 3;
+
+	static constexpr uint32_t PATCH_TEMPORARY = (0x00 << 14);
+	static constexpr uint32_t SETUP_TEMPORARY = (0x01 << 14);
+	static constexpr uint32_t SYSTEM = (0x02 << 14);
+	static constexpr uint32_t PART = (0x03 << 14);
+	static constexpr uint32_t SETUP_INTERNAL = (0x04 << 14);
+	static constexpr uint32_t PATCH_INTERNAL = (0x05 << 14);
+	static constexpr uint32_t DISPLAY = (0x07 << 14);
+
+	// The JD-800 has no card memory that can be addressed through SysEx
+	static constexpr bool HAS_CARD = false;
+	static constexpr uint32_t PATCH_CARD = PATCH_INTERNAL;
+	static constexpr uint32_t SETUP_CARD = SETUP_INTERNAL;
+
+	static constexpr uint32_t PATCH_STRIDE = (0x03 << 7);
+
+	static constexpr uint32_t InternalPatch(const uint32_t index) noexcept { return PATCH_INTERNAL + index * PATCH_STRIDE; }
+	static constexpr uint32_t CardPatch(const uint32_t index) noexcept { return PATCH_CARD + index * PATCH_STRIDE; }
+};
+
+struct AddressMap990
+{
+	using Patch = Patch990;
+	using Setup = SpecialSetup990;
+
+	static constexpr bool IS_JD990 = true;
+	static constexpr uint8_t MODEL_ID = 0x57;
+	static constexpr uint32_t ADDRESS_BYTES = 4;
+
+	static constexpr uint32_t SYSTEM = (0x00 << 21);
+	static constexpr uint32_t PERFORMANCE_TEMPORARY = (0x01 << 21);
+	static constexpr uint32_t PERFORMANCE_PATCHES_TEMPORARY = (0x02 << 21);
+	static constexpr uint32_t PATCH_TEMPORARY = (0x03 << 21);
+	static constexpr uint32_t SETUP_TEMPORARY = (0x04 << 21);
+	static constexpr uint32_t PERFORMANCE_INTERNAL = (0x05 << 21);
+	static constexpr uint32_t PATCH_INTERNAL = (0x06 << 21);
+	static constexpr uint32_t SETUP_INTERNAL = (0x07 << 21);
+	static constexpr uint32_t SYSTEM_CARD = (0x08 << 21);
+	static constexpr uint32_t PERFORMANCE_CARD = (0x09 << 21);
+	static constexpr uint32_t PATCH_CARD = (0x0A << 21);
+	static constexpr uint32_t SETUP_CARD = (0x0B << 21);
+
+	static constexpr bool HAS_CARD = true;
+
+	static constexpr uint32_t PATCH_STRIDE = (0x01 << 14);
+
+	static constexpr uint32_t InternalPatch(const uint32_t index) noexcept { return PATCH_INTERNAL + index * PATCH_STRIDE; }
+	static constexpr uint32_t CardPatch(const uint32_t index) noexcept { return PATCH_CARD + index * PATCH_STRIDE; }
+};
+
+// Memory image of a JD-800 or JD-990, populated from SysEx Data Set messages.
+// Keeps track of which patch slots have been written to, so that they can be visited without scanning the whole image.
+class DeviceImage
+{
+public:
+	static constexpr uint32_t NUM_PATCHES = 64;
+
+	DeviceImage();
+
+	// Copies data to the given address. Returns false if the data does not fit into the image.
+	bool Store(uint32_t address, const uint8_t *data, size_t size);
+
+	// Returns true if the byte at this address has been written to
+	bool IsPresent(uint32_t address) const noexcept;
+
+	// Returns nullptr if the object is not present or would be out of bounds
+	template<typename T>
+	const T *Get(const uint32_t address) const noexcept
+	{
+		if (address > m_memory.size() || sizeof(T) > m_memory.size() - address || !IsPresent(address))
+			return nullptr;
+		return reinterpret_cast<const T *>(m_memory.data() + address);
+	}
+
+	template<typename Map>
+	const typename Map::Patch *InternalPatch(const uint32_t index) const noexcept
+	{
+		return (index < NUM_PATCHES) ? Get<typename Map::Patch>(Map::InternalPatch(index)) : nullptr;
+	}
+
+	template<typename Map>
+	const typename Map::Patch *CardPatch(const uint32_t index) const noexcept
+	{
+		return (Map::HAS_CARD && index < NUM_PATCHES) ? Get<typename Map::Patch>(Map::CardPatch(index)) : nullptr;
+	}
+
+	template<typename Map>
+	const typename Map::Patch *TemporaryPatch() const noexcept { return Get<typename Map::Patch>(Map::PATCH_TEMPORARY); }
+
+	template<typename Map>
+	const typename Map::Setup *InternalSetup() const noexcept { return Get<typename Map::Setup>(Map::SETUP_INTERNAL); }
+
+	template<typename Map>
+	const typename Map::Setup *CardSetup() const noexcept { return Map::HAS_CARD ? Get<typename Map::Setup>(Map::SETUP_CARD) : nullptr; }
+
+	template<typename Map>
+	const typename Map::Setup *TemporarySetup() const noexcept { return Get<typename Map::Setup>(Map::SETUP_TEMPORARY); }
+
+	template<typename Map>
+	bool HasInternalPatch(const uint32_t index) const noexcept
+	{
+		return index < NUM_PATCHES && InternalSlots<Map>()[index];
+	}
+
+	template<typename Map>
+	bool HasCardPatch(const uint32_t index) const noexcept
+	{
+		return index < NUM_PATCHES && CardSlots<Map>()[index];
+	}
+
+	template<typename Map>
+	uint32_t NumInternalPatches() const noexcept { return static_cast<uint32_t>(InternalSlots<Map>().count()); }
+
+	template<typename Map>
+	uint32_t NumCardPatches() const noexcept { return static_cast<uint32_t>(CardSlots<Map>().count()); }
+
+	// Invokes func(index, patch) for every internal patch slot that has been written to, in ascending order
+	template<typename Map, typename Func>
+	void ForEachInternalPatch(Func &&func) const
+	{
+		ForEachPatch<Map>(InternalSlots<Map>(), &Map::InternalPatch, func);
+	}
+
+	template<typename Map, typename Func>
+	void ForEachCardPatch(Func &&func) const
+	{
+		ForEachPatch<Map>(CardSlots<Map>(), &Map::CardPatch, func);
+	}
+
+private:
+	using SlotMask = std::bitset<NUM_PATCHES>;
+
+	template<typename Map, typename Func>
+	void ForEachPatch(const SlotMask &mask, uint32_t (*address)(uint32_t), Func &func) const
+	{
+		for (uint32_t index = 0; index < NUM_PATCHES; index++)
+		{
+			if (mask[index])
+				func(index, *reinterpret_cast<const typename Map::Patch *>(m_memory.data() + address(index)));
+		}
+	}
+
+	template<typename Map>
+	const SlotMask &InternalSlots() const noexcept { return Map::IS_JD990 ? m_internal990 : m_internal800; }
+	template<typename Map>
+	const SlotMask &CardSlots() const noexcept { return Map::HAS_CARD ? m_card990 : m_noSlots; }
+
+	static void MarkSlots(SlotMask &mask, uint32_t base, uint32_t stride, uint32_t address, size_t size);
+
+	std::vector<uint8_t> m_memory;
+	SlotMask m_internal800, m_internal990, m_card990, m_noSlots;
+};
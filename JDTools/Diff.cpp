@@ -0,0 +1,416 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Diff.hpp"
+#include "DeviceImage.hpp"
+#include "InputFile.hpp"
+#include "JDTools.hpp"
+#include "ParameterTables.hpp"
+#include "SVZ.hpp"
+#include "SysEx.hpp"
+#include "Trace.hpp"
+#include "Utils.hpp"
+
+#include "JD-800.hpp"
+#include "JD-990.hpp"
+#include "JD-08.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	enum class PatchFormat : uint8_t
+	{
+		JD800,
+		JD990,
+		JD800VST,
+	};
+
+	constexpr std::string_view FormatName(const PatchFormat format) noexcept
+	{
+		switch (format)
+		{
+		case PatchFormat::JD800: return "JD-800";
+		case PatchFormat::JD990: return "JD-990";
+		case PatchFormat::JD800VST: return "JD-800 VST / JD-08 / ZC1";
+		}
+		return {};
+	}
+
+	struct PatchEntry
+	{
+		std::string slot;  // e.g. "I11", "C11" or "Temporary 1"
+		std::string name;  // Without trailing spaces
+	};
+
+	// All patches of a file in their native format, and converted to JD-800 patches if the other file has a different format
+	struct PatchFile
+	{
+		std::string filename;
+		PatchFormat format = PatchFormat::JD800;
+		std::vector<PatchEntry> entries;
+		std::vector<Patch800> patches800;
+		std::vector<Patch990> patches990;
+		std::pmr::vector<PatchVST> patchesVST;
+	};
+
+	template<size_t N>
+	std::string PatchName(const std::array<char, N> &name)
+	{
+		std::string str{ToString(name)};
+		while (!str.empty() && str.back() == ' ')
+			str.pop_back();
+		// Keep the output plain ASCII, so that it is valid UTF-8 in the JSON file
+		for (char &c : str)
+		{
+			if (c < 0x20 || c > 0x7E)
+				c = '?';
+		}
+		return str;
+	}
+
+	template<typename Map>
+	void AddImagePatches(const DeviceImage &image, const std::vector<typename Map::Patch> &temporaryPatches, std::vector<typename Map::Patch> &patches, PatchFile &file)
+	{
+		const auto addPatch = [&](std::string slot, const typename Map::Patch &patch)
+		{
+			file.entries.push_back({std::move(slot), PatchName(patch.common.name)});
+			patches.push_back(patch);
+		};
+		image.ForEachInternalPatch<Map>([&](const uint32_t index, const typename Map::Patch &patch) { addPatch(GetPatchIndex(index, DeviceImage::NUM_PATCHES), patch); });
+		image.ForEachCardPatch<Map>([&](const uint32_t index, const typename Map::Patch &patch) { addPatch(GetPatchIndex(index, DeviceImage::NUM_PATCHES, true), patch); });
+		for (size_t i = 0; i < temporaryPatches.size(); i++)
+		{
+			addPatch(std::string{"Temporary "}.append(std::to_string(i + 1)), temporaryPatches[i]);
+		}
+	}
+
+	int LoadSysEx(InputFile &inputFile, PatchFile &file)
+	{
+		std::vector<uint8_t> buffer;
+		std::vector<SysExFrame> frames;
+		inputFile.ReadAllSysExMessages(buffer, frames);
+
+		// The first JD-800 or JD-990 message decides which device's messages are processed, like in all other verbs
+		std::optional<bool> isJD990;
+		DeviceImage image;
+		std::vector<Patch800> temporaryPatches800;
+		std::vector<Patch990> temporaryPatches990;
+		for (const SysExFrame &frame : frames)
+		{
+			const uint8_t *message = buffer.data() + frame.offset;
+			if (frame.size < 6 || message[0] != 0x41 || (message[2] != AddressMap800::MODEL_ID && message[2] != AddressMap990::MODEL_ID))
+				continue;
+
+			const bool messageIsJD990 = (message[2] == AddressMap990::MODEL_ID);
+			if (isJD990 && *isJD990 != messageIsJD990)
+			{
+				std::cout << "WARNING: " << file.filename << " contains mixed JD-800 and JD-990 dumps. Only " << (*isJD990 ? "JD-990" : "JD-800") << " dumps will be compared." << std::endl;
+				continue;
+			}
+			isJD990 = messageIsJD990;
+
+			if (message[3] != 0x12)
+				continue;
+
+			// Address, data and checksum, without EOX
+			if (RolandChecksum(message + 4, frame.size - 5) != 0)
+			{
+				std::cerr << "Invalid SysEx checksum in " << file.filename << "!" << std::endl;
+				return 3;
+			}
+
+			const uint32_t addressBytes = messageIsJD990 ? AddressMap990::ADDRESS_BYTES : AddressMap800::ADDRESS_BYTES;
+			if (frame.size - 2 < 4 + addressBytes)
+			{
+				std::cerr << "WARNING! Skipping SysEx, too short!" << std::endl;
+				continue;
+			}
+
+			uint32_t address = 0;
+			for (uint32_t i = 0; i < addressBytes; i++)
+			{
+				address = (address << 7) | message[4 + i];
+			}
+
+			if (!image.Store(address, message + 4 + addressBytes, frame.size - 6 - addressBytes))
+			{
+				std::cerr << "WARNING! Too large address, ignoring SysEx message!" << std::endl;
+				continue;
+			}
+
+			// Same as the full listing: A temporary patch is complete once its second message has been received
+			if (!messageIsJD990 && address == AddressMap800::PATCH_TEMPORARY + 256 && image.TemporaryPatch<AddressMap800>())
+				temporaryPatches800.push_back(*image.TemporaryPatch<AddressMap800>());
+			else if (messageIsJD990 && address == AddressMap990::PATCH_TEMPORARY + 256 && image.TemporaryPatch<AddressMap990>())
+				temporaryPatches990.push_back(*image.TemporaryPatch<AddressMap990>());
+		}
+
+		if (!isJD990)
+		{
+			std::cout << file.filename << " didn't contain any SysEx messages for either JD-800 or JD-990!" << std::endl;
+			return 2;
+		}
+
+		if (*isJD990)
+		{
+			file.format = PatchFormat::JD990;
+			AddImagePatches<AddressMap990>(image, temporaryPatches990, file.patches990, file);
+		}
+		else
+		{
+			file.format = PatchFormat::JD800;
+			AddImagePatches<AddressMap800>(image, temporaryPatches800, file.patches800, file);
+		}
+		return 0;
+	}
+
+	int LoadPatches(std::string_view filename, PatchFile &file)
+	{
+		file.filename = filename;
+		TraceScope fileScope{"file", "input file", file.filename};
+		std::ifstream inFile{file.filename, std::ios::binary};
+		if (!inFile)
+		{
+			std::cout << "Could not open " << file.filename << " for reading!" << std::endl;
+			return 2;
+		}
+
+		InputFile inputFile{inFile};
+		if (inputFile.GetType() == InputFile::Type::SYX || inputFile.GetType() == InputFile::Type::MID)
+			return LoadSysEx(inputFile, file);
+
+		file.format = PatchFormat::JD800VST;
+		file.patchesVST = (inputFile.GetType() == InputFile::Type::SVD) ? ReadSVD(inFile) : ReadSVZ(inFile);
+		if (file.patchesVST.empty())
+			return 2;
+		const uint32_t numPatches = static_cast<uint32_t>(file.patchesVST.size());
+		for (uint32_t patch = 0; patch < numPatches; patch++)
+		{
+			file.entries.push_back({GetPatchIndex(patch, numPatches), PatchName(file.patchesVST[patch].name)});
+		}
+		return 0;
+	}
+
+	// Brings the patches into the common comparison format. Conversion warnings are printed here, so that they are not interleaved by the comparison threads.
+	void ConvertToJD800(PatchFile &file)
+	{
+		if (file.format == PatchFormat::JD990)
+		{
+			file.patches800.resize(file.patches990.size());
+			for (size_t i = 0; i < file.patches990.size(); i++)
+				ConvertPatch990To800(file.patches990[i], file.patches800[i]);
+		}
+		else if (file.format == PatchFormat::JD800VST)
+		{
+			file.patches800.resize(file.patchesVST.size());
+			for (size_t i = 0; i < file.patchesVST.size(); i++)
+				ConvertPatchVSTTo800(file.patchesVST[i], file.patches800[i]);
+		}
+	}
+
+	struct FieldDifference
+	{
+		const ParameterGroup *group;
+		const ParameterInfo *param;
+		int32_t valueA, valueB;
+	};
+
+	struct PatchPair
+	{
+		uint32_t a, b;
+		bool nameChanged = false;
+		std::vector<FieldDifference> fields;
+
+		bool IsIdentical() const noexcept { return !nameChanged && fields.empty(); }
+	};
+
+	template<typename Patch>
+	void CompareParameters(const Patch &a, const Patch &b, std::vector<FieldDifference> &fields)
+	{
+		// Most patches of two versions of a bank are usually identical
+		if (!std::memcmp(&a, &b, sizeof(Patch)))
+			return;
+		for (const ParameterGroup &group : ParameterGroups<Patch>())
+		{
+			for (const ParameterInfo &param : group.parameters)
+			{
+				const int32_t valueA = GetParameter(&a, group.offset + param.offset, param.type);
+				const int32_t valueB = GetParameter(&b, group.offset + param.offset, param.type);
+				if (valueA != valueB)
+					fields.push_back({&group, &param, valueA, valueB});
+			}
+		}
+	}
+
+	// Pairs up the patches of both files, and returns the indices of all patches that only exist in one of the files
+	void AlignPatches(const PatchFile &fileA, const PatchFile &fileB, const bool byName, std::vector<PatchPair> &pairs, std::vector<uint32_t> &onlyInA, std::vector<uint32_t> &onlyInB)
+	{
+		// Patches with the same name are paired in the order in which they appear in the files
+		std::unordered_map<std::string_view, std::vector<uint32_t>> patchesB;
+		for (uint32_t b = static_cast<uint32_t>(fileB.entries.size()); b-- > 0;)
+		{
+			const PatchEntry &entry = fileB.entries[b];
+			patchesB[byName ? std::string_view{entry.name} : std::string_view{entry.slot}].push_back(b);
+		}
+
+		std::vector<bool> pairedB(fileB.entries.size(), false);
+		for (uint32_t a = 0; a < fileA.entries.size(); a++)
+		{
+			const PatchEntry &entry = fileA.entries[a];
+			auto match = patchesB.find(byName ? std::string_view{entry.name} : std::string_view{entry.slot});
+			if (match == patchesB.end() || match->second.empty())
+			{
+				onlyInA.push_back(a);
+				continue;
+			}
+			pairs.push_back({a, match->second.back()});
+			pairedB[match->second.back()] = true;
+			match->second.pop_back();
+		}
+
+		for (uint32_t b = 0; b < fileB.entries.size(); b++)
+		{
+			if (!pairedB[b])
+				onlyInB.push_back(b);
+		}
+	}
+
+	void ComparePairs(const PatchFile &fileA, const PatchFile &fileB, const PatchFormat format, std::vector<PatchPair> &pairs)
+	{
+		ParallelFor(pairs.size(), [&](const size_t i)
+		{
+			PatchPair &pair = pairs[i];
+			pair.nameChanged = fileA.entries[pair.a].name != fileB.entries[pair.b].name;
+			if (format == PatchFormat::JD990)
+				CompareParameters(fileA.patches990[pair.a], fileB.patches990[pair.b], pair.fields);
+			else if (format == PatchFormat::JD800VST)
+				CompareParameters(fileA.patchesVST[pair.a], fileB.patchesVST[pair.b], pair.fields);
+			else
+				CompareParameters(fileA.patches800[pair.a], fileB.patches800[pair.b], pair.fields);
+		});
+	}
+
+	bool WriteJSON(const std::string &filename, const PatchFile &fileA, const PatchFile &fileB, const bool byName, const PatchFormat format, const std::vector<PatchPair> &pairs, const size_t numIdentical, const std::vector<uint32_t> &onlyInA, const std::vector<uint32_t> &onlyInB)
+	{
+		std::ofstream f{filename, std::ios::trunc};
+		if (!f)
+			return false;
+
+		f << "{\n  \"a\": \"" << EscapeJSON(fileA.filename) << "\",\n"
+			<< "  \"b\": \"" << EscapeJSON(fileB.filename) << "\",\n"
+			<< "  \"alignment\": \"" << (byName ? "name" : "slot") << "\",\n"
+			<< "  \"format\": \"" << FormatName(format) << "\",\n"
+			<< "  \"identical\": " << numIdentical << ",\n"
+			<< "  \"changed\": [";
+		bool first = true;
+		for (const PatchPair &pair : pairs)
+		{
+			if (pair.IsIdentical())
+				continue;
+			const PatchEntry &entryA = fileA.entries[pair.a], &entryB = fileB.entries[pair.b];
+			f << (first ? "\n" : ",\n")
+				<< "    {\"slotA\": \"" << EscapeJSON(entryA.slot) << "\", \"nameA\": \"" << EscapeJSON(entryA.name)
+				<< "\", \"slotB\": \"" << EscapeJSON(entryB.slot) << "\", \"nameB\": \"" << EscapeJSON(entryB.name)
+				<< "\", \"fields\": [";
+			for (size_t i = 0; i < pair.fields.size(); i++)
+			{
+				const FieldDifference &field = pair.fields[i];
+				f << (i ? ", " : "") << "{\"path\": \"" << EscapeJSON(ParameterPath(*field.group, *field.param))
+					<< "\", \"a\": " << (field.valueA - field.param->displayOffset)
+					<< ", \"b\": " << (field.valueB - field.param->displayOffset) << "}";
+			}
+			f << "]}";
+			first = false;
+		}
+		f << (first ? "],\n" : "\n  ],\n");
+
+		const auto writeOnlyIn = [&f](std::string_view key, const PatchFile &file, const std::vector<uint32_t> &indices, const bool last)
+		{
+			f << "  \"" << key << "\": [";
+			for (size_t i = 0; i < indices.size(); i++)
+			{
+				const PatchEntry &entry = file.entries[indices[i]];
+				f << (i ? ",\n" : "\n") << "    {\"slot\": \"" << EscapeJSON(entry.slot) << "\", \"name\": \"" << EscapeJSON(entry.name) << "\"}";
+			}
+			f << (indices.empty() ? "]" : "\n  ]") << (last ? "\n" : ",\n");
+		};
+		writeOnlyIn("onlyInA", fileA, onlyInA, false);
+		writeOnlyIn("onlyInB", fileB, onlyInB, true);
+		f << "}\n";
+		return f.good();
+	}
+}
+
+int DiffPatches(std::string_view filenameA, std::string_view filenameB, const bool byName, std::string_view jsonFilename)
+{
+	PatchFile fileA, fileB;
+	if (const int result = LoadPatches(filenameA, fileA); result != 0)
+		return result;
+	if (const int result = LoadPatches(filenameB, fileB); result != 0)
+		return result;
+
+	PatchFormat format = fileA.format;
+	if (fileA.format != fileB.format)
+	{
+		format = PatchFormat::JD800;
+		ConvertToJD800(fileA);
+		ConvertToJD800(fileB);
+	}
+
+	std::cout << "Comparing " << fileA.filename << " (" << FormatName(fileA.format) << ") with " << fileB.filename << " (" << FormatName(fileB.format) << ")";
+	if (fileA.format != fileB.format)
+		std::cout << " as JD-800 patches";
+	std::cout << ", patches aligned by " << (byName ? "name" : "position") << "..." << std::endl;
+
+	std::vector<PatchPair> pairs;
+	std::vector<uint32_t> onlyInA, onlyInB;
+	AlignPatches(fileA, fileB, byName, pairs, onlyInA, onlyInB);
+	ComparePairs(fileA, fileB, format, pairs);
+
+	size_t numIdentical = 0;
+	for (const PatchPair &pair : pairs)
+	{
+		if (pair.IsIdentical())
+		{
+			numIdentical++;
+			continue;
+		}
+
+		const PatchEntry &entryA = fileA.entries[pair.a], &entryB = fileB.entries[pair.b];
+		std::cout << entryA.slot << ": " << entryA.name;
+		if (entryA.slot != entryB.slot || pair.nameChanged)
+			std::cout << " => " << entryB.slot << ": " << entryB.name;
+		std::cout << "\n";
+		for (const FieldDifference &field : pair.fields)
+		{
+			std::cout << "\t" << field.group->prefix << field.param->name << ": " << (field.valueA - field.param->displayOffset) << " => " << (field.valueB - field.param->displayOffset) << "\n";
+		}
+	}
+	for (const uint32_t a : onlyInA)
+	{
+		std::cout << "Only in " << fileA.filename << ": " << fileA.entries[a].slot << ": " << fileA.entries[a].name << "\n";
+	}
+	for (const uint32_t b : onlyInB)
+	{
+		std::cout << "Only in " << fileB.filename << ": " << fileB.entries[b].slot << ": " << fileB.entries[b].name << "\n";
+	}
+
+	std::cout << pairs.size() << " patches compared: " << numIdentical << " identical, " << (pairs.size() - numIdentical) << " different, "
+		<< onlyInA.size() << " only in " << fileA.filename << ", " << onlyInB.size() << " only in " << fileB.filename << "." << std::endl;
+
+	if (!jsonFilename.empty() && !WriteJSON(std::string{jsonFilename}, fileA, fileB, byName, format, pairs, numIdentical, onlyInA, onlyInB))
+	{
+		std::cout << "Could not write " << jsonFilename << "!" << std::endl;
+		return 2;
+	}
+	return 0;
+}
@@ -0,0 +1,13 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <string_view>
+
+// Compares the patches of two SysEx / BIN / SVD / SVZ files parameter by parameter and prints all differences.
+// Patches are paired up by their position (e.g. I11 with I11), or by their name if byName is set.
+// Files of the same patch format are compared in that format, otherwise both sides are converted to JD-800 patches first.
+// If jsonFilename is not empty, the differences are also written to that file. Returns the program exit code.
+int DiffPatches(std::string_view filenameA, std::string_view filenameB, bool byName, std::string_view jsonFilename);
@@ -0,0 +1,797 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Edit.hpp"
+#include "DeviceImage.hpp"
+#include "InputFile.hpp"
+#include "JDTools.hpp"
+#include "MidiFile.hpp"
+#include "ParameterTables.hpp"
+#include "SVZ.hpp"
+#include "Stats.hpp"
+#include "SysEx.hpp"
+#include "Trace.hpp"
+#include "Utils.hpp"
+
+#include "JD-800.hpp"
+#include "JD-990.hpp"
+#include "JD-08.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// Arithmetic expression over the current parameter value x, compiled to a small stack program
+	class Expression
+	{
+	public:
+		// Returns an empty string on success, or a description of the problem
+		std::string Parse(std::string_view str)
+		{
+			m_input = str;
+			m_pos = 0;
+			m_error.clear();
+			m_program.clear();
+			m_depth = 0;
+			m_maxDepth = 0;
+			m_nesting = 0;
+
+			if (ParseSum() && SkipSpace() < m_input.size())
+				Fail("Unexpected character");
+			if (m_error.empty() && m_maxDepth > MAX_STACK_DEPTH)
+				m_error = "Expression is nested too deeply";
+			return m_error;
+		}
+
+		double Evaluate(const double x) const noexcept
+		{
+			std::array<double, MAX_STACK_DEPTH> stack;
+			size_t sp = 0;
+			for (const Instruction &instr : m_program)
+			{
+				switch (instr.op)
+				{
+				case Op::Constant: stack[sp++] = instr.value; break;
+				case Op::X: stack[sp++] = x; break;
+				case Op::Negate: stack[sp - 1] = -stack[sp - 1]; break;
+				case Op::Add: sp--; stack[sp - 1] += stack[sp]; break;
+				case Op::Subtract: sp--; stack[sp - 1] -= stack[sp]; break;
+				case Op::Multiply: sp--; stack[sp - 1] *= stack[sp]; break;
+				case Op::Divide: sp--; stack[sp - 1] /= stack[sp]; break;
+				case Op::Min: sp--; stack[sp - 1] = std::min(stack[sp - 1], stack[sp]); break;
+				case Op::Max: sp--; stack[sp - 1] = std::max(stack[sp - 1], stack[sp]); break;
+				case Op::Clamp: sp -= 2; stack[sp - 1] = std::max(stack[sp], std::min(stack[sp - 1], stack[sp + 1])); break;
+				}
+			}
+			return stack[0];
+		}
+
+	private:
+		static constexpr int MAX_STACK_DEPTH = 32;
+
+		enum class Op : uint8_t
+		{
+			Constant,
+			X,
+			Negate,
+			Add,
+			Subtract,
+			Multiply,
+			Divide,
+			Min,
+			Max,
+			Clamp,
+		};
+
+		struct Instruction
+		{
+			Op op;
+			double value = 0.0;
+		};
+
+		size_t SkipSpace() noexcept
+		{
+			while (m_pos < m_input.size() && (m_input[m_pos] == ' ' || m_input[m_pos] == '\t'))
+				m_pos++;
+			return m_pos;
+		}
+
+		bool Accept(const char c) noexcept
+		{
+			if (SkipSpace() < m_input.size() && m_input[m_pos] == c)
+			{
+				m_pos++;
+				return true;
+			}
+			return false;
+		}
+
+		// Tracks how deeply parentheses, function calls and unary operators are nested while parsing.
+		// Deeper nesting is rejected before it can overflow the call stack of the recursive parser.
+		class NestingScope
+		{
+		public:
+			NestingScope(int &nesting) noexcept
+				: m_nesting{nesting}
+			{
+				m_nesting++;
+			}
+
+			~NestingScope()
+			{
+				m_nesting--;
+			}
+
+			bool IsTooDeep() const noexcept { return m_nesting > MAX_STACK_DEPTH; }
+
+		private:
+			int &m_nesting;
+		};
+
+		bool Fail(std::string_view message)
+		{
+			if (m_error.empty())
+			{
+				m_error = message;
+				m_error.append(" at position ").append(std::to_string(m_pos + 1));
+			}
+			return false;
+		}
+
+		// Appends an instruction and keeps track of the stack depth that the program needs
+		void Emit(const Op op, const double value = 0.0)
+		{
+			m_program.push_back({op, value});
+			if (op == Op::Constant || op == Op::X)
+				m_depth++;
+			else if (op == Op::Clamp)
+				m_depth -= 2;
+			else if (op != Op::Negate)
+				m_depth--;
+			m_maxDepth = std::max(m_maxDepth, m_depth);
+		}
+
+		bool ParseSum()
+		{
+			if (!ParseProduct())
+				return false;
+			while (true)
+			{
+				if (Accept('+'))
+				{
+					if (!ParseProduct())
+						return false;
+					Emit(Op::Add);
+				}
+				else if (Accept('-'))
+				{
+					if (!ParseProduct())
+						return false;
+					Emit(Op::Subtract);
+				}
+				else
+				{
+					return true;
+				}
+			}
+		}
+
+		bool ParseProduct()
+		{
+			if (!ParseUnary())
+				return false;
+			while (true)
+			{
+				if (Accept('*'))
+				{
+					if (!ParseUnary())
+						return false;
+					Emit(Op::Multiply);
+				}
+				else if (Accept('/'))
+				{
+					if (!ParseUnary())
+						return false;
+					Emit(Op::Divide);
+				}
+				else
+				{
+					return true;
+				}
+			}
+		}
+
+		bool ParseUnary()
+		{
+			if (Accept('-'))
+			{
+				const NestingScope scope{m_nesting};
+				if (scope.IsTooDeep())
+					return Fail("Expression is nested too deeply");
+				if (!ParseUnary())
+					return false;
+				Emit(Op::Negate);
+				return true;
+			}
+			if (Accept('+'))
+			{
+				const NestingScope scope{m_nesting};
+				if (scope.IsTooDeep())
+					return Fail("Expression is nested too deeply");
+				return ParseUnary();
+			}
+			return ParsePrimary();
+		}
+
+		bool ParsePrimary()
+		{
+			if (Accept('('))
+			{
+				const NestingScope scope{m_nesting};
+				if (scope.IsTooDeep())
+					return Fail("Expression is nested too deeply");
+				if (!ParseSum())
+					return false;
+				return Accept(')') || Fail("Expected )");
+			}
+
+			if (SkipSpace() >= m_input.size())
+				return Fail("Expected a value");
+
+			const char *first = m_input.data() + m_pos, *last = m_input.data() + m_input.size();
+			if ((*first >= '0' && *first <= '9') || *first == '.')
+			{
+				double value = 0.0;
+				const auto result = std::from_chars(first, last, value, std::chars_format::fixed);
+				if (result.ec != std::errc{})
+					return Fail("Invalid number");
+				m_pos += result.ptr - first;
+				Emit(Op::Constant, value);
+				return true;
+			}
+
+			size_t nameLength = 0;
+			while (m_pos + nameLength < m_input.size() && ((m_input[m_pos + nameLength] >= 'a' && m_input[m_pos + nameLength] <= 'z') || (m_input[m_pos + nameLength] >= 'A' && m_input[m_pos + nameLength] <= 'Z')))
+				nameLength++;
+			const std::string_view name = m_input.substr(m_pos, nameLength);
+			if (name == "x")
+			{
+				m_pos += nameLength;
+				Emit(Op::X);
+				return true;
+			}
+
+			Op op;
+			int numArgs;
+			if (name == "min")
+				op = Op::Min, numArgs = 2;
+			else if (name == "max")
+				op = Op::Max, numArgs = 2;
+			else if (name == "clamp")
+				op = Op::Clamp, numArgs = 3;
+			else if (name.empty())
+				return Fail("Expected a value");
+			else
+				return Fail("Unknown function");
+
+			m_pos += nameLength;
+			if (!Accept('('))
+				return Fail("Expected (");
+			const NestingScope scope{m_nesting};
+			if (scope.IsTooDeep())
+				return Fail("Expression is nested too deeply");
+			for (int arg = 0; arg < numArgs; arg++)
+			{
+				if (arg > 0 && !Accept(','))
+					return Fail("Expected ,");
+				if (!ParseSum())
+					return false;
+			}
+			if (!Accept(')'))
+				return Fail("Expected )");
+			Emit(op);
+			return true;
+		}
+
+		std::vector<Instruction> m_program;
+		std::string_view m_input;
+		std::string m_error;
+		size_t m_pos = 0;
+		int m_depth = 0, m_maxDepth = 0;
+		int m_nesting = 0;
+	};
+
+	struct EditRule
+	{
+		std::string_view pattern;
+		Expression expression;
+	};
+
+	std::string_view Trim(std::string_view str) noexcept
+	{
+		while (!str.empty() && (str.front() == ' ' || str.front() == '\t'))
+			str.remove_prefix(1);
+		while (!str.empty() && (str.back() == ' ' || str.back() == '\t'))
+			str.remove_suffix(1);
+		return str;
+	}
+
+	bool ParseEditRule(std::string_view text, EditRule &rule)
+	{
+		const auto equals = text.find('=');
+		if (equals == std::string_view::npos)
+		{
+			std::cout << "Invalid edit \"" << text << "\": Expected <parameter> = <expression>" << std::endl;
+			return false;
+		}
+
+		rule.pattern = Trim(text.substr(0, equals));
+		const bool validPattern = !rule.pattern.empty() && std::all_of(rule.pattern.begin(), rule.pattern.end(), [](const char c)
+		{
+			return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '.' || c == '_' || c == '*' || c == '?';
+		});
+		if (!validPattern)
+		{
+			std::cout << "Invalid edit \"" << text << "\": Invalid parameter name" << std::endl;
+			return false;
+		}
+
+		if (const std::string error = rule.expression.Parse(text.substr(equals + 1)); !error.empty())
+		{
+			std::cout << "Invalid edit \"" << text << "\": " << error << " of the expression" << std::endl;
+			return false;
+		}
+		return true;
+	}
+
+	// Matches a parameter path against a pattern where '*' matches any number of characters and '?' exactly one character
+	bool MatchPattern(const std::string_view pattern, const std::string_view path) noexcept
+	{
+		size_t p = 0, s = 0, starP = std::string_view::npos, starS = 0;
+		while (s < path.size())
+		{
+			if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == path[s]))
+			{
+				p++;
+				s++;
+			}
+			else if (p < pattern.size() && pattern[p] == '*')
+			{
+				starP = p++;
+				starS = s;
+			}
+			else if (starP != std::string_view::npos)
+			{
+				// Let the last star consume one more character
+				p = starP + 1;
+				s = ++starS;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		while (p < pattern.size() && pattern[p] == '*')
+			p++;
+		return p == pattern.size();
+	}
+
+	// An edit rule applied to a single parameter of a patch format
+	struct ParameterEdit
+	{
+		uint32_t offset;
+		ParameterType type;
+		int32_t minValue, maxValue, displayOffset;
+		const Expression *expression;
+	};
+
+	std::vector<ParameterEdit> ResolveEdits(std::span<const EditRule> rules, std::span<const ParameterGroup> groups)
+	{
+		std::vector<ParameterEdit> edits;
+		for (const EditRule &rule : rules)
+		{
+			bool matched = false;
+			for (const ParameterGroup &group : groups)
+			{
+				for (const ParameterInfo &param : group.parameters)
+				{
+					if (!MatchPattern(rule.pattern, ParameterPath(group, param)))
+						continue;
+					edits.push_back({uint32_t(group.offset) + param.offset, param.type, param.minValue, param.maxValue, param.displayOffset, &rule.expression});
+					matched = true;
+				}
+			}
+			if (!matched)
+				std::cout << "WARNING: " << rule.pattern << " does not match any parameter of this patch format!" << std::endl;
+		}
+		return edits;
+	}
+
+	// Applies all edits to a patch in the order they were given, and returns how many parameter values were changed
+	uint32_t ApplyEdits(std::span<const ParameterEdit> edits, void *patch) noexcept
+	{
+		uint32_t numChanged = 0;
+		for (const ParameterEdit &edit : edits)
+		{
+			const int32_t value = GetParameter(patch, edit.offset, edit.type);
+			const double result = edit.expression->Evaluate(value - edit.displayOffset) + edit.displayOffset;
+			if (!std::isfinite(result))
+				continue;
+			const int32_t newValue = static_cast<int32_t>(std::clamp(std::round(result), double(edit.minValue), double(edit.maxValue)));
+			if (newValue != value)
+			{
+				SetParameter(patch, edit.offset, edit.type, newValue);
+				numChanged++;
+			}
+		}
+		return numChanged;
+	}
+
+	struct EditCounts
+	{
+		uint64_t numValues = 0;
+		uint64_t numPatches = 0;
+	};
+
+	// Calls editFunc(patch) for all patches, spread over all CPU cores. editFunc returns the number of changed values of the patch.
+	template<typename Func>
+	EditCounts EditInParallel(const size_t numPatches, const Func &editFunc)
+	{
+		// Patches are handed out in chunks, so that the threads don't have to go through the shared counter for every small patch
+		static constexpr size_t CHUNK_SIZE = 64;
+		const size_t numChunks = (numPatches + CHUNK_SIZE - 1) / CHUNK_SIZE;
+		std::vector<EditCounts> threadCounts(ParallelThreadCount(numChunks));
+		ParallelFor(numChunks, [&](const size_t chunk, const size_t thread)
+		{
+			StageTimer timer{Stage::Convert};
+			EditCounts &counts = threadCounts[thread];
+			const size_t end = std::min(numPatches, (chunk + 1) * CHUNK_SIZE);
+			for (size_t patch = chunk * CHUNK_SIZE; patch < end; patch++)
+			{
+				if (const uint32_t changed = editFunc(patch); changed != 0)
+				{
+					counts.numValues += changed;
+					counts.numPatches++;
+				}
+			}
+		});
+
+		EditCounts total;
+		for (const EditCounts &counts : threadCounts)
+		{
+			total.numValues += counts.numValues;
+			total.numPatches += counts.numPatches;
+		}
+		return total;
+	}
+
+	// Assembles patches from the Data Set messages that cover them, remembering where each part of a patch came from,
+	// so that the edited patch data can be written back into the very same messages.
+	template<typename Map>
+	class SysExPatchEditor
+	{
+	public:
+		using Patch = typename Map::Patch;
+
+		void Add(const uint32_t frame, const uint32_t address, const size_t dataOffset, const uint8_t *data, const size_t size)
+		{
+			AddPatches(Map::PATCH_INTERNAL, frame, address, dataOffset, data, size);
+			if constexpr (Map::HAS_CARD)
+				AddPatches(Map::PATCH_CARD, frame, address, dataOffset, data, size);
+			AddToPatch(Map::PATCH_TEMPORARY, frame, address, dataOffset, data, size);
+		}
+
+		// Only patches that were received completely are edited
+		EditCounts Edit(std::span<const ParameterEdit> edits)
+		{
+			m_changed.assign(m_instances.size(), 0);
+			return EditInParallel(m_instances.size(), [&](const size_t instance) -> uint32_t
+			{
+				if (!m_instances[instance].received.all())
+					return 0;
+				const uint32_t changed = ApplyEdits(edits, &m_instances[instance].patch);
+				m_changed[instance] = (changed != 0);
+				return changed;
+			});
+		}
+
+		size_t NumPatches() const noexcept
+		{
+			return std::count_if(m_instances.begin(), m_instances.end(), [](const Instance &instance) { return instance.received.all(); });
+		}
+
+		// Copies the edited patches back into their messages and updates the checksums of all modified messages
+		void WriteBack(std::vector<uint8_t> &buffer, std::span<const SysExFrame> frames) const
+		{
+			StageTimer timer{Stage::Checksum};
+			std::vector<bool> modifiedFrames(frames.size(), false);
+			for (const Segment &segment : m_segments)
+			{
+				if (!m_changed[segment.instance])
+					continue;
+				const auto *patch = reinterpret_cast<const uint8_t *>(&m_instances[segment.instance].patch);
+				std::memcpy(buffer.data() + segment.dataOffset, patch + segment.patchOffset, segment.size);
+				modifiedFrames[segment.frame] = true;
+			}
+
+			for (size_t frame = 0; frame < frames.size(); frame++)
+			{
+				if (!modifiedFrames[frame])
+					continue;
+				// Checksum covers address and data, and is followed by EOX
+				uint8_t *message = buffer.data() + frames[frame].offset;
+				message[frames[frame].size - 2] = RolandChecksum(message + 4, frames[frame].size - 6);
+			}
+		}
+
+	private:
+		struct Instance
+		{
+			Patch patch{};
+			std::bitset<sizeof(Patch)> received;
+		};
+
+		// Part of a patch that was found in the data of a message
+		struct Segment
+		{
+			uint32_t instance;
+			uint32_t frame;
+			uint32_t patchOffset;
+			uint32_t size;
+			size_t dataOffset;
+		};
+
+		void AddPatches(const uint32_t base, const uint32_t frame, const uint32_t address, const size_t dataOffset, const uint8_t *data, const size_t size)
+		{
+			const uint64_t end = uint64_t(address) + size;
+			if (end <= base || address >= base + uint64_t(Map::PATCH_STRIDE) * DeviceImage::NUM_PATCHES)
+				return;
+
+			uint32_t index = (address > base) ? (address - base) / Map::PATCH_STRIDE : 0;
+			for (; index < DeviceImage::NUM_PATCHES && base + uint64_t(index) * Map::PATCH_STRIDE < end; index++)
+			{
+				AddToPatch(base + index * Map::PATCH_STRIDE, frame, address, dataOffset, data, size);
+			}
+		}
+
+		void AddToPatch(const uint32_t patchAddress, const uint32_t frame, const uint32_t address, const size_t dataOffset, const uint8_t *data, const size_t size)
+		{
+			const uint64_t first = std::max(uint64_t(address), uint64_t(patchAddress));
+			const uint64_t last = std::min(uint64_t(address) + size, uint64_t(patchAddress) + sizeof(Patch));
+			if (first >= last)
+				return;
+
+			// A patch that is sent again after it was complete, e.g. the next temporary patch in a file, is a new patch
+			auto [current, inserted] = m_currentInstance.try_emplace(patchAddress, uint32_t(0));
+			if (inserted || m_instances[current->second].received.all())
+			{
+				current->second = static_cast<uint32_t>(m_instances.size());
+				m_instances.emplace_back();
+			}
+
+			Instance &instance = m_instances[current->second];
+			const auto patchOffset = static_cast<uint32_t>(first - patchAddress), partSize = static_cast<uint32_t>(last - first);
+			std::memcpy(reinterpret_cast<uint8_t *>(&instance.patch) + patchOffset, data + (first - address), partSize);
+			for (uint32_t i = 0; i < partSize; i++)
+			{
+				instance.received.set(patchOffset + i);
+			}
+			m_segments.push_back({current->second, frame, patchOffset, partSize, dataOffset + static_cast<size_t>(first - address)});
+		}
+
+		std::vector<Instance> m_instances;
+		std::vector<Segment> m_segments;
+		std::vector<uint8_t> m_changed;
+		std::unordered_map<uint32_t, uint32_t> m_currentInstance;  // Address of patch => index of the patch that is currently being received there
+	};
+
+	int EditSysEx(InputFile &inputFile, std::span<const EditRule> rules, const std::string &outFilename)
+	{
+		std::vector<uint8_t> buffer;
+		std::vector<SysExFrame> frames;
+		inputFile.ReadAllSysExMessages(buffer, frames);
+
+		// The first JD-800 or JD-990 message decides which device's messages are processed, like in all other verbs
+		std::optional<bool> isJD990;
+		SysExPatchEditor<AddressMap800> editor800;
+		SysExPatchEditor<AddressMap990> editor990;
+		for (uint32_t frame = 0; frame < frames.size(); frame++)
+		{
+			const uint8_t *message = buffer.data() + frames[frame].offset;
+			const size_t messageSize = frames[frame].size;
+			if (messageSize < 6 || message[0] != 0x41 || (message[2] != AddressMap800::MODEL_ID && message[2] != AddressMap990::MODEL_ID))
+				continue;
+
+			const bool messageIsJD990 = (message[2] == AddressMap990::MODEL_ID);
+			if (isJD990 && *isJD990 != messageIsJD990)
+			{
+				std::cout << "WARNING: File contains mixed JD-800 and JD-990 dumps. Only " << (*isJD990 ? "JD-990" : "JD-800") << " dumps will be edited." << std::endl;
+				continue;
+			}
+			isJD990 = messageIsJD990;
+
+			if (message[3] != 0x12)
+				continue;
+
+			// Address, data and checksum, without EOX
+			if (RolandChecksum(message + 4, messageSize - 5) != 0)
+			{
+				std::cerr << "Invalid SysEx checksum!" << std::endl;
+				return 3;
+			}
+
+			const uint32_t addressBytes = messageIsJD990 ? AddressMap990::ADDRESS_BYTES : AddressMap800::ADDRESS_BYTES;
+			if (messageSize - 2 < 4 + addressBytes)
+			{
+				std::cerr << "WARNING! Skipping SysEx, too short!" << std::endl;
+				continue;
+			}
+
+			uint32_t address = 0;
+			for (uint32_t i = 0; i < addressBytes; i++)
+			{
+				address = (address << 7) | message[4 + i];
+			}
+
+			const size_t dataOffset = frames[frame].offset + 4 + addressBytes;
+			const size_t dataSize = messageSize - 6 - addressBytes;
+			if (messageIsJD990)
+				editor990.Add(frame, address, dataOffset, buffer.data() + dataOffset, dataSize);
+			else
+				editor800.Add(frame, address, dataOffset, buffer.data() + dataOffset, dataSize);
+		}
+
+		if (!isJD990)
+		{
+			std::cout << "Input didn't contain any SysEx messages for either JD-800 or JD-990!" << std::endl;
+			return 2;
+		}
+
+		EditCounts counts;
+		size_t numPatches = 0;
+		if (*isJD990)
+		{
+			counts = editor990.Edit(ResolveEdits(rules, ParameterGroups<Patch990>()));
+			editor990.WriteBack(buffer, frames);
+			numPatches = editor990.NumPatches();
+		}
+		else
+		{
+			counts = editor800.Edit(ResolveEdits(rules, ParameterGroups<Patch800>()));
+			editor800.WriteBack(buffer, frames);
+			numPatches = editor800.NumPatches();
+		}
+
+		std::ofstream outFile{outFilename, std::ios::trunc | std::ios::binary};
+		if (!outFile)
+		{
+			std::cout << "Could not open " << outFilename << " for writing!" << std::endl;
+			return 2;
+		}
+
+		// All SysEx messages are written in their original order, including those that were not edited
+		StageTimer timer{Stage::Write};
+		if (inputFile.GetType() == InputFile::Type::MID)
+		{
+			MidiFileWriter midiFile{outFile};
+			std::vector<uint8_t> message;
+			for (const SysExFrame &frame : frames)
+			{
+				message.assign(1, uint8_t(0xF0));
+				message.insert(message.end(), buffer.begin() + frame.offset, buffer.begin() + frame.offset + frame.size);
+				midiFile.WriteSysEx(message);
+			}
+			if (!midiFile.Finish())
+			{
+				std::cout << "Too many SysEx messages for a single MIDI file!" << std::endl;
+				return 2;
+			}
+		}
+		else
+		{
+			for (const SysExFrame &frame : frames)
+			{
+				outFile.put(static_cast<char>(0xF0));
+				outFile.write(reinterpret_cast<const char *>(buffer.data() + frame.offset), frame.size);
+				Stats::Add(Counter::BytesWritten, 1 + frame.size);
+			}
+		}
+
+		if (!outFile)
+		{
+			std::cout << "Could not write " << outFilename << "!" << std::endl;
+			return 2;
+		}
+		std::cout << "Changed " << counts.numValues << " parameter values in " << counts.numPatches << " of " << numPatches << " patches." << std::endl;
+		return 0;
+	}
+
+	int EditVST(std::istream &inFile, const InputFile::Type type, std::span<const EditRule> rules, const std::string &outFilename)
+	{
+		// The SVD file is written back with all of its other contents intact
+		std::vector<char> originalSVDfile;
+		if (type == InputFile::Type::SVD)
+		{
+			const auto start = inFile.tellg();
+			inFile.seekg(0, std::ios::end);
+			const auto size = static_cast<size_t>(inFile.tellg());
+			inFile.seekg(0);
+			ReadVector(inFile, originalSVDfile, size);
+			inFile.clear();
+			inFile.seekg(start);
+		}
+
+		auto patches = (type == InputFile::Type::SVD) ? ReadSVD(inFile) : ReadSVZ(inFile);
+		if (patches.empty())
+			return 2;
+
+		// Patches that were not changed keep their precomputed data, so that they are written back exactly as they were read
+		const auto edits = ResolveEdits(rules, ParameterGroups<PatchVST>());
+		const EditCounts counts = EditInParallel(patches.size(), [&](const size_t patch) -> uint32_t
+		{
+			const uint32_t changed = ApplyEdits(edits, &patches[patch]);
+			if (changed != 0)
+				UpdatePrecomputedVST(patches[patch]);
+			return changed;
+		});
+
+		std::ofstream outFile{outFilename, std::ios::trunc | std::ios::binary};
+		if (!outFile)
+		{
+			std::cout << "Could not open " << outFilename << " for writing!" << std::endl;
+			return 2;
+		}
+
+		if (type == InputFile::Type::SVZplugin)
+			WriteSVZforPlugin(outFile, patches);
+		else if (type == InputFile::Type::SVZhardware)
+			WriteSVZforHardware(outFile, patches);
+		else
+			WriteSVD(outFile, patches, originalSVDfile);
+
+		if (!outFile)
+		{
+			std::cout << "Could not write " << outFilename << "!" << std::endl;
+			return 2;
+		}
+		std::cout << "Changed " << counts.numValues << " parameter values in " << counts.numPatches << " of " << patches.size() << " patches." << std::endl;
+		return 0;
+	}
+}
+
+int EditPatches(std::string_view inFilename, std::string_view outFilename, std::span<char *const> edits)
+{
+	std::vector<EditRule> rules(edits.size());
+	for (size_t i = 0; i < edits.size(); i++)
+	{
+		if (!ParseEditRule(edits[i], rules[i]))
+			return 1;
+	}
+
+	const std::string inFilenameStr{inFilename}, outFilenameStr{outFilename};
+	TraceScope fileScope{"file", "input file", inFilenameStr};
+	std::ifstream inFile{inFilenameStr, std::ios::binary};
+	if (!inFile)
+	{
+		std::cout << "Could not open " << inFilenameStr << " for reading!" << std::endl;
+		return 2;
+	}
+
+	InputFile inputFile{inFile};
+	if (inputFile.GetType() == InputFile::Type::SYX || inputFile.GetType() == InputFile::Type::MID)
+		return EditSysEx(inputFile, rules, outFilenameStr);
+	else
+		return EditVST(inFile, inputFile.GetType(), rules, outFilenameStr);
+}
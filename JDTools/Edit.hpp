@@ -0,0 +1,16 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <span>
+#include <string_view>
+
+// Applies edits of the form "<parameter pattern> = <expression>" to all patches of a SysEx / BIN / SVD / SVZ file,
+// and writes the result to a file of the same type, e.g. "tone*.tvf.resonance = min(x, 90)".
+// The pattern is matched against the parameter paths of the list-verbose output, '*' matches any number of characters and '?' a single character.
+// The expression can use the current value x, numbers, + - * / and parentheses, as well as min(a, b), max(a, b) and clamp(v, low, high).
+// Values are the ones shown by list-verbose, and results are rounded and limited to the valid parameter range.
+// Returns the program exit code.
+int EditPatches(std::string_view inFilename, std::string_view outFilename, std::span<char *const> edits);
@@ -0,0 +1,307 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Generate.hpp"
+#include "Arena.hpp"
+#include "DefaultPatches.hpp"
+#include "DeviceImage.hpp"
+#include "JDTools.hpp"
+#include "MidiFile.hpp"
+#include "ParameterTables.hpp"
+#include "SVZ.hpp"
+#include "Stats.hpp"
+#include "SysEx.hpp"
+#include "Trace.hpp"
+#include "Utils.hpp"
+#include "WaveformNames.hpp"
+
+#include "JD-800.hpp"
+#include "JD-990.hpp"
+#include "JD-08.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+namespace
+{
+	constexpr std::string_view NAME_CHARACTERS = " ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-";
+
+	// SysEx and MIDI files are written as one continuous dump, so that arbitrarily large files can be produced.
+	// The internal bank (and on the JD-990 also the card bank) is filled first, followed by the internal special setup.
+	// All remaining patches are written as temporary patches, which can be split into banks again with the merge verb.
+	template<typename Map>
+	int WriteSysExDump(PatchGenerator &generator, const bool midi, const uint64_t numPatches, const std::string &outFilename)
+	{
+		std::ofstream outFile{outFilename, std::ios::trunc | std::ios::binary};
+		if (!outFile)
+		{
+			std::cout << "Could not open " << outFilename << " for writing!" << std::endl;
+			return 2;
+		}
+
+		std::optional<MidiFileWriter> midiFile;
+		if (midi)
+			midiFile.emplace(outFile);
+		const auto writeMessage = [&outFile, &midiFile](const std::vector<uint8_t> &message)
+		{
+			if (midiFile)
+				midiFile->WriteSysEx(message);
+			else
+			{
+				StageTimer timer{Stage::Write};
+				WriteVector(outFile, message);
+				Stats::Add(Counter::BytesWritten, message.size());
+			}
+		};
+		const auto write = [&writeMessage](const uint32_t address, const auto &object)
+		{
+			BuildDataSet(address, Map::IS_JD990, reinterpret_cast<const uint8_t *>(&object), sizeof(object), writeMessage);
+		};
+
+		typename Map::Patch patch;
+		const uint32_t numBankPatches = static_cast<uint32_t>(std::min(numPatches, uint64_t(DeviceImage::NUM_PATCHES) * (Map::HAS_CARD ? 2 : 1)));
+		for (uint32_t i = 0; i < numBankPatches; i++)
+		{
+			generator.Generate(patch);
+			write((i < DeviceImage::NUM_PATCHES) ? Map::InternalPatch(i) : Map::CardPatch(i - DeviceImage::NUM_PATCHES), patch);
+		}
+
+		typename Map::Setup setup;
+		generator.Generate(setup);
+		write(Map::SETUP_INTERNAL, setup);
+
+		for (uint64_t i = numBankPatches; i < numPatches; i++)
+		{
+			generator.Generate(patch);
+			write(Map::PATCH_TEMPORARY, patch);
+		}
+
+		if (midiFile && !midiFile->Finish())
+		{
+			std::cout << "Too many patches for a single MIDI file!" << std::endl;
+			return 2;
+		}
+		if (!outFile)
+		{
+			std::cout << "Could not write " << outFilename << "!" << std::endl;
+			return 2;
+		}
+		return 0;
+	}
+
+	// BIN, SVZ and SVD files are written bank by bank, using the same bank size and file naming as the convert verb.
+	// SVD files are created from scratch with only a patch chunk. JDTools can read them, but the JD-08 would reject them.
+	int WriteVSTBanks(PatchGenerator &generator, const InputFile::Type type, const uint64_t numPatches, std::string_view outFilename)
+	{
+		const uint32_t bankSize = (type == InputFile::Type::SVD) ? 256 : 64;
+		const std::string_view ext = (type == InputFile::Type::SVZplugin) ? "bin" : ((type == InputFile::Type::SVZhardware) ? "svz" : "svd");
+		const uint64_t numBanks = (numPatches + bankSize - 1) / bankSize;
+		std::vector<PatchVST> bankPatches;
+		Arena scratch;
+		for (uint64_t bank = 0; bank < numBanks; bank++)
+		{
+			scratch.Reset();
+			bankPatches.resize(static_cast<size_t>(std::min(uint64_t(bankSize), numPatches - bank * bankSize)));
+			for (PatchVST &patch : bankPatches)
+			{
+				generator.Generate(patch);
+			}
+			// The plugin and the ZC1 always expect full banks
+			if (type != InputFile::Type::SVD)
+				bankPatches.resize(bankSize, DefaultPatchVST());
+
+			const std::string filename = (numBanks > 1) ? BankFilename(outFilename, static_cast<size_t>(bank), ext) : std::string{outFilename};
+			TraceScope bankScope{"bank", "output bank", filename};
+			std::ofstream outFile{filename, std::ios::trunc | std::ios::binary};
+			if (!outFile)
+			{
+				std::cout << "Could not open " << filename << " for writing!" << std::endl;
+				return 2;
+			}
+
+			if (type == InputFile::Type::SVZplugin)
+				WriteSVZforPlugin(outFile, bankPatches, &scratch);
+			else if (type == InputFile::Type::SVZhardware)
+				WriteSVZforHardware(outFile, bankPatches, &scratch);
+			else
+				WriteSVD(outFile, bankPatches, &scratch);
+
+			if (!outFile)
+			{
+				std::cout << "Could not write " << filename << "!" << std::endl;
+				return 2;
+			}
+		}
+		return 0;
+	}
+}
+
+PatchGenerator::PatchGenerator(const uint64_t seed)
+	: m_rng{seed}
+{
+}
+
+void PatchGenerator::Generate(Patch800 &patch)
+{
+	// Start from the default patch so that bytes not covered by the parameter tables have sensible values
+	patch = DefaultPatch800();
+	RandomizeParameters(ParameterGroups<Patch800>(), &patch);
+	RandomizeName(patch.common.name);
+	SortKeyRange(patch.common.keyRangeLowA, patch.common.keyRangeHighA);
+	SortKeyRange(patch.common.keyRangeLowB, patch.common.keyRangeHighB);
+	SortKeyRange(patch.common.keyRangeLowC, patch.common.keyRangeHighC);
+	SortKeyRange(patch.common.keyRangeLowD, patch.common.keyRangeHighD);
+	RandomizeWaveform(patch.toneA);
+	RandomizeWaveform(patch.toneB);
+	RandomizeWaveform(patch.toneC);
+	RandomizeWaveform(patch.toneD);
+}
+
+void PatchGenerator::Generate(Patch990 &patch)
+{
+	patch = DefaultPatch990();
+	RandomizeParameters(ParameterGroups<Patch990>(), &patch);
+	RandomizeName(patch.common.name);
+	SortKeyRange(patch.keyRanges.keyRangeLowA, patch.keyRanges.keyRangeHighA);
+	SortKeyRange(patch.keyRanges.keyRangeLowB, patch.keyRanges.keyRangeHighB);
+	SortKeyRange(patch.keyRanges.keyRangeLowC, patch.keyRanges.keyRangeHighC);
+	SortKeyRange(patch.keyRanges.keyRangeLowD, patch.keyRanges.keyRangeHighD);
+	RandomizeWaveform(patch.toneA);
+	RandomizeWaveform(patch.toneB);
+	RandomizeWaveform(patch.toneC);
+	RandomizeWaveform(patch.toneD);
+}
+
+void PatchGenerator::Generate(PatchVST &patch)
+{
+	Patch800 p800;
+	Generate(p800);
+	RestrictToVST(p800.toneA);
+	RestrictToVST(p800.toneB);
+	RestrictToVST(p800.toneC);
+	RestrictToVST(p800.toneD);
+	ConvertPatch800ToVST(p800, patch);
+}
+
+void PatchGenerator::Generate(SpecialSetup800 &setup)
+{
+	setup = {};
+	RandomizeParameters(ParameterGroups<SpecialSetup800>(), &setup);
+	for (auto &key : setup.keys)
+	{
+		RandomizeName(key.name);
+		RandomizeWaveform(key.tone);
+	}
+}
+
+void PatchGenerator::Generate(SpecialSetup990 &setup)
+{
+	setup = {};
+	RandomizeParameters(ParameterGroups<SpecialSetup990>(), &setup);
+	RandomizeName(setup.common.name);
+	for (auto &key : setup.keys)
+	{
+		RandomizeName(key.name);
+		RandomizeWaveform(key.tone);
+	}
+}
+
+int32_t PatchGenerator::Random(const int32_t minValue, const int32_t maxValue)
+{
+	const uint64_t range = static_cast<uint64_t>(int64_t(maxValue) - minValue) + 1;
+	// The modulo bias is negligible for ranges this small compared to the 64-bit generator output
+	return static_cast<int32_t>(minValue + static_cast<int64_t>(m_rng() % range));
+}
+
+void PatchGenerator::RandomizeParameters(std::span<const ParameterGroup> groups, void *patch)
+{
+	for (const ParameterGroup &group : groups)
+	{
+		for (const ParameterInfo &param : group.parameters)
+		{
+			SetParameter(patch, group.offset + param.offset, param.type, Random(param.minValue, param.maxValue));
+		}
+	}
+}
+
+void PatchGenerator::RandomizeWaveform(Tone800 &tone)
+{
+	// Card waveforms cannot be checked, so any waveform number is fine for them
+	if (tone.wg.waveSource != 0)
+		return;
+	tone.wg.waveformMSB = 0;
+	tone.wg.waveformLSB = static_cast<uint8_t>(Random(0, NUM_WAVEFORMS_800 - 1));
+}
+
+void PatchGenerator::RandomizeWaveform(Tone990 &tone)
+{
+	if (tone.wg.waveSource != 0)
+		return;
+	const int32_t waveform = Random(0, NUM_WAVEFORMS_990 - 1);
+	tone.wg.waveformMSB = static_cast<uint8_t>(waveform >> 7);
+	tone.wg.waveformLSB = static_cast<uint8_t>(waveform & 0x7F);
+}
+
+// Avoids all values that ConvertPatch800ToVST would have to alter
+void PatchGenerator::RestrictToVST(Tone800 &tone)
+{
+	if (tone.wg.waveSource != 0)
+	{
+		tone.wg.waveSource = 0;
+		RandomizeWaveform(tone);
+	}
+	if (tone.wg.pitchRandom < 20)
+		tone.wg.pitchRandom = 0;
+	// Some waveforms are transposed by up to an octave
+	tone.wg.pitchCoarse = std::clamp(tone.wg.pitchCoarse, uint8_t(48 - 35), uint8_t(48 + 35));
+	// Lowest pitch envelope level is one octave down
+	tone.pitchEnv.level0 = std::max(tone.pitchEnv.level0, uint8_t(4));
+	tone.pitchEnv.level1 = std::max(tone.pitchEnv.level1, uint8_t(4));
+	tone.pitchEnv.level2 = std::max(tone.pitchEnv.level2, uint8_t(4));
+}
+
+void PatchGenerator::SortKeyRange(uint8_t &low, uint8_t &high)
+{
+	if (low > high)
+		std::swap(low, high);
+}
+
+template<size_t N>
+void PatchGenerator::RandomizeName(std::array<char, N> &name)
+{
+	for (char &c : name)
+	{
+		c = NAME_CHARACTERS[Random(0, static_cast<int32_t>(NAME_CHARACTERS.size() - 1))];
+	}
+}
+
+int GeneratePatches(const InputFile::Type type, const bool jd990, const uint64_t numPatches, const uint64_t seed, std::string_view outFilename)
+{
+	std::string_view deviceName = "JD-800 VST / JD-08 / ZC1";
+	if (type == InputFile::Type::SYX || type == InputFile::Type::MID)
+		deviceName = jd990 ? "JD-990" : "JD-800";
+	std::cout << "Generating " << numPatches << " random " << deviceName << " patches (seed " << seed << ")..." << std::endl;
+
+	PatchGenerator generator{seed};
+	int result = 0;
+	if (type == InputFile::Type::SYX || type == InputFile::Type::MID)
+	{
+		const bool midi = (type == InputFile::Type::MID);
+		if (jd990)
+			result = WriteSysExDump<AddressMap990>(generator, midi, numPatches, std::string{outFilename});
+		else
+			result = WriteSysExDump<AddressMap800>(generator, midi, numPatches, std::string{outFilename});
+	}
+	else
+	{
+		result = WriteVSTBanks(generator, type, numPatches, outFilename);
+	}
+
+	if (result == 0)
+		std::cout << "Done." << std::endl;
+	return result;
+}
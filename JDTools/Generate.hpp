@@ -0,0 +1,58 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include "InputFile.hpp"
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string_view>
+
+struct Patch800;
+struct Patch990;
+struct PatchVST;
+struct SpecialSetup800;
+struct SpecialSetup990;
+struct ParameterGroup;
+struct Tone800;
+struct Tone990;
+
+// Produces random, but valid patches and special setups, e.g. for stress tests and benchmarks.
+// All parameters are within the ranges of the parameter tables and pass ValidatePatch.
+// The same seed always yields the same sequence of patches, regardless of platform and compiler.
+class PatchGenerator
+{
+public:
+	explicit PatchGenerator(uint64_t seed);
+
+	void Generate(Patch800 &patch);
+	void Generate(Patch990 &patch);
+	// ZenCore patches are generated as JD-800 patches that only use features the ZenCore engine can represent, and then converted.
+	// This way, all the derived values of the ZenCore patch are consistent.
+	void Generate(PatchVST &patch);
+	void Generate(SpecialSetup800 &setup);
+	void Generate(SpecialSetup990 &setup);
+
+private:
+	// Unlike std::uniform_int_distribution, the result of this does not depend on the standard library implementation
+	int32_t Random(int32_t minValue, int32_t maxValue);
+
+	void RandomizeParameters(std::span<const ParameterGroup> groups, void *patch);
+	void RandomizeWaveform(Tone800 &tone);
+	void RandomizeWaveform(Tone990 &tone);
+	void RestrictToVST(Tone800 &tone);
+	void SortKeyRange(uint8_t &low, uint8_t &high);
+
+	template<size_t N>
+	void RandomizeName(std::array<char, N> &name);
+
+	std::mt19937_64 m_rng;
+};
+
+// Writes numPatches random patches to one or more files of the given type. For SysEx and MIDI files, jd990 selects the device.
+// Returns the program exit code.
+int GeneratePatches(InputFile::Type type, bool jd990, uint64_t numPatches, uint64_t seed, std::string_view outFilename);
@@ -3,11 +3,178 @@
 // License: BSD 3-clause
 
 #include "InputFile.hpp"
+#include "Stats.hpp"
+#include "SVZ.hpp"
 #include "Utils.hpp"
 
-InputFile::InputFile(std::istream &file)
+#include <algorithm>
+#include <span>
+#include <string>
+
+namespace
+{
+	// Number of data bytes following a status byte. Used to skip over channel and system common messages without decoding them.
+	// SysEx (F0 / F7) and meta events (FF) have a variable length and are marked with 0xFF.
+	constexpr std::array<uint8_t, 256> EVENT_DATA_LENGTH = []()
+	{
+		std::array<uint8_t, 256> lengths{};
+		for (size_t status = 0x80; status < 0xF0; status++)
+		{
+			lengths[status] = ((status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0) ? 1 : 2;
+		}
+		lengths[0xF1] = 1;
+		lengths[0xF2] = 2;
+		lengths[0xF3] = 1;
+		lengths[0xF0] = lengths[0xF7] = lengths[0xFF] = 0xFF;
+		return lengths;
+	}();
+
+	class TrackTokenizer
+	{
+	public:
+		TrackTokenizer(std::span<const uint8_t> track)
+			: m_track{track}
+		{
+		}
+
+		// Extracts all SysEx messages from the track (without leading F0 byte), in the order they appear
+		void Tokenize(std::vector<std::vector<uint8_t>> &messages, std::vector<std::string> &warnings)
+		{
+			uint8_t runningStatus = 0;
+			// SysEx messages may be split across several events (F0 ... followed by one or more F7 continuation events).
+			// The fragments point into the track data and are only joined once the message is complete.
+			std::vector<std::span<const uint8_t>> sysExFragments;
+
+			while (m_pos < m_track.size())
+			{
+				// Skip delay value
+				ReadVarInt();
+
+				uint8_t status = ReadUint8();
+				if (status < 0x80)
+				{
+					// Running status: This byte was already the first data byte
+					if (runningStatus)
+						Skip(EVENT_DATA_LENGTH[runningStatus] - 1);
+					continue;
+				}
+				if (status < 0xF0)
+					runningStatus = status;
+				else if (status == 0xF0 || status == 0xF7 || status == 0xFF)
+					runningStatus = 0;  // SysEx and meta events cancel running status
+
+				if (const uint8_t length = EVENT_DATA_LENGTH[status]; length != 0xFF)
+				{
+					Skip(length);
+					continue;
+				}
+
+				if (status == 0xFF)
+				{
+					Skip(1);
+					Skip(ReadVarInt());
+					continue;
+				}
+
+				auto fragment = ReadBytes(ReadVarInt());
+				if (status == 0xF0)
+				{
+					if (!sysExFragments.empty())
+					{
+						// Pass on what we have, so that the message fails the checksum test instead of silently disappearing
+						warnings.push_back("Malformed MIDI file? SysEx message is not terminated before the next SysEx message");
+						messages.push_back(JoinFragments(sysExFragments));
+					}
+				}
+				else if (sysExFragments.empty())
+				{
+					// F7 event without preceding unterminated F0 event: Escape sequence, which may contain a complete SysEx message
+					if (fragment.empty() || fragment.front() != 0xF0)
+						continue;
+					fragment = fragment.subspan(1);
+				}
+
+				sysExFragments.push_back(fragment);
+				if (!fragment.empty() && fragment.back() == 0xF7)
+					messages.push_back(JoinFragments(sysExFragments));
+			}
+
+			if (!sysExFragments.empty())
+			{
+				warnings.push_back("Malformed MIDI file? SysEx message is not terminated at end of track");
+				messages.push_back(JoinFragments(sysExFragments));
+			}
+		}
+
+	private:
+		uint32_t ReadVarInt()
+		{
+			uint8_t b = ReadUint8();
+			uint32_t value = (b & 0x7F);
+
+			while (m_pos < m_track.size() && (b & 0x80) != 0)
+			{
+				b = ReadUint8();
+				value <<= 7;
+				value |= (b & 0x7F);
+			}
+			return value;
+		}
+
+		uint8_t ReadUint8()
+		{
+			if (m_pos >= m_track.size())
+				return 0;
+			return m_track[m_pos++];
+		}
+
+		void Skip(const size_t bytes)
+		{
+			m_pos += std::min(bytes, m_track.size() - m_pos);
+		}
+
+		std::span<const uint8_t> ReadBytes(const uint32_t bytes)
+		{
+			const auto data = m_track.subspan(m_pos, std::min(size_t(bytes), m_track.size() - m_pos));
+			m_pos += data.size();
+			return data;
+		}
+
+		static std::vector<uint8_t> JoinFragments(std::vector<std::span<const uint8_t>> &fragments)
+		{
+			size_t size = 0;
+			for (const auto &fragment : fragments)
+			{
+				size += fragment.size();
+			}
+
+			std::vector<uint8_t> message;
+			message.reserve(size);
+			for (const auto &fragment : fragments)
+			{
+				message.insert(message.end(), fragment.begin(), fragment.end());
+			}
+			fragments.clear();
+			return message;
+		}
+
+		std::span<const uint8_t> m_track;
+		size_t m_pos = 0;
+	};
+}
+
+InputFile::InputFile(std::istream &file, const bool printWarnings)
 	: m_file{file}
+	, m_printWarnings{printWarnings}
 {
+	StageTimer timer{Stage::Read};
+	if (Stats::IsEnabled())
+	{
+		m_file.seekg(0, std::ios::end);
+		Stats::Add(Counter::BytesRead, static_cast<uint64_t>(std::max(std::streamoff(m_file.tellg()), std::streamoff(0))));
+		m_file.seekg(0);
+	}
+
 	std::array<char, 4> magic{};
 	Read(m_file, magic);
 
@@ -17,25 +184,11 @@ InputFile::InputFile(std::istream &file)
 	}
 	else if (CompareMagic(magic, "SVZa"))
 	{
-		uint8_t numChunks = 0;
-		Read(m_file, numChunks);
-		m_file.seekg(16);
-		for (uint32_t chunk = 0; chunk < numChunks; chunk++)
-		{
-			std::array<char, 4> type{};
-			Read(m_file, type);
-			if (CompareMagic(type, "EXTa"))
-			{
-				m_type = Type::SVZplugin;
-				break;
-			}
-			else if (CompareMagic(type, "MDLa"))
-			{
-				m_type = Type::SVZhardware;
-				break;
-			}
-			m_file.seekg(12, std::ios::cur);
-		}
+		const SVZContainer container{m_file};
+		if (container.IsPluginFile())
+			m_type = Type::SVZplugin;
+		else if (container.IsHardwareFile())
+			m_type = Type::SVZhardware;
 	}
 	else if (magic[2] == 'S' && magic[3] == 'V')
 	{
@@ -48,7 +201,7 @@ InputFile::InputFile(std::istream &file)
 	{
 		uint32_t headerLength = ReadUint32BE();
 		m_file.seekg(headerLength, std::ios::cur);
-		m_trackBytesRemain = 0;
+		ReadTracks();
 	}
 	else
 	{
@@ -58,85 +211,12 @@ InputFile::InputFile(std::istream &file)
 
 std::vector<uint8_t> InputFile::NextSysExMessage()
 {
+	StageTimer timer{Stage::Read};
 	if (m_type == Type::MID)
 	{
-		while (!m_file.eof())
-		{
-			if (!m_trackBytesRemain)
-			{
-				std::array<char, 4> magic{};
-				Read(m_file, magic);
-				if (m_file.eof())
-					return {};
-				if (!CompareMagic(magic, "MTrk"))
-				{
-					std::cerr << "Malformed MIDI file? Unexpected track header value" << std::endl;
-					return {};
-				}
-				m_trackBytesRemain = ReadUint32BE();
-			}
-
-			// Skip delay value
-			ReadVarInt();
-
-			uint8_t data1 = ReadUint8();
-			if (data1 == 0xFF)
-			{
-				Skip(1);
-				Skip(ReadVarInt());
-				continue;
-			}
-			uint8_t command = m_lastCommand;
-			if (data1 & 0x80)
-			{
-				// Command byte (if not present, use running status for channel messages)
-				command = data1;
-				if (data1 < 0xF0)
-				{
-					m_lastCommand = data1;
-					data1 = ReadUint8();
-				}
-			}
-
-			switch (command & 0xF0)
-			{
-			case 0x80:
-			case 0x90:
-			case 0xA0:
-			case 0xB0:
-			case 0xE0:
-				Skip(1);
-				break;
-			case 0xC0:
-			case 0xD0:
-				break;
-			case 0xF0:
-				switch (command & 0x0F)
-				{
-				case 0x00:
-				case 0x07:
-				{
-					uint32_t sysExLength = ReadVarInt();
-					std::vector<uint8_t> message;
-					ReadVector(m_file, message, sysExLength);
-					m_trackBytesRemain -= sysExLength;
-					if (!message.empty() && message.back() != 0xF7)
-					{
-						std::cerr << "NOT IMPLEMENTED: Continued SysEx message" << std::endl;
-					}
-					return message;
-				}
-				case 0x01:
-				case 0x03:
-					Skip(1);
-				case 0x02:
-					Skip(2);
-				default:
-					break;
-				}
-				break;
-			}
-		}
+		if (m_nextMessage >= m_messages.size())
+			return {};
+		return std::move(m_messages[m_nextMessage++]);
 	}
 	else if (m_type == Type::SYX)
 	{
@@ -155,53 +235,155 @@ std::vector<uint8_t> InputFile::NextSysExMessage()
 			ch = ReadUint8();
 			message.push_back(ch);
 		}
+		if (!message.empty())
+			Stats::Add(Counter::MessagesFramed, 1);
 		return message;
 	}
 	return {};
 }
 
-uint32_t InputFile::ReadVarInt()
+void InputFile::ReadAllSysExMessages(std::vector<uint8_t> &buffer, std::vector<SysExFrame> &frames)
 {
-	uint8_t b = ReadUint8();
-	uint32_t value = (b & 0x7F);
-
-	while (!m_file.eof() && (b & 0x80) != 0)
+	StageTimer timer{Stage::Read};
+	buffer.clear();
+	frames.clear();
+	if (m_type == Type::MID)
+	{
+		size_t totalSize = 0;
+		for (size_t i = m_nextMessage; i < m_messages.size(); i++)
+		{
+			totalSize += m_messages[i].size();
+		}
+		buffer.reserve(totalSize);
+		frames.reserve(m_messages.size() - m_nextMessage);
+		for (; m_nextMessage < m_messages.size(); m_nextMessage++)
+		{
+			const auto &message = m_messages[m_nextMessage];
+			frames.push_back({buffer.size(), message.size()});
+			buffer.insert(buffer.end(), message.begin(), message.end());
+		}
+		m_messages.clear();
+		m_nextMessage = 0;
+	}
+	else if (m_type == Type::SYX)
 	{
-		b = ReadUint8();
-		value <<= 7;
-		value |= (b & 0x7F);
+		const auto start = m_file.tellg();
+		m_file.seekg(0, std::ios::end);
+		const auto end = m_file.tellg();
+		m_file.seekg(start);
+		if (start < 0 || end <= start)
+			return;
+		ReadVector(m_file, buffer, static_cast<size_t>(end - start));
+		m_file.setstate(std::ios::eofbit);
+
+		// Same framing as NextSysExMessage: a message starts after F0 and extends up to and including the next F7
+		auto pos = buffer.begin();
+		while ((pos = std::find(pos, buffer.end(), uint8_t(0xF0))) != buffer.end())
+		{
+			const auto messageStart = ++pos;
+			pos = std::find(pos, buffer.end(), uint8_t(0xF7));
+			if (pos != buffer.end())
+				++pos;
+			if (pos != messageStart)
+				frames.push_back({static_cast<size_t>(messageStart - buffer.begin()), static_cast<size_t>(pos - messageStart)});
+		}
+		Stats::Add(Counter::MessagesFramed, frames.size());
 	}
-	return value;
+}
+
+void InputFile::Warn(std::string message)
+{
+	if (m_printWarnings)
+		std::cerr << message << std::endl;
+	m_warnings.push_back(std::move(message));
 }
 
 uint32_t InputFile::ReadUint32BE()
 {
 	std::array<uint8_t, 4> bytes{};
 	Read(m_file, bytes);
-	m_trackBytesRemain -= 4;
 	return (bytes[0] << 24)
 		| (bytes[1] << 16)
 		| (bytes[2] << 8)
 		| bytes[3];
 }
 
-uint16_t InputFile::ReadUint16BE()
-{
-	std::array<uint8_t, 2> bytes;
-	Read(m_file, bytes);
-	m_trackBytesRemain -= 2;
-	return (bytes[0] << 8)
-		| bytes[1];
-}
-
 uint8_t InputFile::ReadUint8()
 {
-	m_trackBytesRemain--;
 	return static_cast<uint8_t>(m_file.get());
 }
 
-void InputFile::Skip(uint32_t bytes)
+// Extracts the SysEx messages of all tracks of a MIDI file.
+// A first pass only reads the chunk headers to find the track boundaries, then all tracks are tokenized concurrently.
+void InputFile::ReadTracks()
 {
-	m_file.ignore(bytes);
-	m_trackBytesRemain -= bytes;
+	const auto dataStart = m_file.tellg();
+	m_file.seekg(0, std::ios::end);
+	const auto fileEnd = m_file.tellg();
+	m_file.seekg(dataStart);
+	if (dataStart < 0 || fileEnd < dataStart)
+		return;
+	const size_t fileRemaining = static_cast<size_t>(fileEnd - dataStart);
+
+	std::vector<std::span<const uint8_t>> tracks;
+	std::vector<std::pair<size_t, size_t>> trackRanges;
+	size_t dataSize = 0;
+	while (true)
+	{
+		std::array<char, 4> magic{};
+		if (!Read(m_file, magic))
+			break;
+		if (!CompareMagic(magic, "MTrk"))
+		{
+			Warn("Malformed MIDI file? Unexpected track header value");
+			break;
+		}
+		// Never read (or allocate) more track data than what is left in the file
+		size_t trackLength = ReadUint32BE();
+		if (const size_t available = fileRemaining - std::min(dataSize + 8, fileRemaining); trackLength > available)
+		{
+			Warn("Malformed MIDI file? Track is truncated");
+			trackLength = available;
+		}
+		trackRanges.emplace_back(dataSize + 8, trackLength);
+		dataSize += 8 + trackLength;
+		if (dataSize >= fileRemaining)
+			break;
+		m_file.seekg(trackLength, std::ios::cur);
+	}
+
+	m_file.clear();
+	m_file.seekg(dataStart);
+	std::vector<uint8_t> data;
+	if (!ReadVector(m_file, data, dataSize))
+	{
+		Warn("Malformed MIDI file? Track is truncated");
+		data.resize(static_cast<size_t>(std::max(m_file.gcount(), std::streamsize(0))));
+	}
+	for (const auto &[offset, length] : trackRanges)
+	{
+		if (offset <= data.size())
+			tracks.push_back(std::span<const uint8_t>{data}.subspan(offset, std::min(length, data.size() - offset)));
+	}
+
+	std::vector<std::vector<std::vector<uint8_t>>> trackMessages(tracks.size());
+	std::vector<std::vector<std::string>> trackWarnings(tracks.size());
+	ParallelFor(tracks.size(), [&](const size_t track)
+	{
+		TrackTokenizer{tracks[track]}.Tokenize(trackMessages[track], trackWarnings[track]);
+	});
+
+	// Merge messages in file order
+	for (size_t track = 0; track < tracks.size(); track++)
+	{
+		for (auto &warning : trackWarnings[track])
+		{
+			Warn(std::move(warning));
+		}
+		for (auto &message : trackMessages[track])
+		{
+			m_messages.push_back(std::move(message));
+		}
+	}
+	Stats::Add(Counter::MessagesFramed, m_messages.size());
 }
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include "SysEx.hpp"
+
 #include <cstdint>
 #include <iostream>
+#include <string>
 #include <vector>
 
 class InputFile
@@ -20,21 +23,31 @@ public:
 		SVD,
 	};
 
-	InputFile(std::istream &file);
+	// Problems found in the file structure are printed to std::cerr, unless printWarnings is false. They are always available through Warnings().
+	InputFile(std::istream &file, bool printWarnings = true);
 
 	std::vector<uint8_t> NextSysExMessage();
 
+	// Reads all remaining SysEx messages into one contiguous buffer (without leading F0 byte).
+	// Each frame points to one message in the buffer.
+	void ReadAllSysExMessages(std::vector<uint8_t> &buffer, std::vector<SysExFrame> &frames);
+
 	Type GetType() const { return m_type; }
+	const std::vector<std::string> &Warnings() const { return m_warnings; }
 
 private:
-	uint32_t ReadVarInt();
 	uint32_t ReadUint32BE();
-	uint16_t ReadUint16BE();
 	uint8_t ReadUint8();
-	void Skip(uint32_t bytes);
+
+	void ReadTracks();
+	void Warn(std::string message);
 
 	std::istream &m_file;
 	Type m_type = Type::SYX;
-	uint32_t m_trackBytesRemain = 0;
-	uint8_t m_lastCommand = 0;
+	bool m_printWarnings = true;
+	std::vector<std::string> m_warnings;
+
+	// All SysEx messages of a MIDI file are extracted up-front
+	std::vector<std::vector<uint8_t>> m_messages;
+	size_t m_nextMessage = 0;
 };
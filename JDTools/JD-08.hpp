@@ -577,7 +577,10 @@ struct PatchVST
 	EQ eq;                                // 1985
 	uint8_t unison;                       // 1999, Extended feature
 
-	std::array<char, 20320> empty;  // Surely we will need patches to be able to grow to ten times their current size in the future!
+	// In JD-800 VST BIN files, each patch is followed by 20320 zero bytes.
+	// Surely we will need patches to be able to grow to ten times their current size in the future!
+	// The padding is only added when writing files, so that patches can be processed without dragging it along.
+	static constexpr size_t FILE_SIZE = 22352;
 
 	static constexpr ZenHeader DEFAULT_ZEN_HEADER = { 3, 5, 0, 100, {} };
 };
@@ -3,77 +3,44 @@
 // License: BSD 3-clause
 
 #include "JDTools.hpp"
+#include "Arena.hpp"
+#include "Arrow.hpp"
+#include "DefaultPatches.hpp"
+#include "Delta.hpp"
+#include "DeviceImage.hpp"
+#include "Diff.hpp"
+#include "Edit.hpp"
+#include "Generate.hpp"
 #include "InputFile.hpp"
+#include "JX8PPatch.hpp"
+#include "ListNames.hpp"
+#include "RoundTrip.hpp"
 #include "SVZ.hpp"
+#include "Send.hpp"
+#include "Stats.hpp"
+#include "SysEx.hpp"
+#include "Trace.hpp"
 #include "Utils.hpp"
+#include "Validate.hpp"
+#include "VerifyTree.hpp"
 
 #include "JD-800.hpp"
 #include "JD-990.hpp"
 #include "JD-08.hpp"
 
 #include <algorithm>
+#include <charconv>
 #include <cstdint>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <new>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
 
-namespace
-{
-	constexpr uint8_t SYSEX_DEVICE_ID = 0x10;
-	constexpr uint8_t UNDEFINED_MEMORY = 0xFE;
-
-	constexpr uint32_t BASE_ADDR_800_PATCH_TEMPORARY = (0x00 << 14);
-	constexpr uint32_t BASE_ADDR_800_SETUP_TEMPORARY = (0x01 << 14);
-	constexpr uint32_t BASE_ADDR_800_SYSTEM = (0x02 << 14);
-	constexpr uint32_t BASE_ADDR_800_PART = (0x03 << 14);
-	constexpr uint32_t BASE_ADDR_800_SETUP_INTERNAL = (0x04 << 14);
-	constexpr uint32_t BASE_ADDR_800_PATCH_INTERNAL = (0x05 << 14);
-	constexpr uint32_t BASE_ADDR_800_DISPLAY = (0x07 << 14);
-	
-	constexpr uint32_t BASE_ADDR_990_SYSTEM = (0x00 << 21);
-	constexpr uint32_t BASE_ADDR_990_PERFORMANCE_TEMPORARY = (0x01 << 21);
-	constexpr uint32_t BASE_ADDR_990_PERFORMANCE_PATCHES_TEMPORARY = (0x02 << 21);
-	constexpr uint32_t BASE_ADDR_990_PATCH_TEMPORARY = (0x03 << 21);
-	constexpr uint32_t BASE_ADDR_990_SETUP_TEMPORARY = (0x04 << 21);
-	constexpr uint32_t BASE_ADDR_990_PERFORMANCE_INTERNAL = (0x05 << 21);
-	constexpr uint32_t BASE_ADDR_990_PATCH_INTERNAL = (0x06 << 21);
-	constexpr uint32_t BASE_ADDR_990_SETUP_INTERNAL = (0x07 << 21);
-	constexpr uint32_t BASE_ADDR_990_SYSTEM_CARD = (0x08 << 21);
-	constexpr uint32_t BASE_ADDR_990_PERFORMANCE_CARD = (0x09 << 21);
-	constexpr uint32_t BASE_ADDR_990_PATCH_CARD = (0x0A << 21);
-	constexpr uint32_t BASE_ADDR_990_SETUP_CARD = (0x0B << 21);
-
-	constexpr std::array<uint8_t, sizeof(Patch800)> DEFAULT_PATCH_800 =
-	{
-		0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-		0x64, 0x00, 0x7F, 0x00, 0x7F, 0x00, 0x7F, 0x00, 0x7F, 0x02, 0x02, 0x1A, 0x00, 0x00, 0x00, 0x00,
-		0x32, 0x01, 0x01, 0x01, 0x0F, 0x07, 0x00, 0x0F, 0x00, 0x0F, 0x01, 0x24, 0x01, 0x00, 0x40, 0x00,
-		0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x03, 0x32, 0x46, 0x1C,
-		0x13, 0x1E, 0x32, 0x64, 0x05, 0x19, 0x05, 0x19, 0x05, 0x19, 0x02, 0x32, 0x32, 0x6E, 0x32, 0x5F,
-		0x32, 0x69, 0x32, 0x4A, 0x02, 0x3C, 0x4F, 0x4A, 0x64, 0x02, 0x1E, 0x32, 0x0C, 0x18, 0x46, 0x00,
-		0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01, 0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00,
-		0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32, 0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32,
-		0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E, 0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00,
-		0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00, 0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32,
-		0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01,
-		0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32,
-		0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E,
-		0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00,
-		0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32,
-		0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01, 0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00,
-		0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32, 0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32,
-		0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E, 0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00,
-		0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00, 0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32,
-		0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x02, 0x01, 0x4B, 0x00, 0x00, 0x00, 0x01, 0x01,
-		0x32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x30, 0x32, 0x00, 0x0C, 0x01, 0x00, 0x32,
-		0x32, 0x50, 0x32, 0x32, 0x32, 0x0A, 0x32, 0x32, 0x32, 0x32, 0x32, 0x32, 0x02, 0x64, 0x00, 0x1E,
-		0x32, 0x00, 0x32, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32, 0x00, 0x00,
-		0x3C, 0x0A, 0x50, 0x32, 0x01, 0x32, 0x32, 0x32, 0x0A, 0x00, 0x64, 0x32, 0x64, 0x32, 0x64, 0x32,
-	};
-}
-
 static void PrintUsage()
 {
 	std::cout <<
@@ -87,6 +54,8 @@ JDTools convert syx <input> <output>
   to JD-800 or JD-990 SysEx dump (SYX).
   Output is a JD-990 SysEx dump if the source file was a JD-800 SysEx dump,
   otherwise it is always a JD-800 SysEx dump.
+  Card patches of a JD-990 SysEx dump are converted as a second bank, which
+  is written to a second file for all output formats except SVD.
 
 JDTools convert bin <input> <output>
   Converts from JD-800 SysEx dump (SYX / MID), JD-990 SysEx dump (SYX / MID),
@@ -109,92 +78,173 @@ JDTools merge <input1.syx> <input2.syx> <input3.syx> ... <output.syx>
   JD-990 into banks
 
 JDTools list <input.syx>
-  Lists all SysEx / BIN / SVD / SVZ contents
+  Lists all SysEx / BIN / SVD / SVZ contents. JX-8P tones found in SysEx
+  dumps are listed as well.
+
+JDTools list --names <input.syx>
+  Only lists the patch and special setup names. Much faster than a full
+  listing for large files, as no other patch data is decoded.
 
 JDTools list-verbose <input.syx>
   Lists all SysEx / BIN / SVD / SVZ contents, including all patch or special setup parameters
 
 JDTools verify <input1.syx> <input2.syx> <input3.syx> ...
-  Verifies checksum of SySex dumps without doing any conversion
+  Verifies checksum of SySex dumps without doing any conversion.
+  JX-8P tone messages, which have no checksum, are checked for their length.
+
+JDTools validate <input.syx>
+  Checks all patches and special setups in a SysEx / BIN / SVD / SVZ file for
+  parameter values that are out of range or inconsistent, e.g. unknown
+  waveforms or key ranges where the lower key is above the upper key
+
+JDTools roundtrip <input.syx> [--json <report.json>]
+  Converts all patches and special setups to every other supported format and
+  back, and compares the result with the original. Prints how often and by how
+  much each parameter differs after the round trip, and which conversion
+  warnings were shown. Optionally writes the results to a JSON file.
+
+JDTools delta create <old> <new> <update.jdd>
+  Writes a delta package that only contains the parts of a file that differ
+  from an older version of the same file, e.g. to distribute an updated bank.
+
+JDTools delta apply <base> <update.jdd> <result>
+  Applies a delta package to the file it was created from. The result can be
+  written to the base file itself. It is written to a temporary file first,
+  which then replaces the target file, so a failed update leaves the target
+  untouched. The package is rejected if the base file does not match.
+
+JDTools diff <a> <b> [--by-name] [--json <diff.json>]
+  Compares the patches of two SysEx / BIN / SVD / SVZ files and prints every
+  parameter that differs, with its value in both files. Patches are paired up
+  by position, or by name if --by-name is specified. Files of different formats
+  are compared as JD-800 patches. Optionally writes the differences to a JSON
+  file.
+
+JDTools edit <input> <output> <edit1> [<edit2> ...]
+  Changes parameters of all patches in a SysEx / BIN / SVD / SVZ file and
+  writes them to a file of the same type. Each edit has the form
+  "<parameter> = <expression>", e.g. tone*.tvf.resonance = min(x, 90)
+  Parameter names are the ones shown by list-verbose and can contain the
+  wildcards * and ?. Expressions can use the current value x, numbers,
+  + - * / and parentheses, and the functions min, max and clamp. Results are
+  rounded and limited to the valid range of each parameter.
+
+JDTools generate <format> <count> <output> [--seed <seed>] [--jd990]
+  Generates the given number of random, but valid patches, e.g. as test input.
+  Format can be syx, mid, bin, svz or svd. SYX and MID files contain JD-800
+  patches, or JD-990 patches if --jd990 is specified, and a special setup.
+  Patches that do not fit into the patch banks are written as temporary
+  patches. BIN, SVZ and SVD files are split into several files if necessary.
+  The same seed always produces the same patches.
+
+JDTools export --arrow <input> <output.arrow>
+  Writes all patches of a SysEx / BIN / SVD / SVZ file to an Apache Arrow IPC
+  stream, one row per patch and one column per JD-800 patch parameter.
+  JD-990 and JD-800 VST patches are converted to JD-800 patches, their
+  additional parameters are written to separate columns.
+
+JDTools verify-tree <directory> [--json <failures.json>]
+  Recursively verifies all SYX / MID / BIN / SVD / SVZ files in a directory:
+  SysEx checksums, CRC32 checksums of BIN and SVZ files and the structure of
+  SVD files. Prints a summary and optionally writes the list of failed files
+  to a JSON file.
+
+JDTools send <input> <port> [--delay <ms>]
+  Sends all SysEx messages of a SYX / MID file to a JD-800 / JD-990. The port
+  is an ALSA raw MIDI port (hw:<card>,<device>, Linux only), or file:<path> to
+  write the messages to a file at the same pace instead. Each message follows
+  as soon as the previous one has been transmitted and the device had time to
+  process it (20 ms by default, or the given delay). All checksums are
+  verified before sending. Prints the throughput and timing afterwards.
+
+Global options, can be combined with any of the commands above:
+
+--stats
+  Prints how much time was spent reading, verifying checksums, decompressing,
+  converting, compressing and writing, as well as how many bytes, SysEx
+  messages and patches were processed and how often memory was allocated.
+
+--stats-json <stats.json>
+  Writes the same statistics to a JSON file.
+
+--trace <trace.json>
+  Records when each file and bank was processed, and when each patch was
+  converted, compressed or written, and writes these events to a file in the
+  Chrome Trace Event format, which can be viewed in Perfetto.
 )" << std::endl;
 }
 
-static void WriteSysEx(std::ostream &f, uint32_t outAddress, const bool isJD990, const uint8_t *data, size_t size)
+static bool ParseNumber(std::string_view str, uint64_t &value)
 {
-	// debug stuff
-	for (size_t i = 0; i < size; i++)
-	{
-		if (data[i] >= 0x80)
-		{
-			std::cerr << "invalid byte in SysEx data block at " << i << " - either broken parameter conversion or broken SysEx source!" << std::endl;
-		}
-	}
+	const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+	return ec == std::errc{} && ptr == str.data() + str.size();
+}
 
-	std::vector<uint8_t> outMessage;
-	size_t offset = 0;
-	while (size)
-	{
-		const size_t amountToCopy = std::min(size, size_t(256));
-		if (isJD990)
-			outMessage.assign({ 0xF0, 0x41, SYSEX_DEVICE_ID, 0x57, 0x12, static_cast<uint8_t>((outAddress >> 21) & 0x7F), static_cast<uint8_t>((outAddress >> 14) & 0x7F), static_cast<uint8_t>((outAddress >> 7) & 0x7F), static_cast<uint8_t>(outAddress & 0x7F) });
-		else
-			outMessage.assign({ 0xF0, 0x41, SYSEX_DEVICE_ID, 0x3D, 0x12, static_cast<uint8_t>((outAddress >> 14) & 0x7F), static_cast<uint8_t>((outAddress >> 7) & 0x7F), static_cast<uint8_t>(outAddress & 0x7F) });
-		outMessage.insert(outMessage.end(), data + offset, data + offset + amountToCopy);
-		uint8_t checksum = 0;
-		for (size_t i = 5; i < outMessage.size(); i++)
-		{
-			checksum += outMessage[i];
-		}
-		checksum = (~checksum + 1) & 0x7F;
-		outMessage.push_back(checksum);
-		outMessage.push_back(0xF7);
-		WriteVector(f, outMessage);
+static std::pmr::vector<PatchVST> MergePatchesIntoSVD(std::span<const PatchVST> patches, std::span<const PatchVST> sourceFile, const size_t offset, std::pmr::memory_resource *memory)
+{
+	const size_t numLeadingPatches = std::min(sourceFile.size(), offset);
+	std::pmr::vector<PatchVST> merged{memory};
+	merged.reserve(std::max(numLeadingPatches + patches.size(), sourceFile.size()));
+	merged.assign(sourceFile.begin(), sourceFile.begin() + numLeadingPatches);
+	merged.insert(merged.end(), patches.begin(), patches.end());
+	if (merged.size() < sourceFile.size())
+		merged.insert(merged.end(), sourceFile.begin() + merged.size(), sourceFile.end());
+	else if (merged.size() > 256)
+		merged.resize(256);
+	return merged;
+}
 
-		outAddress += static_cast<uint32_t>(amountToCopy);
-		size -= amountToCopy;
-		offset += amountToCopy;
-	}
+// Count heap allocations for --stats. The array and nothrow versions of operator new are implemented on top of this one.
+void *operator new(const size_t size)
+{
+	Stats::Add(Counter::HeapAllocations, 1);
+	if (void *ptr = std::malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc{};
 }
 
-template<typename T>
-static void WriteSysEx(std::ofstream &f, uint32_t outAddress, const bool isJD990, const T &object)
+void operator delete(void *ptr) noexcept
 {
-	WriteSysEx(f, outAddress, isJD990, reinterpret_cast<const uint8_t *>(&object), sizeof(object));
+	std::free(ptr);
 }
 
-static std::vector<PatchVST> MergePatchesIntoSVD(std::vector<PatchVST> patches, const std::vector<PatchVST> &sourceFile, const size_t offset)
+void operator delete(void *ptr, size_t) noexcept
 {
-	patches.insert(patches.begin(), sourceFile.begin(), sourceFile.begin() + std::min(sourceFile.size(), offset));
-	if (patches.size() < sourceFile.size())
-		patches.insert(patches.end(), sourceFile.begin() + patches.size(), sourceFile.end());
-	else if (patches.size() > 256)
-		patches.resize(256);
-	return patches;
+	std::free(ptr);
 }
 
-static std::string GetPatchIndex(const uint32_t patch, const uint32_t numPatches, const bool isCard = false)
+// Used by std::pmr::new_delete_resource, i.e. by pmr containers that are not given an Arena
+void *operator new(const size_t size, const std::align_val_t alignment)
 {
-	std::string patchIndex;
-	if (isCard)
-		patchIndex = 'C';
-	else if (numPatches <= 64)
-		patchIndex = 'I';
-	else
-		patchIndex = 'A' + static_cast<char>(patch / 64u);
-	patchIndex += '1' + ((patch / 8u) % 8u);
-	patchIndex += '1' + (patch % 8u);
-	return patchIndex;
+	Stats::Add(Counter::HeapAllocations, 1);
+	const size_t align = static_cast<size_t>(alignment);
+#ifdef _MSC_VER
+	void *ptr = _aligned_malloc(size ? size : 1, align);
+#else
+	// The size must be a multiple of the alignment
+	void *ptr = std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#endif
+	if (ptr)
+		return ptr;
+	throw std::bad_alloc{};
 }
 
+void operator delete(void *ptr, std::align_val_t) noexcept
+{
+#ifdef _MSC_VER
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
 
-int main(const int argc, char *argv[])
+void operator delete(void *ptr, size_t, const std::align_val_t alignment) noexcept
 {
-	static_assert(sizeof(Patch800) == 384);
-	static_assert(sizeof(Patch990) == 486);
-	static_assert(sizeof(PatchVST) == 22352);
-	static_assert(sizeof(SpecialSetup800) == 5378);
-	static_assert(sizeof(SpecialSetup990) == 6524);
+	operator delete(ptr, alignment);
+}
 
+static int RunVerb(const int argc, char *argv[])
+{
 	if (argc < 3)
 	{
 		PrintUsage();
@@ -205,12 +255,109 @@ int main(const int argc, char *argv[])
 	int numInputFiles = 1, firstFileParam = 2;
 	bool verifyOnly = (verb == "verify"), verifyFailed = false;
 	int numVerifiedSysExMessages = 0;
-	if (verb != "convert" && verb != "list" && verb != "list-verbose" && verb != "verify" && verb != "merge")
+	if (verb == "verify-tree")
+	{
+		if (argc == 3)
+			return VerifyTree(argv[2], {});
+		else if (argc == 5 && std::string_view{argv[3]} == "--json")
+			return VerifyTree(argv[2], argv[4]);
+		PrintUsage();
+		return 1;
+	}
+	if (verb == "list" && argc == 4 && std::string_view{argv[2]} == "--names")
+	{
+		return ListPatchNames(argv[3]);
+	}
+	if (verb == "delta" && argc == 6 && std::string_view{argv[2]} == "create")
+	{
+		return CreateDelta(argv[3], argv[4], argv[5]);
+	}
+	if (verb == "delta" && argc == 6 && std::string_view{argv[2]} == "apply")
+	{
+		return ApplyDelta(argv[3], argv[4], argv[5]);
+	}
+	if (verb == "diff")
+	{
+		bool byName = false, validArgs = argc >= 4;
+		std::string_view jsonFilename;
+		for (int i = 4; i < argc && validArgs; i++)
+		{
+			const std::string_view option = argv[i];
+			if (option == "--by-name")
+				byName = true;
+			else if (option == "--json" && i + 1 < argc)
+				jsonFilename = argv[++i];
+			else
+				validArgs = false;
+		}
+		if (!validArgs)
+		{
+			PrintUsage();
+			return 1;
+		}
+		return DiffPatches(argv[2], argv[3], byName, jsonFilename);
+	}
+	if (verb == "send")
+	{
+		uint64_t delay = DEFAULT_SYSEX_PROCESSING_TIME.count();
+		const bool validArgs = (argc == 4) || (argc == 6 && std::string_view{argv[4]} == "--delay" && ParseNumber(argv[5], delay) && delay <= 10000);
+		if (!validArgs)
+		{
+			PrintUsage();
+			return 1;
+		}
+		return SendSysEx(argv[2], argv[3], std::chrono::milliseconds{delay});
+	}
+	if (verb == "edit")
+	{
+		if (argc < 5)
+		{
+			PrintUsage();
+			return 1;
+		}
+		return EditPatches(argv[2], argv[3], {argv + 4, argv + argc});
+	}
+	if (verb == "generate")
+	{
+		const std::string_view targetStr = argv[2];
+		InputFile::Type targetType = InputFile::Type::SYX;
+		uint64_t numPatches = 0, seed = 0;
+		bool jd990 = false, validArgs = argc >= 5 && ParseNumber(argv[3], numPatches) && numPatches > 0;
+		if (targetStr == "syx" || targetStr == "SYX")
+			targetType = InputFile::Type::SYX;
+		else if (targetStr == "mid" || targetStr == "MID")
+			targetType = InputFile::Type::MID;
+		else if (targetStr == "bin" || targetStr == "BIN")
+			targetType = InputFile::Type::SVZplugin;
+		else if (targetStr == "svz" || targetStr == "SVZ")
+			targetType = InputFile::Type::SVZhardware;
+		else if (targetStr == "svd" || targetStr == "SVD")
+			targetType = InputFile::Type::SVD;
+		else
+			validArgs = false;
+		for (int i = 5; i < argc && validArgs; i++)
+		{
+			const std::string_view option = argv[i];
+			if (option == "--jd990")
+				jd990 = true;
+			else if (option == "--seed" && i + 1 < argc)
+				validArgs = ParseNumber(argv[++i], seed);
+			else
+				validArgs = false;
+		}
+		if (!validArgs)
+		{
+			PrintUsage();
+			return 1;
+		}
+		return GeneratePatches(targetType, jd990, numPatches, seed, argv[4]);
+	}
+	if (verb != "convert" && verb != "list" && verb != "list-verbose" && verb != "verify" && verb != "merge" && verb != "validate" && verb != "roundtrip" && verb != "export")
 	{
 		PrintUsage();
 		return 1;
 	}
-	if ((verb == "list" && argc != 3) || (verb == "list-verbose" && argc != 3) || (verb == "verify" && argc < 3) || (verb == "merge" && argc < 4))
+	if ((verb == "list" && argc != 3) || (verb == "list-verbose" && argc != 3) || (verb == "validate" && argc != 3) || (verb == "roundtrip" && argc != 3 && argc != 5) || (verb == "verify" && argc < 3) || (verb == "merge" && argc < 4) || (verb == "export" && (argc != 5 || std::string_view{argv[2]} != "--arrow")))
 	{
 		PrintUsage();
 		return 1;
@@ -224,6 +371,17 @@ int main(const int argc, char *argv[])
 		numInputFiles = argc - 3;
 	}
 
+	std::string_view jsonFilename;
+	if (verb == "roundtrip" && argc == 5)
+	{
+		if (std::string_view{argv[3]} != "--json")
+		{
+			PrintUsage();
+			return 1;
+		}
+		jsonFilename = argv[4];
+	}
+
 	InputFile::Type targetType = InputFile::Type::SYX;
 	if (verb == "convert")
 	{
@@ -251,6 +409,10 @@ int main(const int argc, char *argv[])
 		}
 		firstFileParam = 3;
 	}
+	else if (verb == "export")
+	{
+		firstFileParam = 3;
+	}
 
 	enum class DeviceType
 	{
@@ -258,18 +420,24 @@ int main(const int argc, char *argv[])
 		JD800,
 		JD990,
 		JD800VST,
+		JX8P,
 	};
 	DeviceType sourceDeviceType = DeviceType::Undetermined;
 
-	std::vector<uint8_t> memory(0x1'800'000, UNDEFINED_MEMORY);  // enough to address JD-990 card setup
+	DeviceImage image;
 	std::vector<Patch800> temporaryPatches800;
 	std::vector<Patch990> temporaryPatches990;
-	std::vector<PatchVST> vstPatches;
-	std::vector<uint8_t> message;
+	std::pmr::vector<PatchVST> vstPatches;
+	std::vector<uint8_t> message, sysExBuffer;
+	std::vector<SysExFrame> sysExFrames, checksumFrames;
+	std::vector<uint8_t> jx8pBuffer;
+	std::vector<SysExFrame> jx8pFrames;
 
 	for (int i = 0; i < numInputFiles; i++)
 	{
 		const std::string inFilename = argv[firstFileParam + i];
+		TraceScope fileScope{"file", "input file", inFilename};
+		StageTimer readTimer{Stage::Read};
 		std::ifstream inFile{inFilename, std::ios::binary};
 		if (!inFile)
 		{
@@ -299,13 +467,82 @@ int main(const int argc, char *argv[])
 				return 2;
 			sourceDeviceType = DeviceType::JD800VST;
 		}
-		else
+		else if (verifyOnly)
 		{
-			if (verifyOnly)
+			std::cout << "Verifying " << inFilename << "..." << std::endl;
+			// Structural problems of MIDI files (already printed) fail verification even if the extracted messages are fine
+			if (!inputFile.Warnings().empty())
+				verifyFailed = true;
+
+			// Frame all Data Set messages of the file first, then check all of their checksums in one go
+			inputFile.ReadAllSysExMessages(sysExBuffer, sysExFrames);
+			checksumFrames.clear();
+			for (const SysExFrame &frame : sysExFrames)
+			{
+				const uint8_t *messageData = sysExBuffer.data() + frame.offset;
+				if (frame.size < 6)
+				{
+					std::cout << "Ignoring SysEx message: Too short" << std::endl;
+					continue;
+				}
+
+				if (messageData[0] != 0x41)
+				{
+					std::cout << "Ignoring SysEx message: Not a Roland device" << std::endl;
+					continue;
+				}
+
+				// JX-8P messages have no checksum, their structure is checked below
+				if (IsJX8PMessage({messageData, frame.size}))
+					continue;
+
+				if (messageData[2] == 0x3D)
+				{
+					sourceDeviceType = DeviceType::JD800;
+				}
+				else if (messageData[2] == 0x57)
+				{
+					sourceDeviceType = DeviceType::JD990;
+				}
+				else
+				{
+					std::cout << "Ignoring SysEx message: Not a JD-800 or JD-990 message" << std::endl;
+					continue;
+				}
+
+				if (messageData[3] != 0x12)
+				{
+					std::cout << "Ignoring SysEx message: Not a Data Set message" << std::endl;
+					continue;
+				}
+
+				// Address, data and checksum, without EOX
+				checksumFrames.push_back({frame.offset + 4, frame.size - 5});
+			}
+
+			const std::vector<bool> checksumValid = VerifyRolandChecksums(sysExBuffer, checksumFrames);
+			for (const bool valid : checksumValid)
 			{
-				std::cout << "Verifying " << inFilename << "..." << std::endl;
+				if (!valid)
+				{
+					std::cerr << "Invalid SysEx checksum!" << std::endl;
+					verifyFailed = true;
+				}
 			}
+			numVerifiedSysExMessages += static_cast<int>(checksumFrames.size());
 
+			const JX8PScan jx8pFile = ExtractJX8PPatches(sysExBuffer, sysExFrames);
+			if (jx8pFile.numMalformed)
+			{
+				std::cerr << "Malformed JX-8P tone message!" << std::endl;
+				verifyFailed = true;
+			}
+			if (!jx8pFile.patches.empty() && sourceDeviceType == DeviceType::Undetermined)
+				sourceDeviceType = DeviceType::JX8P;
+			numVerifiedSysExMessages += static_cast<int>(jx8pFile.patches.size() + jx8pFile.numMalformed);
+		}
+		else
+		{
 			do
 			{
 				message = inputFile.NextSysExMessage();
@@ -324,6 +561,14 @@ int main(const int argc, char *argv[])
 					continue;
 				}
 
+				// JX-8P messages are collected and scanned in one go once all files have been read
+				if (IsJX8PMessage(message))
+				{
+					jx8pFrames.push_back({jx8pBuffer.size(), message.size()});
+					jx8pBuffer.insert(jx8pBuffer.end(), message.begin(), message.end());
+					continue;
+				}
+
 				uint8_t ch = message[2];
 				if (ch != 0x3D && ch != 0x57)
 				{
@@ -333,7 +578,7 @@ int main(const int argc, char *argv[])
 
 				if (ch == 0x3D)
 				{
-					if (sourceDeviceType == DeviceType::JD990 && !verifyOnly)
+					if (sourceDeviceType == DeviceType::JD990)
 					{
 						std::cout << "WARNING: File contains mixed JD-800 and JD-990 dumps. Only JD-990 dumps will be processed." << std::endl;
 						continue;
@@ -342,7 +587,7 @@ int main(const int argc, char *argv[])
 				}
 				else if (ch == 0x57)
 				{
-					if (sourceDeviceType == DeviceType::JD800 && !verifyOnly)
+					if (sourceDeviceType == DeviceType::JD800)
 					{
 						std::cout << "WARNING: File contains mixed JD-800 and JD-990 dumps. Only JD-800 dumps will be processed." << std::endl;
 						continue;
@@ -360,24 +605,10 @@ int main(const int argc, char *argv[])
 				// Remove EOX
 				message.pop_back();
 
-				uint8_t checksum = 0;
-				for (size_t j = 4; j < message.size(); j++)
-				{
-					checksum += message[j];
-				}
-				checksum = (~checksum + 1) & 0x7F;
-				if (checksum != 0)
+				if (RolandChecksum(message.data() + 4, message.size() - 4) != 0)
 				{
 					std::cerr << "Invalid SysEx checksum!" << std::endl;
-					if (verifyOnly)
-						verifyFailed = true;
-					else
-						return 3;
-				}
-				if (verifyOnly)
-				{
-					numVerifiedSysExMessages++;
-					continue;
+					return 3;
 				}
 
 				// Remove checksum byte
@@ -395,22 +626,25 @@ int main(const int argc, char *argv[])
 				else
 					address = (message[4] << 21) | (message[5] << 14) | (message[6] << 7) | message[7];
 
-				if (address + message.size() > memory.size())
+				const size_t dataOffset = (sourceDeviceType == DeviceType::JD800) ? 7 : 8;
+				if (!image.Store(address, message.data() + dataOffset, message.size() - dataOffset))
 				{
 					std::cerr << "WARNING! Too large address, ignoring SysEx message!" << std::endl;
 					continue;
 				}
 
-				std::copy(message.begin() + ((sourceDeviceType == DeviceType::JD800) ? 7 : 8), message.end(), memory.begin() + address);
-
-				if (sourceDeviceType == DeviceType::JD800 && address == BASE_ADDR_800_PATCH_TEMPORARY + 256)
-					temporaryPatches800.push_back(*reinterpret_cast<const Patch800 *>(memory.data() + BASE_ADDR_800_PATCH_TEMPORARY));
-				else if (sourceDeviceType == DeviceType::JD990 && address == BASE_ADDR_990_PATCH_TEMPORARY + 256)
-					temporaryPatches990.push_back(*reinterpret_cast<const Patch990 *>(memory.data() + BASE_ADDR_990_PATCH_TEMPORARY));
+				if (sourceDeviceType == DeviceType::JD800 && address == AddressMap800::PATCH_TEMPORARY + 256)
+					temporaryPatches800.push_back(*image.TemporaryPatch<AddressMap800>());
+				else if (sourceDeviceType == DeviceType::JD990 && address == AddressMap990::PATCH_TEMPORARY + 256)
+					temporaryPatches990.push_back(*image.TemporaryPatch<AddressMap990>());
 			} while (!message.empty());
 		}
 	}
 
+	const JX8PScan jx8p = ExtractJX8PPatches(jx8pBuffer, jx8pFrames);
+	if (sourceDeviceType == DeviceType::Undetermined && !jx8p.patches.empty())
+		sourceDeviceType = DeviceType::JX8P;
+
 	if (sourceDeviceType == DeviceType::Undetermined || (numVerifiedSysExMessages == 0 && verifyOnly))
 	{
 		std::cout << "Input didn't contain any SysEx messages for either JD-800 or JD-990!" << std::endl;
@@ -431,12 +665,18 @@ int main(const int argc, char *argv[])
 		}
 	}
 
+	if (sourceDeviceType == DeviceType::JX8P && verb != "list" && verb != "list-verbose")
+	{
+		std::cout << "JX-8P tones can only be listed and verified!" << std::endl;
+		return 2;
+	}
+
 	if (verb == "convert")
 	{
 		const std::string_view outFilenameBase = argv[4];
 		std::string_view sourceName, targetName, targetExt;
 		std::vector<char> originalSVDfile;
-		std::vector<PatchVST> svdOutputPatches;
+		std::pmr::vector<PatchVST> svdOutputPatches;
 		uint32_t patchOffsetSVD = 0;
 		if (sourceDeviceType == DeviceType::JD800)
 			sourceName = "JD-800";
@@ -509,8 +749,10 @@ int main(const int argc, char *argv[])
 
 		std::cout << "Converting " << sourceName << " patch format to " << targetName << "..." << std::endl;
 
+		// The card patches of a JD-990 dump are converted as a second bank following the internal patches
+		const bool hasCard990 = (sourceDeviceType == DeviceType::JD990 && image.NumCardPatches<AddressMap990>() > 0);
 		if (sourceDeviceType != DeviceType::JD800VST)
-			vstPatches.resize(64);
+			vstPatches.resize(hasCard990 ? 2 * DeviceImage::NUM_PATCHES : DeviceImage::NUM_PATCHES);
 
 		const uint32_t numPatches = static_cast<uint32_t>(vstPatches.size());
 		uint32_t bankSize = 64;
@@ -523,18 +765,54 @@ int main(const int argc, char *argv[])
 		const uint32_t numBanks = (numPatches + bankSize - 1) / bankSize;
 		uint32_t sourcePatch = 0;
 		std::vector<PatchVST> bankPatchesVST(bankSize);
+		// All temporary buffers of a bank are allocated from here, so after the first bank, the heap is no longer needed
+		Arena scratch;
+
+		// The internal and card banks of a JD-990 dump are converted to JD-800 patches concurrently and then written in order.
+		// The lossy conversion warnings of each patch are kept, so that they can be shown together with the patch name as usual.
+		std::vector<Patch800> patches800from990;
+		std::vector<std::string> warnings990;
+		if (sourceDeviceType == DeviceType::JD990)
+		{
+			patches800from990.resize(numPatches);
+			warnings990.resize(numPatches);
+			const auto convertBank = [&](const bool isCard)
+			{
+				TraceScope convertScope{"bank", "convert bank", isCard ? "card" : "internal"};
+				const uint32_t offset = isCard ? DeviceImage::NUM_PATCHES : 0;
+				const auto convert = [&](const uint32_t index, const Patch990 &p990)
+				{
+					ConvertPatch990To800(p990, patches800from990[offset + index]);
+					warnings990[offset + index] = std::exchange(ThreadLocalCapture::Buffer(), {});
+				};
+				if (isCard)
+					image.ForEachCardPatch<AddressMap990>(convert);
+				else
+					image.ForEachInternalPatch<AddressMap990>(convert);
+			};
+
+			ThreadLocalCapture capture;
+			std::streambuf *oldBuf = std::cerr.rdbuf(&capture);
+			std::thread cardThread;
+			if (hasCard990)
+				cardThread = std::thread{convertBank, true};
+			convertBank(false);
+			if (cardThread.joinable())
+				cardThread.join();
+			std::cerr.rdbuf(oldBuf);
+		}
 
 		for (uint32_t bank = 0; bank < numBanks; bank++)
 		{
+			scratch.Reset();
+			// Slots that are missing in the source must not keep the patches of the previous bank
+			if (bank > 0)
+				std::fill(bankPatchesVST.begin(), bankPatchesVST.end(), PatchVST{});
 			std::string outFilename{outFilenameBase};
 			if (numBanks > 1)
-			{
-				if (outFilename.size() > 4 && outFilename[outFilename.size() - 4] == '.')
-					outFilename = outFilename.substr(0, outFilename.size() - 3) + std::to_string(bank + 1) + outFilename.substr(outFilename.size() - 4);
-				else
-					outFilename += "." + std::to_string(bank + 1) + "." + std::string{targetExt};
-			}
+				outFilename = BankFilename(outFilenameBase, bank, targetExt);
 
+			TraceScope bankScope{"bank", "output bank", outFilename};
 			std::ofstream outFile{ outFilename, std::ios::trunc | std::ios::binary };
 
 			// Convert patches
@@ -542,7 +820,7 @@ int main(const int argc, char *argv[])
 			{
 				if (sourcePatch >= numPatches)
 				{
-					ConvertPatch800ToVST(reinterpret_cast<const Patch800 &>(DEFAULT_PATCH_800), bankPatchesVST[destPatch]);
+					bankPatchesVST[destPatch] = DefaultPatchVST();
 					continue;
 				}
 
@@ -554,8 +832,7 @@ int main(const int argc, char *argv[])
 						if (pVST.zenHeader.modelID1 != 3 || pVST.zenHeader.modelID2 != 5)
 						{
 							std::cerr << "Ignoring patch" << GetPatchIndex(sourcePatch, numPatches) << ", appears to be for another synth model!" << std::endl;
-							Reconstruct(pVST);
-							ConvertPatch800ToVST(reinterpret_cast<const Patch800 &>(DEFAULT_PATCH_800), pVST);
+							pVST = DefaultPatchVST();
 						}
 					}
 					if (pVST.effectsGroupA.mfxType != 93 && targetType != InputFile::Type::SVZhardware)
@@ -568,15 +845,13 @@ int main(const int argc, char *argv[])
 					}
 				}
 
-				const uint32_t address800src = BASE_ADDR_800_PATCH_INTERNAL + ((sourcePatch * 0x03) << 7);
-				const uint32_t address990src = BASE_ADDR_990_PATCH_INTERNAL + (sourcePatch << 14);
-				const uint32_t address800dst = BASE_ADDR_800_PATCH_INTERNAL + ((destPatch * 0x03) << 7);
-				const uint32_t address990dst = BASE_ADDR_990_PATCH_INTERNAL + (destPatch << 14);
+				const uint32_t address800dst = AddressMap800::InternalPatch(destPatch);
+				const uint32_t address990dst = AddressMap990::InternalPatch(destPatch);
 				if (sourceDeviceType == DeviceType::JD800)
 				{
-					if (memory[address800src] == UNDEFINED_MEMORY)
+					if (!image.HasInternalPatch<AddressMap800>(sourcePatch))
 						continue;
-					const Patch800 &p800 = *reinterpret_cast<const Patch800 *>(memory.data() + address800src);
+					const Patch800 &p800 = *image.InternalPatch<AddressMap800>(sourcePatch);
 					std::cout << "Converting " << GetPatchIndex(sourcePatch, numPatches) << ": " << ToString(p800.common.name) << std::endl;
 					if (targetType == InputFile::Type::SYX)
 					{
@@ -591,12 +866,14 @@ int main(const int argc, char *argv[])
 				}
 				else if (sourceDeviceType == DeviceType::JD990)
 				{
-					if (memory[address990src] == UNDEFINED_MEMORY)
+					const bool isCard = (sourcePatch >= DeviceImage::NUM_PATCHES);
+					const uint32_t index = sourcePatch % DeviceImage::NUM_PATCHES;
+					if (isCard ? !image.HasCardPatch<AddressMap990>(index) : !image.HasInternalPatch<AddressMap990>(index))
 						continue;
-					const Patch990 &p990 = *reinterpret_cast<const Patch990 *>(memory.data() + address990src);
-					std::cout << "Converting " << GetPatchIndex(sourcePatch, numPatches) << ": " << ToString(p990.common.name) << std::endl;
-					Patch800 p800;
-					ConvertPatch990To800(p990, p800);
+					const Patch990 &p990 = isCard ? *image.CardPatch<AddressMap990>(index) : *image.InternalPatch<AddressMap990>(index);
+					std::cout << "Converting " << GetPatchIndex(index, DeviceImage::NUM_PATCHES, isCard) << ": " << ToString(p990.common.name) << std::endl;
+					std::cerr << warnings990[sourcePatch] << std::flush;
+					const Patch800 &p800 = patches800from990[sourcePatch];
 					if (targetType == InputFile::Type::SYX)
 						WriteSysEx(outFile, address800dst, false, p800);
 					else
@@ -620,106 +897,117 @@ int main(const int argc, char *argv[])
 			}
 
 			if (targetType == InputFile::Type::SVZplugin)
-				WriteSVZforPlugin(outFile, bankPatchesVST);
+				WriteSVZforPlugin(outFile, bankPatchesVST, &scratch);
 			else if (targetType == InputFile::Type::SVZhardware)
-				WriteSVZforHardware(outFile, bankPatchesVST);
+				WriteSVZforHardware(outFile, bankPatchesVST, &scratch);
 			else if (targetType == InputFile::Type::SVD)
-				WriteSVD(outFile, MergePatchesIntoSVD(bankPatchesVST, svdOutputPatches, patchOffsetSVD), originalSVDfile);
+				WriteSVD(outFile, MergePatchesIntoSVD(bankPatchesVST, svdOutputPatches, patchOffsetSVD, &scratch), originalSVDfile, &scratch);
 
-			if(bank > 0)
+			// The card bank of a JD-990 dump comes with its own special setup, but temporary data only goes with the first bank
+			const bool isCardBank = (hasCard990 && bankSize == DeviceImage::NUM_PATCHES && bank == 1);
+			if(bank > 0 && !isCardBank)
 				continue;
 
 			if (targetType != InputFile::Type::SYX && targetType != InputFile::Type::MID)
 			{
+				// Each rhythm setup / special setup is written to its own file next to the bank, e.g. output.setup.bin
+				const auto writeSetup = [&](const std::pmr::vector<PatchVST> &setupPatches, const std::string_view suffix)
+				{
+					std::string setupFilename = outFilename;
+					if (setupFilename.size() > 4 && setupFilename[setupFilename.size() - 4] == '.')
+						setupFilename = setupFilename.substr(0, setupFilename.size() - 3) + std::string{suffix} + setupFilename.substr(setupFilename.size() - 4);
+					else
+						setupFilename.append(".").append(suffix).append(".").append(targetExt);
+
+					std::ofstream outFileSetup{ setupFilename, std::ios::trunc | std::ios::binary };
+
+					if (targetType == InputFile::Type::SVZplugin)
+						WriteSVZforPlugin(outFileSetup, setupPatches, &scratch);
+					else if (targetType == InputFile::Type::SVZhardware)
+						WriteSVZforHardware(outFileSetup, setupPatches, &scratch);
+					else if (targetType == InputFile::Type::SVD)
+						WriteSVD(outFileSetup, MergePatchesIntoSVD(setupPatches, svdOutputPatches, patchOffsetSVD, &scratch), originalSVDfile, &scratch);
+				};
+
 				// Convert rhythm setup / special setup
-				const uint32_t address800 = (memory[BASE_ADDR_800_SETUP_INTERNAL] != UNDEFINED_MEMORY) ? BASE_ADDR_800_SETUP_INTERNAL : BASE_ADDR_800_SETUP_TEMPORARY;
-				const uint32_t address990 = (memory[BASE_ADDR_990_SETUP_INTERNAL] != UNDEFINED_MEMORY) ? BASE_ADDR_990_SETUP_INTERNAL : BASE_ADDR_990_SETUP_TEMPORARY;
-				std::vector<PatchVST> setupPatches;
-				if (sourceDeviceType == DeviceType::JD800 && memory[address800] != UNDEFINED_MEMORY)
+				const SpecialSetup800 *setup800 = image.InternalSetup<AddressMap800>();
+				const SpecialSetup990 *setup990 = isCardBank ? image.CardSetup<AddressMap990>() : image.InternalSetup<AddressMap990>();
+				if (!setup800)
+					setup800 = image.TemporarySetup<AddressMap800>();
+				if (!setup990 && !isCardBank)
+					setup990 = image.TemporarySetup<AddressMap990>();
+				if (sourceDeviceType == DeviceType::JD800 && setup800)
 				{
-					const SpecialSetup800 &s800 = *reinterpret_cast<const SpecialSetup800 *>(memory.data() + address800);
 					std::cout << "Converting special setup" << std::endl;
-					setupPatches = ConvertSetup800ToVST(s800);
+					writeSetup(ConvertSetup800ToVST(*setup800, &scratch), "setup");
 				}
-				else if (sourceDeviceType == DeviceType::JD990 && memory[address990] != UNDEFINED_MEMORY)
+				else if (sourceDeviceType == DeviceType::JD990 && setup990)
 				{
-					const SpecialSetup990 &s990 = *reinterpret_cast<const SpecialSetup990 *>(memory.data() + address990);
 					SpecialSetup800 s800;
-					std::cout << "Converting special setup: " << ToString(s990.common.name) << std::endl;
-					ConvertSetup990To800(s990, s800);
-					setupPatches = ConvertSetup800ToVST(s800);
+					std::cout << "Converting special setup" << (isCardBank ? " (card): " : ": ") << ToString(setup990->common.name) << std::endl;
+					ConvertSetup990To800(*setup990, s800);
+					writeSetup(ConvertSetup800ToVST(s800, &scratch), "setup");
 				}
 
-				if (!setupPatches.empty())
+				// If the card bank does not start a file of its own (SVD output), its special setup gets a separate file next to the first bank
+				if (const SpecialSetup990 *cardSetup = image.CardSetup<AddressMap990>(); hasCard990 && bankSize != DeviceImage::NUM_PATCHES && cardSetup)
 				{
-					if (outFilename.size() > 4 && outFilename[outFilename.size() - 4] == '.')
-						outFilename = outFilename.substr(0, outFilename.size() - 3) + "setup" + outFilename.substr(outFilename.size() - 4);
-					else
-						outFilename += ".setup." + std::string{ targetExt };
-
-					std::ofstream outFileSetup{ outFilename, std::ios::trunc | std::ios::binary };
-
-					if (targetType == InputFile::Type::SVZplugin)
-						WriteSVZforPlugin(outFileSetup, setupPatches);
-					else if (targetType == InputFile::Type::SVZhardware)
-						WriteSVZforHardware(outFileSetup, setupPatches);
-					else if (targetType == InputFile::Type::SVD)
-						WriteSVD(outFileSetup, MergePatchesIntoSVD(setupPatches, svdOutputPatches, patchOffsetSVD), originalSVDfile);
+					SpecialSetup800 s800;
+					std::cout << "Converting special setup (card): " << ToString(cardSetup->common.name) << std::endl;
+					ConvertSetup990To800(*cardSetup, s800);
+					writeSetup(ConvertSetup800ToVST(s800, &scratch), "card.setup");
 				}
 
 				continue;
 			}
 
 			// Convert rhythm setup / special setup
-			const uint32_t address800 = BASE_ADDR_800_SETUP_INTERNAL;
-			const uint32_t address990 = BASE_ADDR_990_SETUP_INTERNAL;
-			if (sourceDeviceType == DeviceType::JD800 && memory[address800] != UNDEFINED_MEMORY)
+			if (const SpecialSetup800 *s800 = image.InternalSetup<AddressMap800>(); sourceDeviceType == DeviceType::JD800 && s800)
 			{
-				const SpecialSetup800 &s800 = *reinterpret_cast<const SpecialSetup800 *>(memory.data() + address800);
 				SpecialSetup990 s990;
 				std::cout << "Converting special setup" << std::endl;
-				ConvertSetup800To990(s800, s990);
-				WriteSysEx(outFile, address990, true, s990);
+				ConvertSetup800To990(*s800, s990);
+				WriteSysEx(outFile, AddressMap990::SETUP_INTERNAL, true, s990);
 			}
-			else if (sourceDeviceType == DeviceType::JD990 && memory[address990] != UNDEFINED_MEMORY)
+			else if (const SpecialSetup990 *s990 = isCardBank ? image.CardSetup<AddressMap990>() : image.InternalSetup<AddressMap990>(); sourceDeviceType == DeviceType::JD990 && s990)
 			{
-				const SpecialSetup990 &s990 = *reinterpret_cast<const SpecialSetup990 *>(memory.data() + address990);
 				SpecialSetup800 s800;
-				std::cout << "Converting special setup: " << ToString(s990.common.name) << std::endl;
-				ConvertSetup990To800(s990, s800);
-				WriteSysEx(outFile, address800, false, s800);
+				std::cout << "Converting special setup" << (isCardBank ? " (card): " : ": ") << ToString(s990->common.name) << std::endl;
+				ConvertSetup990To800(*s990, s800);
+				WriteSysEx(outFile, AddressMap800::SETUP_INTERNAL, false, s800);
 			}
 
+			if (isCardBank)
+				continue;
+
 			// Convert temporary patches
 			for (const auto &p800 : temporaryPatches800)
 			{
 				std::cout << "Converting temporary patch: " << ToString(p800.common.name) << std::endl;
 				Patch990 p990;
 				ConvertPatch800To990(p800, p990);
-				WriteSysEx(outFile, BASE_ADDR_990_PATCH_TEMPORARY, true, p990);
+				WriteSysEx(outFile, AddressMap990::PATCH_TEMPORARY, true, p990);
 			}
 			for (const auto &p990 : temporaryPatches990)
 			{
 				std::cout << "Converting temporary patch: " << ToString(p990.common.name) << std::endl;
 				Patch800 p800;
 				ConvertPatch990To800(p990, p800);
-				WriteSysEx(outFile, BASE_ADDR_800_PATCH_TEMPORARY, false, p800);
+				WriteSysEx(outFile, AddressMap800::PATCH_TEMPORARY, false, p800);
 			}
-			if (sourceDeviceType == DeviceType::JD800 && memory[BASE_ADDR_800_SETUP_TEMPORARY] != UNDEFINED_MEMORY)
+			if (const SpecialSetup800 *s800 = image.TemporarySetup<AddressMap800>(); sourceDeviceType == DeviceType::JD800 && s800)
 			{
-				const SpecialSetup800 &s800 = *reinterpret_cast<const SpecialSetup800 *>(memory.data() + BASE_ADDR_800_SETUP_TEMPORARY);
 				SpecialSetup990 s990;
 				std::cout << "Converting special setup (temporary)" << std::endl;
-				ConvertSetup800To990(s800, s990);
-				WriteSysEx(outFile, BASE_ADDR_990_SETUP_TEMPORARY, true, s990);
+				ConvertSetup800To990(*s800, s990);
+				WriteSysEx(outFile, AddressMap990::SETUP_TEMPORARY, true, s990);
 			}
-			else if (sourceDeviceType == DeviceType::JD990 && memory[BASE_ADDR_990_SETUP_TEMPORARY] != UNDEFINED_MEMORY)
+			else if (const SpecialSetup990 *s990 = image.TemporarySetup<AddressMap990>(); sourceDeviceType == DeviceType::JD990 && s990)
 			{
-				const SpecialSetup990 &s990 = *reinterpret_cast<const SpecialSetup990 *>(memory.data() + BASE_ADDR_990_SETUP_TEMPORARY);
 				SpecialSetup800 s800;
-				std::cout << "Converting special setup (temporary): " << ToString(s990.common.name) << std::endl;
-				ConvertSetup990To800(s990, s800);
-				WriteSysEx(outFile, BASE_ADDR_800_SETUP_TEMPORARY, false, s800);
+				std::cout << "Converting special setup (temporary): " << ToString(s990->common.name) << std::endl;
+				ConvertSetup990To800(*s990, s800);
+				WriteSysEx(outFile, AddressMap800::SETUP_TEMPORARY, false, s800);
 			}
 		}
 	}
@@ -747,6 +1035,7 @@ int main(const int argc, char *argv[])
 					outFilename += "." + std::to_string(bank + 1);
 			}
 
+			TraceScope bankScope{"bank", "output bank", outFilename};
 			std::ofstream outFile{outFilename, std::ios::trunc | std::ios::binary};
 
 			for (uint32_t destPatch = 0; destPatch < 64; destPatch++, sourcePatch++)
@@ -756,13 +1045,13 @@ int main(const int argc, char *argv[])
 
 				if (sourceDeviceType == DeviceType::JD800)
 				{
-					const uint32_t address800 = BASE_ADDR_800_PATCH_INTERNAL + ((destPatch * 0x03) << 7);
+					const uint32_t address800 = AddressMap800::InternalPatch(destPatch);
 					std::cout << "Adding " << GetPatchIndex(destPatch, 64) << ": " << ToString(temporaryPatches800[sourcePatch].common.name) << std::endl;
 					WriteSysEx(outFile, address800, false, temporaryPatches800[sourcePatch]);
 				}
 				else if (sourceDeviceType == DeviceType::JD990)
 				{
-					const uint32_t address990 = BASE_ADDR_990_PATCH_INTERNAL + (destPatch << 14);
+					const uint32_t address990 = AddressMap990::InternalPatch(destPatch);
 					std::cout << "Adding " << GetPatchIndex(destPatch, 64) << ": " << ToString(temporaryPatches990[sourcePatch].common.name) << std::endl;
 					WriteSysEx(outFile, address990, true, temporaryPatches990[sourcePatch]);
 				}
@@ -778,85 +1067,82 @@ int main(const int argc, char *argv[])
 		{
 			std::cout << "Format: JD-800" << std::endl;
 
-			if (memory[BASE_ADDR_800_SYSTEM] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap800::SYSTEM))
 				std::cout << "System data present" << std::endl;
-			if (memory[BASE_ADDR_800_PART] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap800::PART))
 				std::cout << "Part data present" << std::endl;
-			if (memory[BASE_ADDR_800_DISPLAY] != UNDEFINED_MEMORY)
+			if (const auto *display = image.Get<std::array<char, 44>>(AddressMap800::DISPLAY))
 			{
 				std::cout << "Display data:" << std::endl;
-				const char *str = reinterpret_cast<const char *>(memory.data() + BASE_ADDR_800_DISPLAY);
-				std::cout << std::string_view{ str, 22 } << std::endl;
-				std::cout << std::string_view{ str + 22, 22 } << std::endl;
+				std::cout << std::string_view{ display->data(), 22 } << std::endl;
+				std::cout << std::string_view{ display->data() + 22, 22 } << std::endl;
 			}
 		}
 		else if (sourceDeviceType == DeviceType::JD990)
 		{
 			std::cout << "Format: JD-990" << std::endl;
 
-			if (memory[BASE_ADDR_990_SYSTEM] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap990::SYSTEM))
 				std::cout << "System data present" << std::endl;
-			if (memory[BASE_ADDR_990_PERFORMANCE_TEMPORARY] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap990::PERFORMANCE_TEMPORARY))
 				std::cout << "Performance data (temporary) present" << std::endl;
-			if (memory[BASE_ADDR_990_PERFORMANCE_PATCHES_TEMPORARY] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap990::PERFORMANCE_PATCHES_TEMPORARY))
 				std::cout << "Performance patch data (temporary) present" << std::endl;
-			if (memory[BASE_ADDR_990_PERFORMANCE_INTERNAL] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap990::PERFORMANCE_INTERNAL))
 				std::cout << "Performance data (internal) present" << std::endl;
-			if (memory[BASE_ADDR_990_SYSTEM_CARD] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap990::SYSTEM_CARD))
 				std::cout << "Card system data present" << std::endl;
-			if (memory[BASE_ADDR_990_PERFORMANCE_CARD] != UNDEFINED_MEMORY)
+			if (image.IsPresent(AddressMap990::PERFORMANCE_CARD))
 				std::cout << "Performance data (card) present" << std::endl;
 		}
 		else if (sourceDeviceType == DeviceType::JD800VST)
 		{
 			std::cout << "Format: JD-800 VST / JD-08 / ZC1" << std::endl;
 		}
+		else if (sourceDeviceType == DeviceType::JX8P)
+		{
+			std::cout << "Format: JX-8P" << std::endl;
+		}
 
-		const uint32_t numPatches = static_cast<uint32_t>((sourceDeviceType == DeviceType::JD800VST) ? vstPatches.size() : 64u);
-		for (uint32_t patch = 0; patch < numPatches; patch++)
+		if (sourceDeviceType == DeviceType::JD800)
 		{
-			const uint32_t address800 = BASE_ADDR_800_PATCH_INTERNAL + ((patch * 0x03) << 7);
-			const uint32_t address990 = BASE_ADDR_990_PATCH_INTERNAL + (patch << 14);
-			if (sourceDeviceType == DeviceType::JD800)
+			image.ForEachInternalPatch<AddressMap800>([verbose](const uint32_t patch, const Patch800 &p800)
 			{
-				if (memory[address800] == UNDEFINED_MEMORY)
-					continue;
-				const Patch800 &p800 = *reinterpret_cast<const Patch800 *>(memory.data() + address800);
-				std::cout << GetPatchIndex(patch, numPatches) << ": " << ToString(p800.common.name) << std::endl;
+				std::cout << GetPatchIndex(patch, DeviceImage::NUM_PATCHES) << ": " << ToString(p800.common.name) << std::endl;
 				if (verbose)
 					PrintPatch(p800);
-			}
-			else if (sourceDeviceType == DeviceType::JD990)
+			});
+		}
+		else if (sourceDeviceType == DeviceType::JD990)
+		{
+			image.ForEachInternalPatch<AddressMap990>([verbose](const uint32_t patch, const Patch990 &p990)
 			{
-				if (memory[address990] == UNDEFINED_MEMORY)
-					continue;
-				const Patch990 &p990 = *reinterpret_cast<const Patch990 *>(memory.data() + address990);
-				std::cout << GetPatchIndex(patch, numPatches) << ": " << ToString(p990.common.name) << std::endl;
+				std::cout << GetPatchIndex(patch, DeviceImage::NUM_PATCHES) << ": " << ToString(p990.common.name) << std::endl;
 				if (verbose)
 					PrintPatch(p990);
-			}
-			else if (sourceDeviceType == DeviceType::JD800VST)
+			});
+			image.ForEachCardPatch<AddressMap990>([](const uint32_t patch, const Patch990 &p990)
 			{
-				std::cout << GetPatchIndex(patch, numPatches) << ": " << ToString(vstPatches[patch].name) << std::endl;
-				if (verbose)
-					PrintPatch(vstPatches[patch]);
-			}
+				std::cout << GetPatchIndex(patch, DeviceImage::NUM_PATCHES, true) << ": " << ToString(p990.common.name) << std::endl;
+			});
 		}
-		for (uint32_t patch = 0; patch < 64; patch++)
+		else if (sourceDeviceType == DeviceType::JD800VST)
 		{
-			const uint32_t addressCard990 = BASE_ADDR_990_PATCH_CARD + (patch << 14);
-			if (sourceDeviceType == DeviceType::JD990 && memory[addressCard990] != UNDEFINED_MEMORY)
+			const uint32_t numPatches = static_cast<uint32_t>(vstPatches.size());
+			for (uint32_t patch = 0; patch < numPatches; patch++)
 			{
-				const Patch990 &p990 = *reinterpret_cast<const Patch990 *>(memory.data() + addressCard990);
-				std::cout << GetPatchIndex(patch, 64, true) << ": " << ToString(p990.common.name) << std::endl;
+				std::cout << GetPatchIndex(patch, numPatches) << ": " << ToString(vstPatches[patch].name) << std::endl;
+				if (verbose)
+					PrintPatch(vstPatches[patch]);
 			}
 		}
-		if (sourceDeviceType == DeviceType::JD800 && memory[BASE_ADDR_800_PATCH_TEMPORARY] != UNDEFINED_MEMORY)
+
+		if (sourceDeviceType == DeviceType::JD800 && image.TemporaryPatch<AddressMap800>())
 		{
 			for (const auto &p800 : temporaryPatches800)
 				std::cout << "Temporary patch: " << ToString(p800.common.name) << std::endl;
 		}
-		else if (sourceDeviceType == DeviceType::JD990 && memory[BASE_ADDR_990_PATCH_TEMPORARY] != UNDEFINED_MEMORY)
+		else if (sourceDeviceType == DeviceType::JD990 && image.TemporaryPatch<AddressMap990>())
 		{
 			for (const auto &p990 : temporaryPatches990)
 				std::cout << "Temporary patch: " << ToString(p990.common.name) << std::endl;
@@ -864,46 +1150,235 @@ int main(const int argc, char *argv[])
 
 		if (sourceDeviceType == DeviceType::JD800)
 		{
-			if (memory[BASE_ADDR_800_SETUP_INTERNAL] != UNDEFINED_MEMORY)
+			if (const SpecialSetup800 *s800 = image.InternalSetup<AddressMap800>())
 			{
-				const SpecialSetup800 &s800 = *reinterpret_cast<const SpecialSetup800 *>(memory.data() + BASE_ADDR_800_SETUP_INTERNAL);
 				std::cout << "Special setup (internal): JD-800 Drum Set" << std::endl;
 				if (verbose)
-					PrintSetup(s800);
+					PrintSetup(*s800);
 			}
-			if (memory[BASE_ADDR_800_SETUP_TEMPORARY] != UNDEFINED_MEMORY)
+			if (const SpecialSetup800 *s800 = image.TemporarySetup<AddressMap800>())
 			{
-				const SpecialSetup800 &s800 = *reinterpret_cast<const SpecialSetup800 *>(memory.data() + BASE_ADDR_800_SETUP_TEMPORARY);
 				std::cout << "Special setup (temporary): JD-800 Drum Set" << std::endl;
 				if (verbose)
-					PrintSetup(s800);
+					PrintSetup(*s800);
 			}
 		}
 		else if (sourceDeviceType == DeviceType::JD990)
 		{
-			if (memory[BASE_ADDR_990_SETUP_INTERNAL] != UNDEFINED_MEMORY)
+			if (const SpecialSetup990 *s990 = image.InternalSetup<AddressMap990>())
 			{
-				const SpecialSetup990 &s990 = *reinterpret_cast<const SpecialSetup990 *>(memory.data() + BASE_ADDR_990_SETUP_INTERNAL);
-				std::cout << "Special setup (internal): " << ToString(s990.common.name) << std::endl;
+				std::cout << "Special setup (internal): " << ToString(s990->common.name) << std::endl;
 				if (verbose)
-					PrintSetup(s990);
+					PrintSetup(*s990);
 			}
-			if (memory[BASE_ADDR_990_SETUP_CARD] != UNDEFINED_MEMORY)
+			if (const SpecialSetup990 *s990 = image.CardSetup<AddressMap990>())
 			{
-				const SpecialSetup990 &s990 = *reinterpret_cast<const SpecialSetup990 *>(memory.data() + BASE_ADDR_990_SETUP_CARD);
-				std::cout << "Special setup (card): " << ToString(s990.common.name) << std::endl;
+				std::cout << "Special setup (card): " << ToString(s990->common.name) << std::endl;
 				if (verbose)
-					PrintSetup(s990);
+					PrintSetup(*s990);
 			}
-			if (memory[BASE_ADDR_990_SETUP_TEMPORARY] != UNDEFINED_MEMORY)
+			if (const SpecialSetup990 *s990 = image.TemporarySetup<AddressMap990>())
 			{
-				const SpecialSetup990 &s990 = *reinterpret_cast<const SpecialSetup990 *>(memory.data() + BASE_ADDR_990_SETUP_TEMPORARY);
-				std::cout << "Special setup (temporary): " << ToString(s990.common.name) << std::endl;
+				std::cout << "Special setup (temporary): " << ToString(s990->common.name) << std::endl;
 				if (verbose)
-					PrintSetup(s990);
+					PrintSetup(*s990);
 			}
 		}
+
+		// JX-8P tones are also listed if the file mainly contains JD-800 or JD-990 data
+		for (const JX8PPatch &patch : jx8p.patches)
+		{
+			std::cout << "JX-8P tone (channel " << (patch.channel + 1) << "): " << patch.Name() << std::endl;
+			if (verbose)
+				std::cout << "\tParameters: " << patch.ParameterString() << std::endl;
+		}
+		if (jx8p.numMalformed)
+			std::cout << "WARNING: Ignored " << jx8p.numMalformed << " malformed JX-8P tone messages" << std::endl;
+	}
+	else if (verb == "validate")
+	{
+		uint32_t numValidated = 0, numInvalid = 0;
+		const auto validate = [&numValidated, &numInvalid](std::string_view patchIndex, std::string_view name, const auto &patch)
+		{
+			numValidated++;
+			if (!IsPatchValid(patch) && !PrintValidationIssues(patchIndex, name, ValidatePatch(patch)))
+				numInvalid++;
+		};
+
+		if (sourceDeviceType == DeviceType::JD800)
+		{
+			image.ForEachInternalPatch<AddressMap800>([&validate](const uint32_t patch, const Patch800 &p800)
+			{
+				validate(GetPatchIndex(patch, DeviceImage::NUM_PATCHES), ToString(p800.common.name), p800);
+			});
+			for (const auto &p800 : temporaryPatches800)
+				validate("Temporary patch", ToString(p800.common.name), p800);
+			if (const SpecialSetup800 *s800 = image.InternalSetup<AddressMap800>())
+				validate("Special setup (internal)", "JD-800 Drum Set", *s800);
+			if (const SpecialSetup800 *s800 = image.TemporarySetup<AddressMap800>())
+				validate("Special setup (temporary)", "JD-800 Drum Set", *s800);
+		}
+		else if (sourceDeviceType == DeviceType::JD990)
+		{
+			image.ForEachInternalPatch<AddressMap990>([&validate](const uint32_t patch, const Patch990 &p990)
+			{
+				validate(GetPatchIndex(patch, DeviceImage::NUM_PATCHES), ToString(p990.common.name), p990);
+			});
+			image.ForEachCardPatch<AddressMap990>([&validate](const uint32_t patch, const Patch990 &p990)
+			{
+				validate(GetPatchIndex(patch, DeviceImage::NUM_PATCHES, true), ToString(p990.common.name), p990);
+			});
+			for (const auto &p990 : temporaryPatches990)
+				validate("Temporary patch", ToString(p990.common.name), p990);
+			if (const SpecialSetup990 *s990 = image.InternalSetup<AddressMap990>())
+				validate("Special setup (internal)", ToString(s990->common.name), *s990);
+			if (const SpecialSetup990 *s990 = image.CardSetup<AddressMap990>())
+				validate("Special setup (card)", ToString(s990->common.name), *s990);
+			if (const SpecialSetup990 *s990 = image.TemporarySetup<AddressMap990>())
+				validate("Special setup (temporary)", ToString(s990->common.name), *s990);
+		}
+		else if (sourceDeviceType == DeviceType::JD800VST)
+		{
+			const uint32_t numPatches = static_cast<uint32_t>(vstPatches.size());
+			for (uint32_t patch = 0; patch < numPatches; patch++)
+				validate(GetPatchIndex(patch, numPatches), ToString(vstPatches[patch].name), vstPatches[patch]);
+		}
+
+		if (numInvalid)
+		{
+			std::cout << numInvalid << " of " << numValidated << " patches contained invalid parameters!" << std::endl;
+			return 3;
+		}
+		std::cout << numValidated << " patches validated without errors." << std::endl;
+	}
+	else if (verb == "roundtrip")
+	{
+		RoundTripInput input;
+		if (sourceDeviceType == DeviceType::JD800)
+		{
+			image.ForEachInternalPatch<AddressMap800>([&input](const uint32_t, const Patch800 &p800) { input.patches800.push_back(p800); });
+			input.patches800.insert(input.patches800.end(), temporaryPatches800.begin(), temporaryPatches800.end());
+			if (const SpecialSetup800 *s800 = image.InternalSetup<AddressMap800>())
+				input.setups800.push_back(*s800);
+			if (const SpecialSetup800 *s800 = image.TemporarySetup<AddressMap800>())
+				input.setups800.push_back(*s800);
+		}
+		else if (sourceDeviceType == DeviceType::JD990)
+		{
+			image.ForEachInternalPatch<AddressMap990>([&input](const uint32_t, const Patch990 &p990) { input.patches990.push_back(p990); });
+			image.ForEachCardPatch<AddressMap990>([&input](const uint32_t, const Patch990 &p990) { input.patches990.push_back(p990); });
+			input.patches990.insert(input.patches990.end(), temporaryPatches990.begin(), temporaryPatches990.end());
+			if (const SpecialSetup990 *s990 = image.InternalSetup<AddressMap990>())
+				input.setups990.push_back(*s990);
+			if (const SpecialSetup990 *s990 = image.CardSetup<AddressMap990>())
+				input.setups990.push_back(*s990);
+			if (const SpecialSetup990 *s990 = image.TemporarySetup<AddressMap990>())
+				input.setups990.push_back(*s990);
+		}
+		else if (sourceDeviceType == DeviceType::JD800VST)
+		{
+			input.patchesVST.assign(vstPatches.begin(), vstPatches.end());
+		}
+		return RoundTrip(input, jsonFilename);
+	}
+	else if (verb == "export")
+	{
+		const std::string outFilename = argv[4];
+		std::ofstream outFile{outFilename, std::ios::trunc | std::ios::binary};
+		if (!outFile)
+		{
+			std::cout << "Could not open " << outFilename << " for writing!" << std::endl;
+			return 2;
+		}
+
+		ArrowPatchWriter writer{outFile};
+		if (sourceDeviceType == DeviceType::JD800)
+		{
+			image.ForEachInternalPatch<AddressMap800>([&writer](const uint32_t patch, const Patch800 &p800) { writer.Add(GetPatchIndex(patch, DeviceImage::NUM_PATCHES), p800); });
+			for (const auto &p800 : temporaryPatches800)
+				writer.Add("Temporary patch", p800);
+		}
+		else if (sourceDeviceType == DeviceType::JD990)
+		{
+			image.ForEachInternalPatch<AddressMap990>([&writer](const uint32_t patch, const Patch990 &p990) { writer.Add(GetPatchIndex(patch, DeviceImage::NUM_PATCHES), p990); });
+			image.ForEachCardPatch<AddressMap990>([&writer](const uint32_t patch, const Patch990 &p990) { writer.Add(GetPatchIndex(patch, DeviceImage::NUM_PATCHES, true), p990); });
+			for (const auto &p990 : temporaryPatches990)
+				writer.Add("Temporary patch", p990);
+		}
+		else if (sourceDeviceType == DeviceType::JD800VST)
+		{
+			const uint32_t numPatches = static_cast<uint32_t>(vstPatches.size());
+			for (uint32_t patch = 0; patch < numPatches; patch++)
+				writer.Add(GetPatchIndex(patch, numPatches), vstPatches[patch]);
+		}
+
+		if (!writer.Finish())
+		{
+			std::cout << "Could not write " << outFilename << "!" << std::endl;
+			return 2;
+		}
+		std::cout << "Exported " << writer.NumRows() << " patches." << std::endl;
 	}
 
 	return 0;
 }
+
+int main(int argc, char *argv[])
+{
+	static_assert(sizeof(Patch800) == 384);
+	static_assert(sizeof(Patch990) == 486);
+	static_assert(sizeof(PatchVST) == 2032);
+	static_assert(sizeof(SpecialSetup800) == 5378);
+	static_assert(sizeof(SpecialSetup990) == 6524);
+
+	// Global options may appear anywhere, remove them before parsing the command
+	bool printStats = false;
+	std::string_view statsFilename, traceFilename;
+	int numArgs = 1;
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string_view arg = argv[i];
+		if (arg == "--stats")
+		{
+			printStats = true;
+		}
+		else if (arg == "--stats-json" && i + 1 < argc)
+		{
+			statsFilename = argv[++i];
+		}
+		else if (arg == "--trace" && i + 1 < argc)
+		{
+			traceFilename = argv[++i];
+		}
+		else
+		{
+			argv[numArgs++] = argv[i];
+		}
+	}
+	argc = numArgs;
+	Stats::Enable(printStats || !statsFilename.empty());
+	Trace::Enable(!traceFilename.empty());
+
+	int result = RunVerb(argc, argv);
+
+	if (Stats::IsEnabled())
+	{
+		const StatsSnapshot stats = Stats::Get();
+		if (printStats)
+			Stats::Print(std::cout, stats);
+		if (!statsFilename.empty() && !Stats::WriteJSON(statsFilename, stats))
+		{
+			std::cout << "Could not write " << statsFilename << "!" << std::endl;
+			if (!result)
+				result = 2;
+		}
+	}
+	if (!traceFilename.empty() && !Trace::WriteJSON(traceFilename))
+	{
+		std::cout << "Could not write " << traceFilename << "!" << std::endl;
+		if (!result)
+			result = 2;
+	}
+
+	return result;
+}
@@ -4,10 +4,13 @@
 
 #pragma once
 
+#include <cstdint>
+#include <memory_resource>
 #include <vector>
 
 struct Patch800;
 struct Patch990;
+struct Tone800;
 struct PatchVST;
 struct SpecialSetup800;
 struct SpecialSetup990;
@@ -18,12 +21,17 @@ void ConvertPatch990To800(const Patch990 &p990, Patch800 &p800);
 void ConvertPatch800ToVST(const Patch800 &p800, PatchVST &pVST);
 void ConvertPatchVSTTo800(const PatchVST &pVST, Patch800 &p800);
 
+// Converts a single tone into an already converted patch, leaving all patch-level parameters and other tones untouched
+void ConvertPatchTone800ToVST(const Tone800 &t800, bool enabled, bool selected, uint8_t tone, PatchVST &pVST);
+// Recalculates the precomputed sections of a patch from its parameters, e.g. after they have been edited
+void UpdatePrecomputedVST(PatchVST &pVST);
+
 struct SpecialSetup800;
 struct SpecialSetup990;
 
 void ConvertSetup800To990(const SpecialSetup800 &s800, SpecialSetup990 &s990);
 void ConvertSetup990To800(const SpecialSetup990 &s990, SpecialSetup800 &s800);
-std::vector<PatchVST> ConvertSetup800ToVST(const SpecialSetup800 &s800);
+std::pmr::vector<PatchVST> ConvertSetup800ToVST(const SpecialSetup800 &s800, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
 
 void PrintPatch(const Patch800 &patch);
 void PrintPatch(const Patch990 &patch);
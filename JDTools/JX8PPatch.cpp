@@ -1,34 +1,60 @@
-#include "JX8PPatch.h"
-#include <sstream>
-#include <iomanip>
-
-bool JX8PPatch::IsValidSysex(const std::vector<uint8_t>& syx, size_t offset) {
-    if (offset + 32 > syx.size()) return false;
-    // Check Roland ID: F0 41 ...
-    return syx[offset] == 0xF0 && syx[offset + 1] == 0x41;
-}
-
-std::vector<JX8PPatch> JX8PPatch::ExtractFromSysex(const std::vector<uint8_t>& syx) {
-    std::vector<JX8PPatch> patches;
-    size_t pos = 0;
-    while (pos < syx.size()) {
-        if (IsValidSysex(syx, pos)) {
-            JX8PPatch patch;
-            std::copy(syx.begin() + pos + 6, syx.begin() + pos + 6 + 32, patch.data);
-            patches.push_back(patch);
-            pos += 6 + 32 + 1; // header + data + F7
-        } else {
-            ++pos;
-        }
-    }
-    return patches;
-}
-
-std::string JX8PPatch::DebugString() const {
-    std::ostringstream oss;
-    oss << "JX8P Patch Data:\n";
-    for (int i = 0; i < 32; ++i) {
-        oss << std::hex << std::setw(2) << std::setfill('0') << int(data[i]) << " ";
-    }
-    return oss.str();
-}
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "JX8PPatch.hpp"
+
+#include <algorithm>
+
+std::string JX8PPatch::ParameterString() const
+{
+	std::string str;
+	str.reserve(Parameters().size() * 4);
+	for (const uint8_t value : Parameters())
+	{
+		if (!str.empty())
+			str += ' ';
+		str.append(std::to_string(value));
+	}
+	return str;
+}
+
+bool IsJX8PMessage(std::span<const uint8_t> message) noexcept
+{
+	return message.size() >= JX8PPatch::HEADER_SIZE - 1
+		&& message[0] == 0x41
+		&& (message[1] == JX8PPatch::APR_OPCODE || message[1] == JX8PPatch::IPR_OPCODE)
+		&& message[2] < 0x10
+		&& message[3] == JX8PPatch::FORMAT_TYPE
+		&& message[4] == JX8PPatch::LEVEL;
+}
+
+JX8PScan ExtractJX8PPatches(std::span<const uint8_t> buffer, std::span<const SysExFrame> frames)
+{
+	JX8PScan scan;
+	for (const SysExFrame &frame : frames)
+	{
+		if (frame.offset > buffer.size() || frame.size > buffer.size() - frame.offset)
+			continue;
+
+		const auto message = buffer.subspan(frame.offset, frame.size);
+		if (!IsJX8PMessage(message) || message[1] != JX8PPatch::APR_OPCODE)
+			continue;
+
+		// Header, tone data and EOX
+		if (message.size() != JX8PPatch::HEADER_SIZE + JX8PPatch::DATA_SIZE + 1 || message[5] != JX8PPatch::TONE_GROUP || message.back() != 0xF7)
+		{
+			scan.numMalformed++;
+			continue;
+		}
+
+		const auto data = message.subspan<JX8PPatch::HEADER_SIZE, JX8PPatch::DATA_SIZE>();
+		if (std::any_of(data.begin(), data.end(), [](const uint8_t value) { return value >= 0x80; }))
+		{
+			scan.numMalformed++;
+			continue;
+		}
+		scan.patches.push_back({message[2], data});
+	}
+	return scan;
+}
@@ -0,0 +1,51 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include "SysEx.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// A Roland JX-8P tone, as sent in an APR (All Parameters) message whenever a tone is selected on the synthesizer:
+// F0 41 35 0n 21 20 01 <tone name, 10 bytes> <tone parameters, 49 bytes> F7
+// This is only a view of the message data, which must outlive it.
+struct JX8PPatch
+{
+	static constexpr uint8_t APR_OPCODE = 0x35;
+	static constexpr uint8_t IPR_OPCODE = 0x36;   // Individual parameter change
+	static constexpr uint8_t FORMAT_TYPE = 0x21;  // JX-8P
+	static constexpr uint8_t LEVEL = 0x20;
+	static constexpr uint8_t TONE_GROUP = 0x01;
+	static constexpr size_t HEADER_SIZE = 6;      // Without F0
+	static constexpr size_t NAME_SIZE = 10;
+	static constexpr size_t DATA_SIZE = 59;
+
+	uint8_t channel;  // 0-based MIDI channel
+	std::span<const uint8_t, DATA_SIZE> data;
+
+	std::string_view Name() const noexcept { return {reinterpret_cast<const char *>(data.data()), NAME_SIZE}; }
+	std::span<const uint8_t> Parameters() const noexcept { return data.subspan<NAME_SIZE>(); }
+
+	// Parameter values in message order, separated by spaces
+	std::string ParameterString() const;
+};
+
+struct JX8PScan
+{
+	std::vector<JX8PPatch> patches;
+	size_t numMalformed = 0;  // JX-8P APR messages that are truncated, too long or contain invalid data bytes
+};
+
+// Returns true if a framed SysEx message (without F0) has the header of any JX-8P message, e.g. APR or IPR
+bool IsJX8PMessage(std::span<const uint8_t> message) noexcept;
+
+// Looks at each framed SysEx message once (see InputFile::ReadAllSysExMessages) and returns views of all JX-8P tones in file order.
+// Messages of other devices are skipped, so that mixed archives can be scanned alongside the JD-800 / JD-990 messages.
+JX8PScan ExtractJX8PPatches(std::span<const uint8_t> buffer, std::span<const SysExFrame> frames);
@@ -0,0 +1,262 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "ListNames.hpp"
+#include "DeviceImage.hpp"
+#include "InputFile.hpp"
+#include "JX8PPatch.hpp"
+#include "SVZ.hpp"
+#include "SysEx.hpp"
+#include "Trace.hpp"
+#include "Utils.hpp"
+
+#include "JD-800.hpp"
+#include "JD-990.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace
+{
+	static_assert(offsetof(Patch800, common) == 0 && offsetof(Patch800::Common, name) == 0);
+	static_assert(offsetof(Patch990, common) == 0 && offsetof(Patch990::Common, name) == 0);
+	static_assert(offsetof(SpecialSetup990, common) == 0 && offsetof(SpecialSetup990::Common, name) == 0);
+
+	// All named objects start with their name, so an object is present if the first byte of its name has been written.
+	// This is the same criterion that the device image uses.
+	struct NamedObject
+	{
+		bool present = false;
+		std::array<char, 16> name;
+
+		NamedObject() { name.fill(' '); }
+
+		// Copies the part of the name that overlaps with the data of a Data Set message
+		void Add(const uint32_t address, const uint8_t *data, const size_t size, const uint32_t nameAddress)
+		{
+			const uint64_t end = uint64_t(address) + size, nameEnd = uint64_t(nameAddress) + name.size();
+			const uint64_t first = std::max(uint64_t(address), uint64_t(nameAddress)), last = std::min(end, nameEnd);
+			if (first >= last)
+				return;
+			std::copy(data + (first - address), data + (last - address), name.begin() + (first - nameAddress));
+			if (nameAddress >= address)
+				present = true;
+		}
+	};
+
+	// Collects the names of all patches and special setups of one device from its Data Set messages
+	template<typename Map>
+	class NameCollector
+	{
+	public:
+		void Add(const uint32_t address, const uint8_t *data, const size_t size)
+		{
+			AddPatches(m_internalPatches, Map::PATCH_INTERNAL, address, data, size);
+			if constexpr (Map::HAS_CARD)
+				AddPatches(m_cardPatches, Map::PATCH_CARD, address, data, size);
+
+			m_temporaryPatch.Add(address, data, size, Map::PATCH_TEMPORARY);
+			// Same as the full listing: A temporary patch is complete once its second message has been received
+			if (address == Map::PATCH_TEMPORARY + 256 && m_temporaryPatch.present)
+				m_temporaryPatchNames.push_back(m_temporaryPatch.name);
+
+			m_internalSetup.Add(address, data, size, Map::SETUP_INTERNAL);
+			m_temporarySetup.Add(address, data, size, Map::SETUP_TEMPORARY);
+			if constexpr (Map::HAS_CARD)
+				m_cardSetup.Add(address, data, size, Map::SETUP_CARD);
+		}
+
+		void Print() const
+		{
+			std::cout << "Format: " << (Map::IS_JD990 ? "JD-990" : "JD-800") << std::endl;
+			for (uint32_t patch = 0; patch < DeviceImage::NUM_PATCHES; patch++)
+			{
+				if (m_internalPatches[patch].present)
+					std::cout << GetPatchIndex(patch, DeviceImage::NUM_PATCHES) << ": " << ToString(m_internalPatches[patch].name) << std::endl;
+			}
+			for (uint32_t patch = 0; patch < DeviceImage::NUM_PATCHES; patch++)
+			{
+				if (m_cardPatches[patch].present)
+					std::cout << GetPatchIndex(patch, DeviceImage::NUM_PATCHES, true) << ": " << ToString(m_cardPatches[patch].name) << std::endl;
+			}
+
+			if (m_temporaryPatch.present)
+			{
+				for (const auto &name : m_temporaryPatchNames)
+					std::cout << "Temporary patch: " << ToString(name) << std::endl;
+			}
+
+			// JD-800 special setups have no name
+			const auto setupName = [](const NamedObject &setup) { return Map::IS_JD990 ? ToString(setup.name) : std::string_view{"JD-800 Drum Set"}; };
+			if (m_internalSetup.present)
+				std::cout << "Special setup (internal): " << setupName(m_internalSetup) << std::endl;
+			if (m_cardSetup.present)
+				std::cout << "Special setup (card): " << setupName(m_cardSetup) << std::endl;
+			if (m_temporarySetup.present)
+				std::cout << "Special setup (temporary): " << setupName(m_temporarySetup) << std::endl;
+		}
+
+	private:
+		using PatchSlots = std::array<NamedObject, DeviceImage::NUM_PATCHES>;
+
+		static void AddPatches(PatchSlots &slots, const uint32_t base, const uint32_t address, const uint8_t *data, const size_t size)
+		{
+			const uint64_t end = uint64_t(address) + size;
+			if (end <= base || address >= base + uint64_t(Map::PATCH_STRIDE) * DeviceImage::NUM_PATCHES)
+				return;
+
+			// A message is never longer than a patch, so it can only touch the names of very few slots
+			uint32_t index = (address > base) ? (address - base) / Map::PATCH_STRIDE : 0;
+			for (; index < DeviceImage::NUM_PATCHES && base + uint64_t(index) * Map::PATCH_STRIDE < end; index++)
+			{
+				slots[index].Add(address, data, size, base + index * Map::PATCH_STRIDE);
+			}
+		}
+
+		PatchSlots m_internalPatches, m_cardPatches;
+		NamedObject m_temporaryPatch, m_internalSetup, m_cardSetup, m_temporarySetup;
+		std::vector<std::array<char, 16>> m_temporaryPatchNames;
+	};
+
+	int ListSysExNames(InputFile &inputFile)
+	{
+		std::vector<uint8_t> buffer;
+		std::vector<SysExFrame> frames;
+		inputFile.ReadAllSysExMessages(buffer, frames);
+
+		// The first JD-800 or JD-990 message decides which device's messages are processed, like in the full listing
+		std::optional<bool> isJD990;
+		NameCollector<AddressMap800> names800;
+		NameCollector<AddressMap990> names990;
+		for (const SysExFrame &frame : frames)
+		{
+			const uint8_t *message = buffer.data() + frame.offset;
+			if (frame.size < 6)
+			{
+				std::cout << "Ignoring SysEx message: Too short" << std::endl;
+				continue;
+			}
+
+			if (message[0] != 0x41)
+			{
+				std::cout << "Ignoring SysEx message: Not a Roland device" << std::endl;
+				continue;
+			}
+
+			// JX-8P tones are extracted in a separate pass over the same frames
+			if (IsJX8PMessage({message, frame.size}))
+				continue;
+
+			if (message[2] != AddressMap800::MODEL_ID && message[2] != AddressMap990::MODEL_ID)
+			{
+				std::cout << "Ignoring SysEx message: Not a JD-800 or JD-990 message" << std::endl;
+				continue;
+			}
+
+			const bool messageIsJD990 = (message[2] == AddressMap990::MODEL_ID);
+			if (isJD990 && *isJD990 != messageIsJD990)
+			{
+				std::cout << "WARNING: File contains mixed JD-800 and JD-990 dumps. Only " << (*isJD990 ? "JD-990" : "JD-800") << " dumps will be processed." << std::endl;
+				continue;
+			}
+			isJD990 = messageIsJD990;
+
+			if (message[3] != 0x12)
+			{
+				std::cout << "Ignoring SysEx message: Not a Data Set message" << std::endl;
+				continue;
+			}
+
+			// Address, data and checksum, without EOX
+			if (RolandChecksum(message + 4, frame.size - 5) != 0)
+			{
+				std::cerr << "Invalid SysEx checksum!" << std::endl;
+				return 3;
+			}
+
+			const uint32_t addressBytes = messageIsJD990 ? AddressMap990::ADDRESS_BYTES : AddressMap800::ADDRESS_BYTES;
+			if (frame.size - 2 < 4 + addressBytes)
+			{
+				std::cerr << "WARNING! Skipping SysEx, too short!" << std::endl;
+				continue;
+			}
+
+			uint32_t address = 0;
+			for (uint32_t i = 0; i < addressBytes; i++)
+			{
+				address = (address << 7) | message[4 + i];
+			}
+
+			const uint8_t *data = message + 4 + addressBytes;
+			const size_t dataSize = frame.size - 6 - addressBytes;
+			if (messageIsJD990)
+				names990.Add(address, data, dataSize);
+			else
+				names800.Add(address, data, dataSize);
+		}
+
+		const JX8PScan jx8p = ExtractJX8PPatches(buffer, frames);
+		if (!isJD990 && jx8p.patches.empty())
+		{
+			std::cout << "Input didn't contain any SysEx messages for either JD-800 or JD-990!" << std::endl;
+			return 2;
+		}
+
+		if (!isJD990)
+			std::cout << "Format: JX-8P" << std::endl;
+		else if (*isJD990)
+			names990.Print();
+		else
+			names800.Print();
+
+		for (const JX8PPatch &patch : jx8p.patches)
+		{
+			std::cout << "JX-8P tone (channel " << (patch.channel + 1) << "): " << patch.Name() << std::endl;
+		}
+		if (jx8p.numMalformed)
+			std::cout << "WARNING: Ignored " << jx8p.numMalformed << " malformed JX-8P tone messages" << std::endl;
+		return 0;
+	}
+
+	int ListVSTNames(std::istream &inFile, const InputFile::Type type)
+	{
+		std::vector<std::string> names;
+		const auto addName = [&names](std::string_view name) { names.emplace_back(name); };
+		const bool success = (type == InputFile::Type::SVD) ? ReadSVDNames(inFile, addName) : ReadSVZNames(inFile, addName);
+		if (!success || names.empty())
+			return 2;
+
+		std::cout << "Format: JD-800 VST / JD-08 / ZC1" << std::endl;
+		const uint32_t numPatches = static_cast<uint32_t>(names.size());
+		for (uint32_t patch = 0; patch < numPatches; patch++)
+		{
+			std::cout << GetPatchIndex(patch, numPatches) << ": " << names[patch] << std::endl;
+		}
+		return 0;
+	}
+}
+
+int ListPatchNames(std::string_view filename)
+{
+	const std::string inFilename{filename};
+	TraceScope fileScope{"file", "input file", inFilename};
+	std::ifstream inFile{inFilename, std::ios::binary};
+	if (!inFile)
+	{
+		std::cout << "Could not open " << inFilename << " for reading!" << std::endl;
+		return 2;
+	}
+
+	InputFile inputFile{inFile};
+	if (inputFile.GetType() == InputFile::Type::SYX || inputFile.GetType() == InputFile::Type::MID)
+		return ListSysExNames(inputFile);
+	else
+		return ListVSTNames(inFile, inputFile.GetType());
+}
@@ -0,0 +1,11 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <string_view>
+
+// Prints the same patch and special setup names as the list verb, but only looks at the name bytes:
+// SysEx Data Set messages are not stored in a device image, and of BIN / SVZ / SVD files only the names are read.
+int ListPatchNames(std::string_view filename);
@@ -0,0 +1,83 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "MidiFile.hpp"
+#include "Stats.hpp"
+
+#include <array>
+#include <ostream>
+
+namespace
+{
+	// At the default tempo of 120 BPM, 480 ticks per quarter note results in roughly one tick per millisecond
+	constexpr uint16_t TICKS_PER_QUARTER = 480;
+	// Both synths need some time to process a Data Set message, so leave a gap of about 50ms between messages
+	constexpr uint32_t SYSEX_DELAY_TICKS = 48;
+	// The track length field is written after the track data starts
+	constexpr std::streamoff TRACK_LENGTH_OFFSET = 14 + 4;
+}
+
+MidiFileWriter::MidiFileWriter(std::ostream &file)
+	: m_file{file}
+{
+	static constexpr std::array<char, 14> header = {'M', 'T', 'h', 'd', 0, 0, 0, 6, 0, 0, 0, 1, static_cast<char>(TICKS_PER_QUARTER >> 8), static_cast<char>(TICKS_PER_QUARTER & 0xFF)};
+	m_file.write(header.data(), header.size());
+	m_file.write("MTrk", 4);
+	WriteUint32BE(0);  // Updated in Finish()
+}
+
+void MidiFileWriter::WriteSysEx(const std::vector<uint8_t> &message)
+{
+	StageTimer timer{Stage::Write};
+	if (message.size() < 2)
+		return;
+
+	WriteVarInt(m_firstMessage ? 0 : SYSEX_DELAY_TICKS);
+	m_firstMessage = false;
+	m_file.put(static_cast<char>(0xF0));
+	m_trackLength++;
+	// The length covers everything after F0, including the terminating F7
+	WriteVarInt(static_cast<uint32_t>(message.size() - 1));
+	m_file.write(reinterpret_cast<const char *>(message.data() + 1), message.size() - 1);
+	m_trackLength += message.size() - 1;
+}
+
+bool MidiFileWriter::Finish()
+{
+	StageTimer timer{Stage::Write};
+	static constexpr std::array<char, 4> endOfTrack = {0, static_cast<char>(0xFF), 0x2F, 0};
+	m_file.write(endOfTrack.data(), endOfTrack.size());
+	m_trackLength += endOfTrack.size();
+	if (m_trackLength > UINT32_MAX)
+		return false;
+
+	m_file.seekp(TRACK_LENGTH_OFFSET);
+	WriteUint32BE(static_cast<uint32_t>(m_trackLength));
+	m_file.seekp(0, std::ios::end);
+	Stats::Add(Counter::BytesWritten, TRACK_LENGTH_OFFSET + 4 + m_trackLength);
+	return static_cast<bool>(m_file);
+}
+
+void MidiFileWriter::WriteVarInt(uint32_t value)
+{
+	std::array<char, 5> bytes{};
+	size_t numBytes = 0;
+	do
+	{
+		bytes[numBytes++] = static_cast<char>(value & 0x7F);
+		value >>= 7;
+	} while (value);
+	// Most significant group first, all but the last byte have the continuation bit set
+	for (size_t i = numBytes; i > 0; i--)
+	{
+		m_file.put(static_cast<char>(bytes[i - 1] | (i > 1 ? 0x80 : 0x00)));
+	}
+	m_trackLength += numBytes;
+}
+
+void MidiFileWriter::WriteUint32BE(const uint32_t value)
+{
+	const std::array<char, 4> bytes = {static_cast<char>(value >> 24), static_cast<char>(value >> 16), static_cast<char>(value >> 8), static_cast<char>(value)};
+	m_file.write(bytes.data(), bytes.size());
+}
@@ -0,0 +1,30 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// Writes a Standard MIDI File (format 0) consisting of SysEx messages only.
+// The track length is only known at the end, so Finish() must be called after the last message.
+class MidiFileWriter
+{
+public:
+	explicit MidiFileWriter(std::ostream &file);
+
+	// Adds a complete SysEx message (F0 ... F7), spaced apart from the previous message so that the receiving device can keep up
+	void WriteSysEx(const std::vector<uint8_t> &message);
+	// Writes the end of track event and updates the track length. Returns false if the track became too large for a MIDI file.
+	bool Finish();
+
+private:
+	void WriteVarInt(uint32_t value);
+	void WriteUint32BE(uint32_t value);
+
+	std::ostream &m_file;
+	uint64_t m_trackLength = 0;
+	bool m_firstMessage = true;
+};
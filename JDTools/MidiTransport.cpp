@@ -0,0 +1,151 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "MidiTransport.hpp"
+
+#include <charconv>
+#include <fstream>
+#include <iostream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#if __has_include(<sound/asound.h>)
+#include <sound/asound.h>
+#endif
+#endif
+
+namespace
+{
+	class FileTransport final : public MidiTransport
+	{
+	public:
+		FileTransport(std::string_view filename)
+			: m_filename{filename}
+			, m_file{m_filename, std::ios::trunc | std::ios::binary}
+		{
+		}
+
+		bool IsOpen() const { return m_file.is_open(); }
+
+		bool Write(std::span<const uint8_t> data) override
+		{
+			m_file.write(reinterpret_cast<const char *>(data.data()), data.size());
+			// Flushed right away, so that a program reading from a pipe sees each message at the time it is sent
+			m_file.flush();
+			return m_file.good();
+		}
+
+		std::string Description() const override { return "file " + m_filename; }
+
+	private:
+		std::string m_filename;
+		std::ofstream m_file;
+	};
+
+#ifdef __linux__
+	// Writes to the raw MIDI device of the ALSA kernel driver directly, so that the ALSA library is not required
+	class RawMidiTransport final : public MidiTransport
+	{
+	public:
+		RawMidiTransport(std::string_view port, std::string device)
+			: m_port{port}
+			, m_device{std::move(device)}
+		{
+			m_fd = open(m_device.c_str(), O_WRONLY | O_CLOEXEC);
+		}
+
+		~RawMidiTransport() override
+		{
+			if (m_fd >= 0)
+				close(m_fd);
+		}
+
+		RawMidiTransport(const RawMidiTransport &) = delete;
+		RawMidiTransport &operator=(const RawMidiTransport &) = delete;
+
+		bool IsOpen() const { return m_fd >= 0; }
+		const std::string &Device() const { return m_device; }
+
+		bool Write(std::span<const uint8_t> data) override
+		{
+			while (!data.empty())
+			{
+				const ssize_t written = write(m_fd, data.data(), data.size());
+				if (written < 0 && errno == EINTR)
+					continue;
+				if (written <= 0)
+					return false;
+				data = data.subspan(static_cast<size_t>(written));
+			}
+			return true;
+		}
+
+		void Drain() override
+		{
+#ifdef SNDRV_RAWMIDI_IOCTL_DRAIN
+			int stream = SNDRV_RAWMIDI_STREAM_OUTPUT;
+			ioctl(m_fd, SNDRV_RAWMIDI_IOCTL_DRAIN, &stream);
+#endif
+		}
+
+		std::string Description() const override { return "MIDI port " + m_port; }
+
+	private:
+		std::string m_port, m_device;
+		int m_fd = -1;
+	};
+#endif
+
+	bool ParseIndex(std::string_view str, uint32_t &value)
+	{
+		const auto [ptr, ec] = std::from_chars(str.data(), str.data() + str.size(), value);
+		return !str.empty() && ec == std::errc{} && ptr == str.data() + str.size();
+	}
+}
+
+std::unique_ptr<MidiTransport> OpenMidiTransport(std::string_view port)
+{
+	if (port.starts_with("file:"))
+	{
+		const std::string_view filename = port.substr(5);
+		auto transport = std::make_unique<FileTransport>(filename);
+		if (!transport->IsOpen())
+		{
+			std::cout << "Could not open " << filename << " for writing!" << std::endl;
+			return nullptr;
+		}
+		return transport;
+	}
+
+	if (port.starts_with("hw:"))
+	{
+		const std::string_view address = port.substr(3);
+		const size_t comma = address.find(',');
+		uint32_t card = 0, device = 0;
+		if (comma == std::string_view::npos || !ParseIndex(address.substr(0, comma), card) || !ParseIndex(address.substr(comma + 1), device))
+		{
+			std::cout << "MIDI port " << port << " must be specified as hw:<card>,<device>, e.g. hw:1,0!" << std::endl;
+			return nullptr;
+		}
+#ifdef __linux__
+		auto transport = std::make_unique<RawMidiTransport>(port, "/dev/snd/midiC" + std::to_string(card) + "D" + std::to_string(device));
+		if (!transport->IsOpen())
+		{
+			std::cout << "Could not open MIDI port " << port << " (" << transport->Device() << "): " << std::strerror(errno) << std::endl;
+			return nullptr;
+		}
+		return transport;
+#else
+		std::cout << "ALSA MIDI ports are only available on Linux!" << std::endl;
+		return nullptr;
+#endif
+	}
+
+	std::cout << "Unknown MIDI port " << port << ", expected hw:<card>,<device> or file:<path>!" << std::endl;
+	return nullptr;
+}
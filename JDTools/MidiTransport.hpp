@@ -0,0 +1,30 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Destination of the bytes sent by the send verb. Transports only pass the bytes on, pacing is up to the caller.
+class MidiTransport
+{
+public:
+	virtual ~MidiTransport() = default;
+
+	// Returns false if the bytes could not be written
+	virtual bool Write(std::span<const uint8_t> data) = 0;
+	// Blocks until all written bytes have left the transport's buffer
+	virtual void Drain() {}
+
+	virtual std::string Description() const = 0;
+};
+
+// Opens a transport for a port specification. Prints an error message and returns nullptr if the port cannot be opened.
+//   hw:<card>,<device>  ALSA raw MIDI device (Linux only)
+//   file:<path>         Writes the bytes to a file instead, e.g. to check what would be sent
+std::unique_ptr<MidiTransport> OpenMidiTransport(std::string_view port);
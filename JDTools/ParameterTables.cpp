@@ -0,0 +1,107 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "ParameterTables.hpp"
+
+#include <iostream>
+#include <vector>
+
+namespace
+{
+	class SetupParameterGroups
+	{
+	public:
+		SetupParameterGroups(std::span<const ParameterInfo> common, std::span<const ParameterInfo> key, std::span<const ParameterInfo> tone, size_t keysOffset, size_t keySize, size_t toneOffset, size_t numKeys)
+		{
+			// Reserve up front, the groups keep views into the prefix strings
+			m_prefixes.reserve(numKeys * 2);
+			m_groups.reserve(1 + numKeys * 2);
+			m_groups.push_back({"", 0, common});
+			for (size_t i = 0; i < numKeys; i++)
+			{
+				const size_t offset = keysOffset + i * keySize;
+				const std::string &keyPrefix = m_prefixes.emplace_back("keys[" + std::to_string(i) + "].");
+				m_groups.push_back({keyPrefix, static_cast<uint16_t>(offset), key});
+				const std::string &tonePrefix = m_prefixes.emplace_back(keyPrefix + "tone.");
+				m_groups.push_back({tonePrefix, static_cast<uint16_t>(offset + toneOffset), tone});
+			}
+		}
+
+		std::span<const ParameterGroup> Groups() const noexcept { return m_groups; }
+
+	private:
+		std::vector<std::string> m_prefixes;
+		std::vector<ParameterGroup> m_groups;
+	};
+}
+
+template<> std::span<const ParameterGroup> ParameterGroups<SpecialSetup800>() noexcept
+{
+	static const SetupParameterGroups groups{SETUP800_PARAMETERS, SETUP800_KEY_PARAMETERS, TONE800_PARAMETERS, offsetof(SpecialSetup800, keys), sizeof(SpecialSetup800::Key), offsetof(SpecialSetup800::Key, tone), std::tuple_size_v<decltype(SpecialSetup800::keys)>};
+	return groups.Groups();
+}
+
+template<> std::span<const ParameterGroup> ParameterGroups<SpecialSetup990>() noexcept
+{
+	static const SetupParameterGroups groups{SETUP990_PARAMETERS, SETUP990_KEY_PARAMETERS, TONE990_PARAMETERS, offsetof(SpecialSetup990, keys), sizeof(SpecialSetup990::Key), offsetof(SpecialSetup990::Key, tone), std::tuple_size_v<decltype(SpecialSetup990::keys)>};
+	return groups.Groups();
+}
+
+int32_t GetParameter(const void *base, uint32_t offset, ParameterType type) noexcept
+{
+	const uint8_t *p = static_cast<const uint8_t *>(base) + offset;
+	switch (type)
+	{
+	case ParameterType::U8: return p[0];
+	case ParameterType::S8: return static_cast<int8_t>(p[0]);
+	case ParameterType::U16LE: return p[0] | (p[1] << 8);
+	case ParameterType::S16LE: return static_cast<int16_t>(p[0] | (p[1] << 8));
+	}
+	return 0;
+}
+
+void SetParameter(void *base, uint32_t offset, ParameterType type, int32_t value) noexcept
+{
+	uint8_t *p = static_cast<uint8_t *>(base) + offset;
+	p[0] = static_cast<uint8_t>(value);
+	if (type == ParameterType::U16LE || type == ParameterType::S16LE)
+		p[1] = static_cast<uint8_t>(value >> 8);
+}
+
+std::string ParameterPath(const ParameterGroup &group, const ParameterInfo &param)
+{
+	std::string path;
+	path.reserve(group.prefix.size() + param.name.size());
+	path += group.prefix;
+	path += param.name;
+	return path;
+}
+
+void PrintParameters(std::span<const ParameterGroup> groups, const void *patch)
+{
+	ForEachParameter(groups, patch, [](const ParameterGroup &group, const ParameterInfo &param, const int32_t value)
+	{
+		std::cout << group.prefix << param.name << ": " << (value - param.displayOffset) << "\n";
+	});
+}
+
+void ApplyMapping(std::span<const ParameterMapping> mappings, const void *src, void *dst) noexcept
+{
+	const uint8_t *s = static_cast<const uint8_t *>(src);
+	uint8_t *d = static_cast<uint8_t *>(dst);
+	for (const ParameterMapping &m : mappings)
+	{
+		d[m.dstOffset] = static_cast<uint8_t>(s[m.srcOffset] + m.delta);
+	}
+}
+
+void ApplyMappingReverse(std::span<const ParameterMapping> mappings, const void *src, void *dst) noexcept
+{
+	const uint8_t *s = static_cast<const uint8_t *>(src);
+	uint8_t *d = static_cast<uint8_t *>(dst);
+	for (const ParameterMapping &m : mappings)
+	{
+		d[m.srcOffset] = static_cast<uint8_t>(s[m.dstOffset] - m.delta);
+	}
+}
@@ -0,0 +1,878 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include "JD-800.hpp"
+#include "JD-990.hpp"
+#include "JD-08.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+enum class ParameterType : uint8_t
+{
+	U8,
+	S8,
+	U16LE,
+	S16LE,
+};
+
+// Description of a single parameter as stored in one of the patch structs
+struct ParameterInfo
+{
+	std::string_view name;  // Path of the struct member, e.g. "tvf.cutoffFreq"
+	uint16_t offset;        // Offset in the containing struct
+	ParameterType type;
+	int16_t minValue;
+	int16_t maxValue;
+	int16_t displayOffset;  // Subtracted from the stored value for display, e.g. 50 for -50...+50 parameters
+};
+
+// A set of parameters found at a given offset of a patch, e.g. one of its four tones
+struct ParameterGroup
+{
+	std::string_view prefix;
+	uint16_t offset;
+	std::span<const ParameterInfo> parameters;
+};
+
+// Parameter that is converted between two formats by adding a constant
+struct ParameterMapping
+{
+	uint16_t srcOffset;
+	uint16_t dstOffset;
+	int8_t delta;  // destination = source + delta
+};
+
+#define JDTOOLS_PARAM(Struct, member, type, minValue, maxValue, displayOffset) \
+	ParameterInfo{#member, static_cast<uint16_t>(offsetof(Struct, member)), ParameterType::type, minValue, maxValue, displayOffset}
+
+inline constexpr ParameterInfo TONE800_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(Tone800, common.velocityCurve, U8, 0, 3, -1),
+	JDTOOLS_PARAM(Tone800, common.holdControl, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, lfo1.rate, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, lfo1.delay, U8, 0, 101, 0),
+	JDTOOLS_PARAM(Tone800, lfo1.fade, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, lfo1.waveform, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Tone800, lfo1.offset, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone800, lfo1.keyTrigger, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, lfo2.rate, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, lfo2.delay, U8, 0, 101, 0),
+	JDTOOLS_PARAM(Tone800, lfo2.fade, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, lfo2.waveform, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Tone800, lfo2.offset, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone800, lfo2.keyTrigger, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, wg.waveSource, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, wg.waveformMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, wg.waveformLSB, U8, 0, 127, -1),
+	JDTOOLS_PARAM(Tone800, wg.pitchCoarse, U8, 0, 96, 48),
+	JDTOOLS_PARAM(Tone800, wg.pitchFine, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, wg.pitchRandom, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, wg.keyFollow, U8, 0, 16, 0),
+	JDTOOLS_PARAM(Tone800, wg.benderSwitch, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, wg.aTouchBend, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, wg.lfo1Sens, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, wg.lfo2Sens, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, wg.leverSens, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, wg.aTouchModSens, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, pitchEnv.velo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, pitchEnv.timeVelo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, pitchEnv.timeKF, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone800, pitchEnv.level0, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, pitchEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, pitchEnv.level1, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, pitchEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, pitchEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, pitchEnv.level2, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvf.filterMode, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone800, tvf.cutoffFreq, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvf.resonance, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvf.keyFollow, U8, 0, 50, 0),
+	JDTOOLS_PARAM(Tone800, tvf.aTouchSens, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvf.lfoSelect, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, tvf.lfoDepth, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvf.envDepth, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvfEnv.velo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvfEnv.timeVelo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvfEnv.timeKF, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone800, tvfEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvfEnv.level1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvfEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvfEnv.level2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvfEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvfEnv.sustainLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvfEnv.time4, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvfEnv.level4, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tva.biasDirection, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone800, tva.biasPoint, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Tone800, tva.biasLevel, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone800, tva.level, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tva.aTouchSens, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tva.lfoSelect, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone800, tva.lfoDepth, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvaEnv.velo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvaEnv.timeVelo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone800, tvaEnv.timeKF, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone800, tvaEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvaEnv.level1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvaEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvaEnv.level2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvaEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvaEnv.sustainLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone800, tvaEnv.time4, U8, 0, 100, 0),
+};
+
+inline constexpr ParameterInfo PATCH800_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(Patch800, common.patchLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeLowA, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeHighA, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeLowB, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeHighB, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeLowC, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeHighC, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeLowD, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.keyRangeHighD, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, common.benderRangeDown, U8, 0, 48, 0),
+	JDTOOLS_PARAM(Patch800, common.benderRangeUp, U8, 0, 12, 0),
+	JDTOOLS_PARAM(Patch800, common.aTouchBend, U8, 0, 26, 0),
+	JDTOOLS_PARAM(Patch800, common.soloSW, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, common.soloLegato, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, common.portamentoSW, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, common.portamentoMode, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, common.portamentoTime, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, common.layerTone, U8, 0, 15, 0),
+	JDTOOLS_PARAM(Patch800, common.activeTone, U8, 0, 15, 0),
+	JDTOOLS_PARAM(Patch800, eq.lowFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, eq.lowGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(Patch800, eq.midFreq, U8, 0, 16, 0),
+	JDTOOLS_PARAM(Patch800, eq.midQ, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Patch800, eq.midGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(Patch800, eq.highFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, eq.highGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(Patch800, midiTx.keyMode, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Patch800, midiTx.splitPoint, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch800, midiTx.lowerChannel, U8, 0, 16, -1),
+	JDTOOLS_PARAM(Patch800, midiTx.upperChannel, U8, 0, 16, -1),
+	JDTOOLS_PARAM(Patch800, midiTx.lowerProgramChange, U8, 0, 127, -1),
+	JDTOOLS_PARAM(Patch800, midiTx.upperProgramChange, U8, 0, 127, -1),
+	JDTOOLS_PARAM(Patch800, midiTx.holdMode, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupAsequence, U8, 0, 23, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupBsequence, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupAblockSwitch1, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupAblockSwitch2, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupAblockSwitch3, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupAblockSwitch4, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupBblockSwitch1, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupBblockSwitch2, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, effect.groupBblockSwitch3, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch800, effect.effectsBalanceGroupB, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.distortionType, U8, 0, 6, 0),
+	JDTOOLS_PARAM(Patch800, effect.distortionDrive, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.distortionLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.phaserManual, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch800, effect.phaserRate, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch800, effect.phaserDepth, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.phaserResonance, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.phaserMix, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.spectrumBand1, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch800, effect.spectrumBand2, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch800, effect.spectrumBand3, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch800, effect.spectrumBand4, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch800, effect.spectrumBand5, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch800, effect.spectrumBand6, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch800, effect.spectrumBandwidth, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Patch800, effect.enhancerSens, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.enhancerMix, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.delayCenterTap, U8, 0, 125, 0),
+	JDTOOLS_PARAM(Patch800, effect.delayCenterLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.delayLeftTap, U8, 0, 125, 0),
+	JDTOOLS_PARAM(Patch800, effect.delayLeftLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.delayRightTap, U8, 0, 125, 0),
+	JDTOOLS_PARAM(Patch800, effect.delayRightLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.delayFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(Patch800, effect.chorusRate, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch800, effect.chorusDepth, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.chorusDelayTime, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch800, effect.chorusFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(Patch800, effect.chorusLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.reverbType, U8, 0, 9, 0),
+	JDTOOLS_PARAM(Patch800, effect.reverbPreDelay, U8, 0, 120, 0),
+	JDTOOLS_PARAM(Patch800, effect.reverbEarlyRefLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.reverbHFDamp, U8, 0, 16, 0),
+	JDTOOLS_PARAM(Patch800, effect.reverbTime, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch800, effect.reverbLevel, U8, 0, 100, 0),
+};
+
+inline constexpr ParameterInfo TONE990_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(Tone990, wg.waveSource, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone990, wg.waveformMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone990, wg.waveformLSB, U8, 0, 127, -1),
+	JDTOOLS_PARAM(Tone990, wg.fxmColor, U8, 0, 3, -1),
+	JDTOOLS_PARAM(Tone990, wg.fxmDepth, U8, 0, 15, 0),
+	JDTOOLS_PARAM(Tone990, wg.syncSlaveSwitch, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone990, wg.toneDelayMode, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Tone990, wg.toneDelayTime, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Tone990, wg.pitchCoarse, U8, 0, 96, 48),
+	JDTOOLS_PARAM(Tone990, wg.pitchFine, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, wg.pitchRandom, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, wg.keyFollow, U8, 0, 16, 0),
+	JDTOOLS_PARAM(Tone990, wg.envDepth, U8, 0, 24, 12),
+	JDTOOLS_PARAM(Tone990, wg.benderSwitch, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone990, pitchEnv.velo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, pitchEnv.timeVelo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, pitchEnv.timeKF, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone990, pitchEnv.level0, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, pitchEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, pitchEnv.level1, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, pitchEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, pitchEnv.sustainLevel, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, pitchEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, pitchEnv.level3, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, tvf.filterMode, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone990, tvf.cutoffFreq, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvf.resonance, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvf.keyFollow, U8, 0, 50, 0),
+	JDTOOLS_PARAM(Tone990, tvf.envDepth, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, tvfEnv.velo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, tvfEnv.timeVelo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, tvfEnv.timeKF, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone990, tvfEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvfEnv.level1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvfEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvfEnv.level2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvfEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvfEnv.sustainLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvfEnv.time4, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvfEnv.level4, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tva.level, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tva.biasDirection, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone990, tva.biasPoint, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Tone990, tva.biasLevel, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone990, tva.pan, U8, 0, 103, 50),
+	JDTOOLS_PARAM(Tone990, tva.panKeyFollow, U8, 0, 14, 0),
+	JDTOOLS_PARAM(Tone990, tvaEnv.velo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, tvaEnv.timeVelo, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, tvaEnv.timeKF, U8, 0, 20, 10),
+	JDTOOLS_PARAM(Tone990, tvaEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvaEnv.level1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvaEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvaEnv.level2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvaEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvaEnv.sustainLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, tvaEnv.time4, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, common.velocityCurve, U8, 0, 3, -1),
+	JDTOOLS_PARAM(Tone990, common.holdControl, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone990, lfo1.waveform, U8, 0, 7, 0),
+	JDTOOLS_PARAM(Tone990, lfo1.rate, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, lfo1.delay, U8, 0, 101, 0),
+	JDTOOLS_PARAM(Tone990, lfo1.fade, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, lfo1.offset, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone990, lfo1.keyTrigger, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone990, lfo1.depthPitch, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, lfo1.depthTVF, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, lfo1.depthTVA, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, lfo2.waveform, U8, 0, 7, 0),
+	JDTOOLS_PARAM(Tone990, lfo2.rate, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Tone990, lfo2.delay, U8, 0, 101, 0),
+	JDTOOLS_PARAM(Tone990, lfo2.fade, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, lfo2.offset, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Tone990, lfo2.keyTrigger, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Tone990, lfo2.depthPitch, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, lfo2.depthTVF, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, lfo2.depthTVA, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs1.destination1, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs1.depth1, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs1.destination2, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs1.depth2, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs1.destination3, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs1.depth3, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs1.destination4, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs1.depth4, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs2.destination1, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs2.depth1, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs2.destination2, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs2.depth2, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs2.destination3, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs2.depth3, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Tone990, cs2.destination4, U8, 0, 11, 0),
+	JDTOOLS_PARAM(Tone990, cs2.depth4, U8, 0, 100, 50),
+};
+
+inline constexpr ParameterInfo PATCH990_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(Patch990, common.patchLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, common.patchPan, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Patch990, common.analogFeel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, common.voicePriority, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, common.bendRangeDown, U8, 0, 48, 0),
+	JDTOOLS_PARAM(Patch990, common.bendRangeUp, U8, 0, 12, 0),
+	JDTOOLS_PARAM(Patch990, common.toneControlSource1, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch990, common.toneControlSource2, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch990, common.layerTone, U8, 0, 15, 0),
+	JDTOOLS_PARAM(Patch990, common.activeTone, U8, 0, 15, 0),
+	JDTOOLS_PARAM(Patch990, keyEffects.portamentoSW, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, keyEffects.portamentoMode, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, keyEffects.portamentoType, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, keyEffects.portamentoTime, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, keyEffects.soloSW, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, keyEffects.soloLegato, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, keyEffects.soloSyncMaster, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Patch990, eq.lowFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, eq.lowGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(Patch990, eq.midFreq, U8, 0, 16, 0),
+	JDTOOLS_PARAM(Patch990, eq.midQ, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Patch990, eq.midGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(Patch990, eq.highFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, eq.highGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(Patch990, structureType.structureAB, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch990, structureType.structureCD, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeLowA, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeLowB, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeLowC, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeLowD, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeHighA, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeHighB, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeHighC, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, keyRanges.keyRangeHighD, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityRange1, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityRange2, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityRange3, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityRange4, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityPoint1, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityPoint2, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityPoint3, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityPoint4, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityFade1, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityFade2, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityFade3, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, velocity.velocityFade4, U8, 0, 127, 0),
+	JDTOOLS_PARAM(Patch990, effect.effectsBalanceGroupB, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.controlSource1, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch990, effect.controlDest1, U8, 0, 14, 0),
+	JDTOOLS_PARAM(Patch990, effect.controlDepth1, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Patch990, effect.controlSource2, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch990, effect.controlDest2, U8, 0, 14, 0),
+	JDTOOLS_PARAM(Patch990, effect.controlDepth2, U8, 0, 100, 50),
+	JDTOOLS_PARAM(Patch990, effect.groupAsequence, U8, 0, 23, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupAblockSwitch1, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupAblockSwitch2, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupAblockSwitch3, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupAblockSwitch4, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.distortionType, U8, 0, 6, 0),
+	JDTOOLS_PARAM(Patch990, effect.distortionDrive, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.distortionLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.phaserManual, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch990, effect.phaserRate, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch990, effect.phaserDepth, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.phaserResonance, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.phaserMix, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.spectrumBand1, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch990, effect.spectrumBand2, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch990, effect.spectrumBand3, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch990, effect.spectrumBand4, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch990, effect.spectrumBand5, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch990, effect.spectrumBand6, U8, 0, 30, 0),
+	JDTOOLS_PARAM(Patch990, effect.spectrumBandwidth, U8, 0, 4, 0),
+	JDTOOLS_PARAM(Patch990, effect.enhancerSens, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.enhancerMix, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupBsequence, U8, 0, 5, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupBblockSwitch1, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupBblockSwitch2, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.groupBblockSwitch3, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.chorusRate, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch990, effect.chorusDepth, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.chorusDelayTime, U8, 0, 99, 0),
+	JDTOOLS_PARAM(Patch990, effect.chorusFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(Patch990, effect.chorusLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayMode, U8, 0, 2, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayCenterTapMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayCenterTapLSB, U8, 0, 125, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayCenterLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayLeftTapMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayLeftTapLSB, U8, 0, 125, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayLeftLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayRightTapMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayRightTapLSB, U8, 0, 125, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayRightLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.delayFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(Patch990, effect.reverbType, U8, 0, 9, 0),
+	JDTOOLS_PARAM(Patch990, effect.reverbPreDelay, U8, 0, 120, 0),
+	JDTOOLS_PARAM(Patch990, effect.reverbEarlyRefLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.reverbHFDamp, U8, 0, 16, 0),
+	JDTOOLS_PARAM(Patch990, effect.reverbTime, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, effect.reverbLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(Patch990, octaveSwitch, U8, 0, 2, 0),
+};
+
+// ZenCore stores most bipolar parameters as signed values, so there is no display offset
+inline constexpr ParameterInfo TONEVST_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(ToneVST, common.layerEnabled, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, common.layerSelected, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, common.velocityCurve, U8, 0, 3, -1),
+	JDTOOLS_PARAM(ToneVST, common.holdControl, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.waveform, U8, 0, 4, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.tempoSync, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.rate, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.rateWithTempoSync, U8, 0, 22, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.delay, U8, 0, 101, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.fade, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.offset, U8, 0, 2, 0),
+	JDTOOLS_PARAM(ToneVST, lfo1.keyTrigger, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.waveform, U8, 0, 4, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.tempoSync, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.rate, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.rateWithTempoSync, U8, 0, 22, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.delay, U8, 0, 101, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.fade, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.offset, U8, 0, 2, 0),
+	JDTOOLS_PARAM(ToneVST, lfo2.keyTrigger, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, wg.waveformLSB, U8, 0, 108, 0),
+	JDTOOLS_PARAM(ToneVST, wg.gain, S8, 0, 5, 3),
+	JDTOOLS_PARAM(ToneVST, wg.pitchCoarse, S8, -48, 48, 0),
+	JDTOOLS_PARAM(ToneVST, wg.pitchFine, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, wg.pitchRandom, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, wg.keyFollow, U8, 0, 16, 0),
+	JDTOOLS_PARAM(ToneVST, wg.benderSwitch, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, wg.aTouchBend, S8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, wg.lfo1Sens, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, wg.lfo2Sens, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, wg.leverSens, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, wg.aTouchModSens, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.velo, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.timeVelo, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.timeKF, S8, -10, 10, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.level0, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.level1, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.level2, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, pitchEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.filterMode, U8, 0, 2, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.cutoffFreq, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.resonance, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.keyFollow, U8, 0, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.aTouchSens, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.lfoSelect, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.lfoDepth, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvf.envDepth, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.velo, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.timeVelo, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.timeKF, S8, -10, 10, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.level1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.level2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.sustainLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.level4, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvfEnv.time4, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tva.biasDirection, U8, 0, 2, 0),
+	JDTOOLS_PARAM(ToneVST, tva.biasPoint, U8, 0, 127, 0),
+	JDTOOLS_PARAM(ToneVST, tva.biasLevel, S8, -10, 10, 0),
+	JDTOOLS_PARAM(ToneVST, tva.level, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tva.aTouchSens, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tva.lfoSelect, U8, 0, 1, 0),
+	JDTOOLS_PARAM(ToneVST, tva.lfoDepth, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.velo, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.timeVelo, S8, -50, 50, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.timeKF, S8, -10, 10, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.level1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.level2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.sustainLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.time1, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.time2, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.time3, U8, 0, 100, 0),
+	JDTOOLS_PARAM(ToneVST, tvaEnv.time4, U8, 0, 100, 0),
+};
+
+inline constexpr ParameterInfo PATCHVST_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(PatchVST, common.patchLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeLowA, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeHighA, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeLowB, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeHighB, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeLowC, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeHighC, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeLowD, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.keyRangeHighD, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, common.benderRangeDown, U8, 0, 48, 0),
+	JDTOOLS_PARAM(PatchVST, common.benderRangeUp, U8, 0, 12, 0),
+	JDTOOLS_PARAM(PatchVST, common.aTouchBend, U8, 0, 26, 0),
+	JDTOOLS_PARAM(PatchVST, common.soloSW, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, common.soloLegato, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, common.portamentoSW, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, common.portamentoMode, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, common.portamentoTime, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, eq.midQ, U8, 0, 160, 0),
+	JDTOOLS_PARAM(PatchVST, eq.lowFreq, U16LE, 0, 20000, 0),
+	JDTOOLS_PARAM(PatchVST, eq.midFreq, U16LE, 0, 20000, 0),
+	JDTOOLS_PARAM(PatchVST, eq.highFreq, U16LE, 0, 20000, 0),
+	JDTOOLS_PARAM(PatchVST, eq.lowGain, S16LE, -240, 240, 0),
+	JDTOOLS_PARAM(PatchVST, eq.midGain, S16LE, -240, 240, 0),
+	JDTOOLS_PARAM(PatchVST, eq.highGain, S16LE, -240, 240, 0),
+	JDTOOLS_PARAM(PatchVST, eq.eqEnabled, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.groupAenabled, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.groupAsequence, U16LE, 0, 23, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.distortionEnabled, U16LE, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.distortionType, U16LE, 0, 6, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.distortionDrive, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.distortionLevel, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.phaserEnabled, U16LE, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.phaserManual, U16LE, 0, 99, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.phaserRate, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.phaserDepth, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.phaserResonance, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.phaserMix, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumEnabled, U16LE, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumBand1, U16LE, 0, 30, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumBand2, U16LE, 0, 30, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumBand3, U16LE, 0, 30, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumBand4, U16LE, 0, 30, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumBand5, U16LE, 0, 30, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumBand6, U16LE, 0, 30, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.spectrumBandwidth, U16LE, 0, 4, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.enhancerEnabled, U16LE, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.enhancerSens, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.enhancerMix, U16LE, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.panningGroupA, U16LE, 0, 127, 64),
+	JDTOOLS_PARAM(PatchVST, effectsGroupA.effectsLevelGroupA, U16LE, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.groupBsequence, U8, 0, 5, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayEnabled, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayCenterTempoSync, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayCenterTap, U8, 0, 125, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayCenterTapWithSync, U8, 0, 22, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayLeftTempoSync, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayLeftTap, U8, 0, 125, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayLeftTapWithSync, U8, 0, 22, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayRightTempoSync, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayRightTap, U8, 0, 125, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayRightTapWithSync, U8, 0, 22, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayCenterLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayLeftLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayRightLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.delayFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.chorusEnabled, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.chorusRate, U8, 0, 99, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.chorusDepth, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.chorusDelayTime, U8, 0, 99, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.chorusFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.chorusLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.reverbEnabled, U8, 0, 1, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.reverbType, U8, 0, 9, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.reverbPreDelay, U8, 0, 120, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.reverbEarlyRefLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.reverbHFDamp, U8, 0, 16, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.reverbTime, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.reverbLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.effectsBalanceGroupB, U8, 0, 100, 0),
+	JDTOOLS_PARAM(PatchVST, effectsGroupB.effectsLevelGroupB, U8, 0, 127, 0),
+	JDTOOLS_PARAM(PatchVST, unison, U8, 0, 1, 0),
+};
+
+inline constexpr ParameterInfo SETUP800_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(SpecialSetup800, eq.lowFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup800, eq.lowGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(SpecialSetup800, eq.midFreq, U8, 0, 16, 0),
+	JDTOOLS_PARAM(SpecialSetup800, eq.midQ, U8, 0, 4, 0),
+	JDTOOLS_PARAM(SpecialSetup800, eq.midGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(SpecialSetup800, eq.highFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup800, eq.highGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(SpecialSetup800, common.benderRangeDown, U8, 0, 48, 0),
+	JDTOOLS_PARAM(SpecialSetup800, common.benderRangeUp, U8, 0, 12, 0),
+	JDTOOLS_PARAM(SpecialSetup800, common.aTouchBendSens, U8, 0, 26, 0),
+};
+
+// Offsets are relative to the key, see ParameterGroups<SpecialSetup800>
+inline constexpr ParameterInfo SETUP800_KEY_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(SpecialSetup800::Key, muteGroup, U8, 0, 8, 0),
+	JDTOOLS_PARAM(SpecialSetup800::Key, envMode, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup800::Key, pan, U8, 0, 60, 30),
+	JDTOOLS_PARAM(SpecialSetup800::Key, effectMode, U8, 0, 3, 0),
+	JDTOOLS_PARAM(SpecialSetup800::Key, effectLevel, U8, 0, 100, 0),
+};
+
+inline constexpr ParameterInfo SETUP990_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(SpecialSetup990, common.level, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, common.pan, U8, 0, 100, 50),
+	JDTOOLS_PARAM(SpecialSetup990, common.analogFeel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, common.benderRangeDown, U8, 0, 48, 0),
+	JDTOOLS_PARAM(SpecialSetup990, common.benderRangeUp, U8, 0, 12, 0),
+	JDTOOLS_PARAM(SpecialSetup990, common.toneControlSource1, U8, 0, 5, 0),
+	JDTOOLS_PARAM(SpecialSetup990, common.toneControlSource2, U8, 0, 5, 0),
+	JDTOOLS_PARAM(SpecialSetup990, eq.lowFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup990, eq.lowGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(SpecialSetup990, eq.midFreq, U8, 0, 16, 0),
+	JDTOOLS_PARAM(SpecialSetup990, eq.midQ, U8, 0, 4, 0),
+	JDTOOLS_PARAM(SpecialSetup990, eq.midGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(SpecialSetup990, eq.highFreq, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup990, eq.highGain, U8, 0, 30, 15),
+	JDTOOLS_PARAM(SpecialSetup990, effect.controlSource1, U8, 0, 5, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.controlDest1, U8, 0, 14, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.controlDepth1, U8, 0, 100, 50),
+	JDTOOLS_PARAM(SpecialSetup990, effect.controlSource2, U8, 0, 5, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.controlDest2, U8, 0, 14, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.controlDepth2, U8, 0, 100, 50),
+	JDTOOLS_PARAM(SpecialSetup990, effect.chorusRate, U8, 0, 99, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.chorusDepth, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.chorusDelayTime, U8, 0, 99, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.chorusFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.chorusLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayMode, U8, 0, 2, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayCenterTapMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayCenterTapLSB, U8, 0, 125, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayCenterLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayLeftTapMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayLeftTapLSB, U8, 0, 125, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayLeftLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayRightTapMSB, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayRightTapLSB, U8, 0, 125, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayRightLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.delayFeedback, U8, 0, 98, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.reverbType, U8, 0, 9, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.reverbPreDelay, U8, 0, 120, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.reverbEarlyRefLevel, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.reverbHFDamp, U8, 0, 16, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.reverbTime, U8, 0, 100, 0),
+	JDTOOLS_PARAM(SpecialSetup990, effect.reverbLevel, U8, 0, 100, 0),
+};
+
+// Offsets are relative to the key, see ParameterGroups<SpecialSetup990>
+inline constexpr ParameterInfo SETUP990_KEY_PARAMETERS[] =
+{
+	JDTOOLS_PARAM(SpecialSetup990::Key, envMode, U8, 0, 1, 0),
+	JDTOOLS_PARAM(SpecialSetup990::Key, muteGroup, U8, 0, 26, 0),
+	JDTOOLS_PARAM(SpecialSetup990::Key, effectMode, U8, 0, 6, 0),
+	JDTOOLS_PARAM(SpecialSetup990::Key, effectLevel, U8, 0, 100, 0),
+};
+
+#undef JDTOOLS_PARAM
+
+#define JDTOOLS_MAP_MEMBERS(Src, srcMember, Dst, dstMember, delta) \
+	ParameterMapping{static_cast<uint16_t>(offsetof(Src, srcMember)), static_cast<uint16_t>(offsetof(Dst, dstMember)), delta}
+#define JDTOOLS_MAP(member, delta) JDTOOLS_MAP_MEMBERS(Tone800, member, ToneVST, member, delta)
+
+// Tone parameters that only differ by a constant offset between JD-800 and ZenCore format.
+// Everything else (waveform numbering, pitch envelope levels, inverted enums, ...) is converted by hand.
+inline constexpr ParameterMapping TONE800_TO_VST[] =
+{
+	JDTOOLS_MAP(common.velocityCurve, 0),
+	JDTOOLS_MAP(common.holdControl, 0),
+	JDTOOLS_MAP(lfo1.waveform, 0),
+	JDTOOLS_MAP(lfo1.rate, 0),
+	JDTOOLS_MAP(lfo1.delay, 0),
+	JDTOOLS_MAP(lfo1.fade, -50),
+	JDTOOLS_MAP(lfo1.keyTrigger, 0),
+	JDTOOLS_MAP(lfo2.waveform, 0),
+	JDTOOLS_MAP(lfo2.rate, 0),
+	JDTOOLS_MAP(lfo2.delay, 0),
+	JDTOOLS_MAP(lfo2.fade, -50),
+	JDTOOLS_MAP(lfo2.keyTrigger, 0),
+	JDTOOLS_MAP(wg.pitchCoarse, -48),
+	JDTOOLS_MAP(wg.pitchFine, -50),
+	JDTOOLS_MAP(wg.pitchRandom, 0),
+	JDTOOLS_MAP(wg.keyFollow, 0),
+	JDTOOLS_MAP(wg.benderSwitch, 0),
+	JDTOOLS_MAP(wg.aTouchBend, 0),
+	JDTOOLS_MAP(wg.lfo1Sens, -50),
+	JDTOOLS_MAP(wg.lfo2Sens, -50),
+	JDTOOLS_MAP(wg.leverSens, -50),
+	JDTOOLS_MAP(wg.aTouchModSens, -50),
+	JDTOOLS_MAP(pitchEnv.velo, -50),
+	JDTOOLS_MAP(pitchEnv.timeVelo, -50),
+	JDTOOLS_MAP(pitchEnv.timeKF, -10),
+	JDTOOLS_MAP(pitchEnv.time1, 0),
+	JDTOOLS_MAP(pitchEnv.time2, 0),
+	JDTOOLS_MAP(pitchEnv.time3, 0),
+	JDTOOLS_MAP(tvf.cutoffFreq, 0),
+	JDTOOLS_MAP(tvf.resonance, 0),
+	JDTOOLS_MAP(tvf.keyFollow, 0),
+	JDTOOLS_MAP(tvf.aTouchSens, -50),
+	JDTOOLS_MAP(tvf.lfoSelect, 0),
+	JDTOOLS_MAP(tvf.lfoDepth, -50),
+	JDTOOLS_MAP(tvf.envDepth, -50),
+	JDTOOLS_MAP(tvfEnv.velo, -50),
+	JDTOOLS_MAP(tvfEnv.timeVelo, -50),
+	JDTOOLS_MAP(tvfEnv.timeKF, -10),
+	JDTOOLS_MAP(tvfEnv.level1, 0),
+	JDTOOLS_MAP(tvfEnv.level2, 0),
+	JDTOOLS_MAP(tvfEnv.sustainLevel, 0),
+	JDTOOLS_MAP(tvfEnv.level4, 0),
+	JDTOOLS_MAP(tvfEnv.time1, 0),
+	JDTOOLS_MAP(tvfEnv.time2, 0),
+	JDTOOLS_MAP(tvfEnv.time3, 0),
+	JDTOOLS_MAP(tvfEnv.time4, 0),
+	JDTOOLS_MAP(tva.biasDirection, 0),
+	JDTOOLS_MAP(tva.biasPoint, 0),
+	JDTOOLS_MAP(tva.biasLevel, -10),
+	JDTOOLS_MAP(tva.level, 0),
+	JDTOOLS_MAP(tva.aTouchSens, -50),
+	JDTOOLS_MAP(tva.lfoSelect, 0),
+	JDTOOLS_MAP(tva.lfoDepth, -50),
+	JDTOOLS_MAP(tvaEnv.velo, -50),
+	JDTOOLS_MAP(tvaEnv.timeVelo, -50),
+	JDTOOLS_MAP(tvaEnv.timeKF, -10),
+	JDTOOLS_MAP(tvaEnv.level1, 0),
+	JDTOOLS_MAP(tvaEnv.level2, 0),
+	JDTOOLS_MAP(tvaEnv.sustainLevel, 0),
+	JDTOOLS_MAP(tvaEnv.time1, 0),
+	JDTOOLS_MAP(tvaEnv.time2, 0),
+	JDTOOLS_MAP(tvaEnv.time3, 0),
+	JDTOOLS_MAP(tvaEnv.time4, 0),
+};
+
+#undef JDTOOLS_MAP
+#define JDTOOLS_MAP(member) JDTOOLS_MAP_MEMBERS(Tone800, member, Tone990, member, 0)
+
+// Tone parameters that are stored identically on JD-800 and JD-990.
+// LFO waveforms and depths as well as everything that is handled through tone control on the JD-990 is converted by hand.
+inline constexpr ParameterMapping TONE800_TO_990[] =
+{
+	JDTOOLS_MAP(common.velocityCurve),
+	JDTOOLS_MAP(common.holdControl),
+	JDTOOLS_MAP(lfo1.rate),
+	JDTOOLS_MAP(lfo1.delay),
+	JDTOOLS_MAP(lfo1.fade),
+	JDTOOLS_MAP(lfo1.offset),
+	JDTOOLS_MAP(lfo1.keyTrigger),
+	JDTOOLS_MAP(lfo2.rate),
+	JDTOOLS_MAP(lfo2.delay),
+	JDTOOLS_MAP(lfo2.fade),
+	JDTOOLS_MAP(lfo2.offset),
+	JDTOOLS_MAP(lfo2.keyTrigger),
+	JDTOOLS_MAP(wg.waveSource),
+	JDTOOLS_MAP(wg.waveformMSB),
+	JDTOOLS_MAP(wg.waveformLSB),
+	JDTOOLS_MAP(wg.pitchCoarse),
+	JDTOOLS_MAP(wg.pitchFine),
+	JDTOOLS_MAP(wg.pitchRandom),
+	JDTOOLS_MAP(wg.keyFollow),
+	JDTOOLS_MAP(wg.benderSwitch),
+	JDTOOLS_MAP(pitchEnv.velo),
+	JDTOOLS_MAP(pitchEnv.timeVelo),
+	JDTOOLS_MAP(pitchEnv.timeKF),
+	JDTOOLS_MAP(pitchEnv.level0),
+	JDTOOLS_MAP(pitchEnv.time1),
+	JDTOOLS_MAP(pitchEnv.level1),
+	JDTOOLS_MAP(pitchEnv.time2),
+	JDTOOLS_MAP(pitchEnv.time3),
+	JDTOOLS_MAP_MEMBERS(Tone800, pitchEnv.level2, Tone990, pitchEnv.level3, 0),
+	JDTOOLS_MAP(tvf.filterMode),
+	JDTOOLS_MAP(tvf.cutoffFreq),
+	JDTOOLS_MAP(tvf.resonance),
+	JDTOOLS_MAP(tvf.keyFollow),
+	JDTOOLS_MAP(tvf.envDepth),
+	JDTOOLS_MAP(tvfEnv.velo),
+	JDTOOLS_MAP(tvfEnv.timeVelo),
+	JDTOOLS_MAP(tvfEnv.timeKF),
+	JDTOOLS_MAP(tvfEnv.time1),
+	JDTOOLS_MAP(tvfEnv.level1),
+	JDTOOLS_MAP(tvfEnv.time2),
+	JDTOOLS_MAP(tvfEnv.level2),
+	JDTOOLS_MAP(tvfEnv.time3),
+	JDTOOLS_MAP(tvfEnv.sustainLevel),
+	JDTOOLS_MAP(tvfEnv.time4),
+	JDTOOLS_MAP(tvfEnv.level4),
+	JDTOOLS_MAP(tva.biasDirection),
+	JDTOOLS_MAP(tva.biasPoint),
+	JDTOOLS_MAP(tva.biasLevel),
+	JDTOOLS_MAP(tva.level),
+	JDTOOLS_MAP(tvaEnv.velo),
+	JDTOOLS_MAP(tvaEnv.timeVelo),
+	JDTOOLS_MAP(tvaEnv.timeKF),
+	JDTOOLS_MAP(tvaEnv.time1),
+	JDTOOLS_MAP(tvaEnv.level1),
+	JDTOOLS_MAP(tvaEnv.time2),
+	JDTOOLS_MAP(tvaEnv.level2),
+	JDTOOLS_MAP(tvaEnv.time3),
+	JDTOOLS_MAP(tvaEnv.sustainLevel),
+	JDTOOLS_MAP(tvaEnv.time4),
+};
+
+#undef JDTOOLS_MAP
+#undef JDTOOLS_MAP_MEMBERS
+
+// Complete parameter layout of each patch format. Tones use the same prefix in all formats so that paths can be compared across formats.
+inline constexpr ParameterGroup PATCH800_GROUPS[] =
+{
+	{ "", 0, PATCH800_PARAMETERS },
+	{ "toneA.", offsetof(Patch800, toneA), TONE800_PARAMETERS },
+	{ "toneB.", offsetof(Patch800, toneB), TONE800_PARAMETERS },
+	{ "toneC.", offsetof(Patch800, toneC), TONE800_PARAMETERS },
+	{ "toneD.", offsetof(Patch800, toneD), TONE800_PARAMETERS },
+};
+
+inline constexpr ParameterGroup PATCH990_GROUPS[] =
+{
+	{ "", 0, PATCH990_PARAMETERS },
+	{ "toneA.", offsetof(Patch990, toneA), TONE990_PARAMETERS },
+	{ "toneB.", offsetof(Patch990, toneB), TONE990_PARAMETERS },
+	{ "toneC.", offsetof(Patch990, toneC), TONE990_PARAMETERS },
+	{ "toneD.", offsetof(Patch990, toneD), TONE990_PARAMETERS },
+};
+
+inline constexpr ParameterGroup PATCHVST_GROUPS[] =
+{
+	{ "", 0, PATCHVST_PARAMETERS },
+	{ "toneA.", offsetof(PatchVST, tone) + 0 * sizeof(ToneVST), TONEVST_PARAMETERS },
+	{ "toneB.", offsetof(PatchVST, tone) + 1 * sizeof(ToneVST), TONEVST_PARAMETERS },
+	{ "toneC.", offsetof(PatchVST, tone) + 2 * sizeof(ToneVST), TONEVST_PARAMETERS },
+	{ "toneD.", offsetof(PatchVST, tone) + 3 * sizeof(ToneVST), TONEVST_PARAMETERS },
+};
+
+template<typename T> std::span<const ParameterGroup> ParameterGroups() noexcept = delete;
+template<> inline std::span<const ParameterGroup> ParameterGroups<Patch800>() noexcept { return PATCH800_GROUPS; }
+template<> inline std::span<const ParameterGroup> ParameterGroups<Patch990>() noexcept { return PATCH990_GROUPS; }
+template<> inline std::span<const ParameterGroup> ParameterGroups<PatchVST>() noexcept { return PATCHVST_GROUPS; }
+// Special setups consist of a common block followed by 61 keys with one tone each, the groups are built on first use
+template<> std::span<const ParameterGroup> ParameterGroups<SpecialSetup800>() noexcept;
+template<> std::span<const ParameterGroup> ParameterGroups<SpecialSetup990>() noexcept;
+
+int32_t GetParameter(const void *base, uint32_t offset, ParameterType type) noexcept;
+void SetParameter(void *base, uint32_t offset, ParameterType type, int32_t value) noexcept;
+std::string ParameterPath(const ParameterGroup &group, const ParameterInfo &param);
+
+// Calls func(group, param, value) for all parameters of a patch, in table order
+template<typename Func>
+void ForEachParameter(std::span<const ParameterGroup> groups, const void *patch, Func &&func)
+{
+	for (const ParameterGroup &group : groups)
+	{
+		for (const ParameterInfo &param : group.parameters)
+		{
+			func(group, param, GetParameter(patch, group.offset + param.offset, param.type));
+		}
+	}
+}
+
+// Calls func(group, param, value) for all parameters of a patch that are outside of their valid range
+template<typename Func>
+void ForEachOutOfRange(std::span<const ParameterGroup> groups, const void *patch, Func &&func)
+{
+	ForEachParameter(groups, patch, [&func](const ParameterGroup &group, const ParameterInfo &param, const int32_t value)
+	{
+		if (value < param.minValue || value > param.maxValue)
+			func(group, param, value);
+	});
+}
+
+// Prints all parameters as "path: value", using the display offset of each parameter
+void PrintParameters(std::span<const ParameterGroup> groups, const void *patch);
+
+// Converts all mapped parameters from source to destination format, or the other way around.
+// Values wrap around like the 8-bit struct members they are stored in.
+void ApplyMapping(std::span<const ParameterMapping> mappings, const void *src, void *dst) noexcept;
+void ApplyMappingReverse(std::span<const ParameterMapping> mappings, const void *src, void *dst) noexcept;
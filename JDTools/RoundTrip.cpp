@@ -0,0 +1,305 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "RoundTrip.hpp"
+#include "JDTools.hpp"
+#include "ParameterTables.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <streambuf>
+#include <span>
+#include <string>
+
+namespace
+{
+	// Absolute error buckets: 1, 2-3, 4-7, 8-15, 16-31, 32+
+	constexpr size_t NUM_BUCKETS = 6;
+	constexpr std::array<const char *, NUM_BUCKETS> BUCKET_NAMES = { "1", "2-3", "4-7", "8-15", "16-31", "32+" };
+
+	struct ParameterStats
+	{
+		uint32_t numDifferent = 0;
+		int32_t maxError = 0;
+		std::array<uint32_t, NUM_BUCKETS> histogram{};
+
+		void Add(const int32_t error)
+		{
+			numDifferent++;
+			maxError = std::max(maxError, error);
+			size_t bucket = 0;
+			while (bucket < NUM_BUCKETS - 1 && error >= (2 << bucket))
+				bucket++;
+			histogram[bucket]++;
+		}
+
+		void Merge(const ParameterStats &other)
+		{
+			numDifferent += other.numDifferent;
+			maxError = std::max(maxError, other.maxError);
+			for (size_t i = 0; i < NUM_BUCKETS; i++)
+				histogram[i] += other.histogram[i];
+		}
+	};
+
+	// Raw byte range that is not described by the parameter tables, but should survive a round trip nonetheless
+	struct RawRegion
+	{
+		std::string_view name;
+		size_t offset;
+		size_t size;
+	};
+
+	constexpr RawRegion PRECOMPUTED_REGIONS_VST[] =
+	{
+		{ "commonPrecomputed (bytes)", offsetof(PatchVST, commonPrecomputed), sizeof(PatchVST::commonPrecomputed) },
+		{ "tonesPrecomputed (bytes)", offsetof(PatchVST, tonesPrecomputed), sizeof(PatchVST::tonesPrecomputed) },
+	};
+
+	struct CycleResult
+	{
+		uint32_t numItems = 0;
+		uint32_t numIdentical = 0;
+		std::vector<ParameterStats> parameters;  // Flattened parameters of all groups, followed by raw regions
+		std::map<std::string, uint32_t> warnings;
+
+		void Merge(const CycleResult &other)
+		{
+			numItems += other.numItems;
+			numIdentical += other.numIdentical;
+			for (size_t i = 0; i < parameters.size(); i++)
+				parameters[i].Merge(other.parameters[i]);
+			for (const auto &[warning, count] : other.warnings)
+				warnings[warning] += count;
+		}
+	};
+
+	// Collapses warnings that only differ in the reported value, e.g. "Tone uses gain != 0 dB: -6 dB"
+	void CollectWarnings(std::string &captured, std::map<std::string, uint32_t> &warnings)
+	{
+		size_t start = 0;
+		while (start < captured.size())
+		{
+			size_t end = captured.find('\n', start);
+			if (end == std::string::npos)
+				end = captured.size();
+			std::string_view line{captured.data() + start, end - start};
+			if (const auto colon = line.rfind(": "); colon != std::string_view::npos)
+				line = line.substr(0, colon);
+			if (!line.empty())
+				warnings[std::string{line}]++;
+			start = end + 1;
+		}
+		captured.clear();
+	}
+
+	template<typename T>
+	size_t NumParameters()
+	{
+		size_t num = 0;
+		for (const ParameterGroup &group : ParameterGroups<T>())
+			num += group.parameters.size();
+		return num;
+	}
+
+	template<typename T>
+	bool Compare(const T &original, const T &result, std::span<const RawRegion> rawRegions, std::vector<ParameterStats> &stats)
+	{
+		bool identical = true;
+		size_t index = 0;
+		for (const ParameterGroup &group : ParameterGroups<T>())
+		{
+			for (const ParameterInfo &param : group.parameters)
+			{
+				const uint32_t offset = group.offset + param.offset;
+				const int32_t error = std::abs(GetParameter(&original, offset, param.type) - GetParameter(&result, offset, param.type));
+				if (error)
+				{
+					stats[index].Add(error);
+					identical = false;
+				}
+				index++;
+			}
+		}
+		for (const RawRegion &region : rawRegions)
+		{
+			const auto *a = reinterpret_cast<const uint8_t *>(&original) + region.offset;
+			const auto *b = reinterpret_cast<const uint8_t *>(&result) + region.offset;
+			int32_t numDifferent = 0;
+			for (size_t i = 0; i < region.size; i++)
+				numDifferent += (a[i] != b[i]);
+			if (numDifferent)
+			{
+				stats[index].Add(numDifferent);
+				identical = false;
+			}
+			index++;
+		}
+		return identical;
+	}
+
+	// Runs one conversion cycle over all items concurrently. Each thread accumulates its own statistics, which are merged in the end.
+	template<typename T, typename Intermediate, typename Forward, typename Backward>
+	CycleResult RunCycle(const std::vector<T> &items, Forward forward, Backward backward, std::span<const RawRegion> rawRegions = {})
+	{
+		const size_t numStats = NumParameters<T>() + rawRegions.size();
+		std::vector<CycleResult> threadResults(std::max(ParallelThreadCount(items.size()), size_t(1)));
+		std::vector<std::unique_ptr<Intermediate>> intermediates(threadResults.size());
+		std::vector<std::unique_ptr<T>> converted(threadResults.size());
+		for (size_t i = 0; i < threadResults.size(); i++)
+		{
+			threadResults[i].parameters.resize(numStats);
+			intermediates[i] = std::make_unique<Intermediate>();
+			converted[i] = std::make_unique<T>();
+		}
+
+		ParallelFor(items.size(), [&](const size_t item, const size_t thread)
+		{
+			CycleResult &result = threadResults[thread];
+			*intermediates[thread] = {};
+			*converted[thread] = {};
+			forward(items[item], *intermediates[thread]);
+			backward(*intermediates[thread], *converted[thread]);
+			CollectWarnings(ThreadLocalCapture::Buffer(), result.warnings);
+			result.numItems++;
+			if (Compare(items[item], *converted[thread], rawRegions, result.parameters))
+				result.numIdentical++;
+		});
+
+		for (size_t i = 1; i < threadResults.size(); i++)
+		{
+			threadResults[0].Merge(threadResults[i]);
+		}
+		return std::move(threadResults[0]);
+	}
+
+	struct NamedCycle
+	{
+		std::string name;
+		std::vector<std::string> parameterNames;
+		CycleResult result;
+	};
+
+	template<typename T>
+	std::vector<std::string> ParameterNames(std::span<const RawRegion> rawRegions = {})
+	{
+		std::vector<std::string> names;
+		for (const ParameterGroup &group : ParameterGroups<T>())
+		{
+			for (const ParameterInfo &param : group.parameters)
+				names.push_back(ParameterPath(group, param));
+		}
+		for (const RawRegion &region : rawRegions)
+			names.emplace_back(region.name);
+		return names;
+	}
+
+	void PrintCycle(const NamedCycle &cycle)
+	{
+		std::cout << cycle.name << ": " << cycle.result.numItems << " converted, " << cycle.result.numIdentical << " identical" << std::endl;
+		for (size_t i = 0; i < cycle.parameterNames.size(); i++)
+		{
+			const ParameterStats &stats = cycle.result.parameters[i];
+			if (!stats.numDifferent)
+				continue;
+			std::cout << "\t" << cycle.parameterNames[i] << ": " << stats.numDifferent << " different, max error " << stats.maxError << ", histogram";
+			for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+			{
+				if (stats.histogram[bucket])
+					std::cout << " " << BUCKET_NAMES[bucket] << ":" << stats.histogram[bucket];
+			}
+			std::cout << std::endl;
+		}
+		for (const auto &[warning, count] : cycle.result.warnings)
+		{
+			std::cout << "\t" << count << "x " << warning << std::endl;
+		}
+	}
+
+	bool WriteJSON(const std::string &filename, const std::vector<NamedCycle> &cycles)
+	{
+		std::ofstream f{filename, std::ios::trunc};
+		if (!f)
+			return false;
+		f << "{\n  \"cycles\": [";
+		for (size_t c = 0; c < cycles.size(); c++)
+		{
+			const NamedCycle &cycle = cycles[c];
+			f << (c ? ",\n" : "\n") << "    {\n"
+				<< "      \"name\": \"" << EscapeJSON(cycle.name) << "\",\n"
+				<< "      \"items\": " << cycle.result.numItems << ",\n"
+				<< "      \"identical\": " << cycle.result.numIdentical << ",\n"
+				<< "      \"parameters\": [";
+			bool first = true;
+			for (size_t i = 0; i < cycle.parameterNames.size(); i++)
+			{
+				const ParameterStats &stats = cycle.result.parameters[i];
+				if (!stats.numDifferent)
+					continue;
+				f << (first ? "\n" : ",\n") << "        { \"path\": \"" << EscapeJSON(cycle.parameterNames[i]) << "\", \"different\": " << stats.numDifferent << ", \"maxError\": " << stats.maxError << ", \"histogram\": [";
+				for (size_t bucket = 0; bucket < NUM_BUCKETS; bucket++)
+					f << (bucket ? ", " : "") << stats.histogram[bucket];
+				f << "] }";
+				first = false;
+			}
+			f << (first ? "" : "\n      ") << "],\n      \"warnings\": [";
+			first = true;
+			for (const auto &[warning, count] : cycle.result.warnings)
+			{
+				f << (first ? "\n" : ",\n") << "        { \"message\": \"" << EscapeJSON(warning) << "\", \"count\": " << count << " }";
+				first = false;
+			}
+			f << (first ? "" : "\n      ") << "]\n    }";
+		}
+		f << "\n  ]\n}\n";
+		return static_cast<bool>(f);
+	}
+}
+
+int RoundTrip(const RoundTripInput &input, std::string_view jsonFilename)
+{
+	std::vector<NamedCycle> cycles;
+	ThreadLocalCapture capture;
+	std::streambuf *oldBuf = std::cerr.rdbuf(&capture);
+
+	if (!input.patches800.empty())
+	{
+		cycles.push_back({"JD-800 -> JD-990 -> JD-800", ParameterNames<Patch800>(), RunCycle<Patch800, Patch990>(input.patches800, ConvertPatch800To990, ConvertPatch990To800)});
+		cycles.push_back({"JD-800 -> ZenCore -> JD-800", ParameterNames<Patch800>(), RunCycle<Patch800, PatchVST>(input.patches800, ConvertPatch800ToVST, ConvertPatchVSTTo800)});
+	}
+	if (!input.patches990.empty())
+		cycles.push_back({"JD-990 -> JD-800 -> JD-990", ParameterNames<Patch990>(), RunCycle<Patch990, Patch800>(input.patches990, ConvertPatch990To800, ConvertPatch800To990)});
+	if (!input.patchesVST.empty())
+		cycles.push_back({"ZenCore -> JD-800 -> ZenCore", ParameterNames<PatchVST>(PRECOMPUTED_REGIONS_VST), RunCycle<PatchVST, Patch800>(input.patchesVST, ConvertPatchVSTTo800, ConvertPatch800ToVST, PRECOMPUTED_REGIONS_VST)});
+	if (!input.setups800.empty())
+		cycles.push_back({"JD-800 setup -> JD-990 setup -> JD-800 setup", ParameterNames<SpecialSetup800>(), RunCycle<SpecialSetup800, SpecialSetup990>(input.setups800, ConvertSetup800To990, ConvertSetup990To800)});
+	if (!input.setups990.empty())
+		cycles.push_back({"JD-990 setup -> JD-800 setup -> JD-990 setup", ParameterNames<SpecialSetup990>(), RunCycle<SpecialSetup990, SpecialSetup800>(input.setups990, ConvertSetup990To800, ConvertSetup800To990)});
+
+	std::cerr.rdbuf(oldBuf);
+
+	if (cycles.empty())
+	{
+		std::cout << "Input didn't contain any patches!" << std::endl;
+		return 2;
+	}
+
+	for (const NamedCycle &cycle : cycles)
+	{
+		PrintCycle(cycle);
+	}
+
+	if (!jsonFilename.empty() && !WriteJSON(std::string{jsonFilename}, cycles))
+	{
+		std::cout << "Could not write " << jsonFilename << "!" << std::endl;
+		return 2;
+	}
+	return 0;
+}
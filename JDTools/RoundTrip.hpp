@@ -0,0 +1,28 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <string_view>
+#include <vector>
+
+struct Patch800;
+struct Patch990;
+struct PatchVST;
+struct SpecialSetup800;
+struct SpecialSetup990;
+
+struct RoundTripInput
+{
+	std::vector<Patch800> patches800;
+	std::vector<Patch990> patches990;
+	std::vector<PatchVST> patchesVST;
+	std::vector<SpecialSetup800> setups800;
+	std::vector<SpecialSetup990> setups990;
+};
+
+// Converts all patches to every other supported format and back, and compares the result to the original parameter by parameter.
+// Prints per-parameter error histograms and the conversion warnings that were emitted, optionally also as JSON.
+// Returns the program exit code.
+int RoundTrip(const RoundTripInput &input, std::string_view jsonFilename);
@@ -4,17 +4,26 @@
 
 #include "SVZ.hpp"
 #include "JD-08.hpp"
+#include "Stats.hpp"
 #include "Utils.hpp"
 
 #include "miniz.h"
 
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <iostream>
+#include <sstream>
+#include <string>
 #include <tuple>
 
 namespace
 {
+	// ZC1 and JD-08 patches consist of 2048 bytes: the patch name and parameters (but no ZEN header), followed by a small trailer
+	constexpr size_t HARDWARE_PATCH_DATA_SIZE = sizeof(PatchVST) - offsetof(PatchVST, name);
+
 	struct SVZHeader
 	{
 		std::array<char, 4> SVZa = { 'S', 'V', 'Z', 'a' };
@@ -61,7 +70,7 @@ namespace
 		uint32le chunkSizeTruncated;  // Only the lower 9 bits?!
 		uint32le unknown2 = 0;
 
-		bool IsValid(const SVZHeaderEntry &chunkHeader) const noexcept
+		bool IsValid(const SVZContainer::Chunk &chunkHeader) const noexcept
 		{
 			static_assert(sizeof(SVZChunkHeaderMDLa) == 16);
 
@@ -83,7 +92,7 @@ namespace
 		uint32le uncompressedSize;
 		std::array<uint32le, 5> unknown2 = { 0, 0, 0, 0, 0 };
 
-		bool IsValid(const SVZHeaderEntry &chunkHeader) const noexcept
+		bool IsValid(const SVZContainer::Chunk &chunkHeader) const noexcept
 		{
 			static_assert(sizeof(SVZChunkHeaderEXTa) == 64);
 
@@ -148,7 +157,7 @@ namespace
 	{
 		std::array<char, 4> SVDx = { 'S', 'V', 'D', 'x' };
 		uint32le headerSize = 32;
-		uint32le patchSize = sizeof(PatchVST);
+		uint32le patchSize = PatchVST::FILE_SIZE;
 		uint32le numPatches = 64;
 		std::array<uint32le, 4> unknown = { 2, 0, 0, 0 };
 
@@ -164,132 +173,461 @@ namespace
 	};
 }
 
-std::vector<PatchVST> ReadSVZ(std::istream &inFile)
+static mz_ulong CRC32(const unsigned char *data, const size_t size, const mz_ulong crc = MZ_CRC32_INIT)
 {
-	SVZHeader fileHeader;
-	if (!Read(inFile, fileHeader))
-		return {};
+	StageTimer timer{Stage::Checksum};
+	return mz_crc32(crc, data, size);
+}
 
-	if (!fileHeader.IsValid())
-	{
-		std::cerr << "Not a valid SVZ file!" << std::endl;
-		return {};
-	}
+// The model byte is part of the trailer that follows the patch data of hardware patches
+static SVZModelID HardwareModelID(const unsigned char *patchData) noexcept
+{
+	return {patchData[HARDWARE_PATCH_DATA_SIZE + 29], 0};
+}
 
-	for (uint32_t chunk = 0; chunk < fileHeader.numChunks; chunk++)
+namespace
+{
+	// Decompresses a zlib stream from a file in small pieces, so that memory usage does not depend on the size of the stream.
+	// The CRC32 of the compressed data is computed along the way.
+	class Inflater
 	{
-		SVZHeaderEntry entry;
-		if (!Read(inFile, entry))
-			return {};
-		if (entry.type == SVZHeaderEntry::MDLa)
+	public:
+		Inflater(std::istream &inFile, const uint32_t compressedSize)
+			: m_file{inFile}
+			, m_remaining{compressedSize}
 		{
-			inFile.seekg(entry.offset, std::ios::beg);
-			SVZChunkHeaderMDLa chunkHeader;
-			if (!Read(inFile, chunkHeader))
-				return {};
-
-			if (!chunkHeader.IsValid(entry))
-			{
-				std::cerr << "Not a valid SVZ file!" << std::endl;
-				return {};
-			}
+			m_initialized = (mz_inflateInit(&m_stream) == MZ_OK);
+		}
 
-			if (entry.size != 16 + (sizeof(uint32le) + 2048) * chunkHeader.numPatches)
-			{
-				std::cerr << "SVZ file has unexpected length!" << std::endl;
-				return {};
-			}
+		~Inflater()
+		{
+			if (m_initialized)
+				mz_inflateEnd(&m_stream);
+		}
 
-			const uint32_t numPatches = chunkHeader.numPatches;
-			std::vector<uint32le> patchesCRC32;
-			ReadVector(inFile, patchesCRC32, numPatches);
+		Inflater(const Inflater &) = delete;
+		Inflater &operator=(const Inflater &) = delete;
 
-			std::vector<PatchVST> vstPatches(numPatches);
-			for (uint32_t i = 0; i < numPatches; i++)
+		// Fills the whole buffer with decompressed data
+		bool Read(void *data, const size_t size)
+		{
+			if (!m_initialized)
+				return false;
+			m_stream.next_out = static_cast<unsigned char *>(data);
+			m_stream.avail_out = static_cast<unsigned int>(size);
+			while (m_stream.avail_out)
 			{
-				PatchVST &patch = vstPatches[i];
-				inFile.read(reinterpret_cast<char *>(&patch.name), 2048);
-				const auto patchCRC32 = mz_crc32(0, reinterpret_cast<unsigned char *>(&patch.name), 2048);
-				if (patchCRC32 != patchesCRC32[i])
-					std::cerr << "Warning, CRC32 mismatch for patch " << (i + 1) << std::endl;
-				if (patch.empty[29] != 1)
+				if (!m_stream.avail_in && m_remaining && !FillInput())
+					return false;
+				int result;
+				{
+					StageTimer timer{Stage::Decompress};
+					result = mz_inflate(&m_stream, MZ_NO_FLUSH);
+				}
+				if (result == MZ_STREAM_END)
 				{
-					std::cerr << "Patches appear to be for different synth model!" << std::endl;
-					return {};
+					m_streamEnd = true;
+					return !m_stream.avail_out;
 				}
-				patch.zenHeader = PatchVST::DEFAULT_ZEN_HEADER;
-				patch.empty.fill(0);
+				if (result != MZ_OK)
+					return false;
 			}
-			return vstPatches;
+			return true;
 		}
-		else if (entry.type == SVZHeaderEntry::EXTa)
+
+		// Decompresses and discards data
+		bool Skip(size_t size)
 		{
-			inFile.seekg(entry.offset, std::ios::beg);
-			SVZChunkHeaderEXTa chunkHeader;
-			if (!Read(inFile, chunkHeader))
-				return {};
+			while (size)
+			{
+				const size_t chunkSize = std::min(size, m_discard.size());
+				if (!Read(m_discard.data(), chunkSize))
+					return false;
+				size -= chunkSize;
+			}
+			return true;
+		}
 
-			if (!chunkHeader.IsValid(entry))
+		// Reads the remaining compressed data so that its CRC32 is complete
+		mz_ulong FinishCRC32()
+		{
+			while (m_remaining && FillInput())
 			{
-				std::cerr << "Not a valid SVZ file!" << std::endl;
-				return {};
 			}
+			return m_crc;
+		}
+
+		bool ReadError() const noexcept { return m_readError; }
+		bool StreamEnded() const noexcept { return m_streamEnd; }
+		uint64_t TotalOut() const noexcept { return m_stream.total_out; }
 
-			if (entry.size - 0x20 != chunkHeader.compressedSize)
+	private:
+		bool FillInput()
+		{
+			const uint32_t chunkSize = std::min(m_remaining, static_cast<uint32_t>(m_input.size()));
+			if (!m_file.read(reinterpret_cast<char *>(m_input.data()), chunkSize))
 			{
-				std::cerr << "Compressed data has unexpected length!" << std::endl;
-				return {};
+				m_readError = true;
+				m_remaining = 0;
+				return false;
 			}
+			m_crc = CRC32(m_input.data(), chunkSize, m_crc);
+			m_remaining -= chunkSize;
+			m_stream.next_in = m_input.data();
+			m_stream.avail_in = chunkSize;
+			return true;
+		}
+
+		std::istream &m_file;
+		uint32_t m_remaining;
+		mz_ulong m_crc = MZ_CRC32_INIT;
+		mz_stream m_stream{};
+		bool m_initialized = false, m_streamEnd = false, m_readError = false;
+		std::array<unsigned char, 16384> m_input;
+		std::array<unsigned char, 4096> m_discard;
+	};
+}
 
-			uint32_t compressedSize = entry.size - 0x40;
-			std::vector<unsigned char> compressed;
-			if (!ReadVector(inFile, compressed, compressedSize))
+// If namesOnly is true, only the name of each patch passed to the callback is valid
+static bool ReadEXTa(std::istream &inFile, const SVZChunkHeaderEXTa &chunkHeader, const uint32_t compressedSize, std::ostream &log, const bool namesOnly, const std::function<void(const PatchVST &)> &patchFunc)
+{
+	Inflater inflater{inFile, compressedSize};
+	// Explains why decompression failed. Data corruption is most likely, so that is checked first.
+	const auto failed = [&](const char *reason)
+	{
+		if (inflater.FinishCRC32() != chunkHeader.compressedCRC32 && !inflater.ReadError())
+			log << "Compressed data CRC32 mismatch!" << std::endl;
+		else if (inflater.ReadError())
+			log << "Can't read compressed data!" << std::endl;
+		else if (inflater.StreamEnded())
+			log << "Decompressed data has unexpected length!" << std::endl;
+		else
+			log << reason << std::endl;
+		return false;
+	};
+
+	SVDxHeader svdHeader;
+	if (!inflater.Read(&svdHeader, sizeof(svdHeader)))
+		return failed("Error during decompression!");
+	if (!svdHeader.IsValid())
+		return failed("Unexpected header after decompression!");
+	if (chunkHeader.uncompressedSize < sizeof(svdHeader) || (chunkHeader.uncompressedSize - sizeof(svdHeader)) / PatchVST::FILE_SIZE < svdHeader.numPatches)
+		return failed("Decompressed data has unexpected length!");
+
+	// Only the patch itself is kept, the padding after each patch is dropped
+	PatchVST patch;
+	const size_t nameEnd = offsetof(PatchVST, name) + sizeof(patch.name);
+	for (uint32_t i = 0; i < svdHeader.numPatches; i++)
+	{
+		if (namesOnly)
+		{
+			if (!inflater.Skip(offsetof(PatchVST, name)) || !inflater.Read(&patch.name, sizeof(patch.name)))
+				return failed("Error during decompression!");
+			patchFunc(patch);
+			// Nothing after the last name is decompressed, so the CRC32 of the compressed data cannot be checked either
+			if (i + 1 == svdHeader.numPatches)
 			{
-				std::cerr << "Can't read compressed data!" << std::endl;
-				return {};
+				Stats::Add(Counter::BytesUncompressed, inflater.TotalOut());
+				return true;
 			}
-			if (mz_crc32(0, compressed.data(), compressedSize) != chunkHeader.compressedCRC32)
+			if (!inflater.Skip(PatchVST::FILE_SIZE - nameEnd))
+				return failed("Error during decompression!");
+			continue;
+		}
+		if (!inflater.Read(&patch, sizeof(patch)) || !inflater.Skip(PatchVST::FILE_SIZE - sizeof(patch)))
+			return failed("Error during decompression!");
+		patchFunc(patch);
+	}
+
+	if (inflater.FinishCRC32() != chunkHeader.compressedCRC32)
+		return failed("Compressed data CRC32 mismatch!");
+
+	Stats::Add(Counter::BytesCompressed, compressedSize);
+	Stats::Add(Counter::BytesUncompressed, inflater.TotalOut());
+	return true;
+}
+
+SVZContainer::SVZContainer(std::istream &inFile, std::pmr::memory_resource *memory)
+	: m_file{inFile}
+	, m_chunks{memory}
+	, m_chunkData(memory)
+	, m_chunkLoaded(memory)
+{
+	m_file.seekg(0, std::ios::end);
+	m_fileSize = static_cast<uint64_t>(std::max(std::streamoff(m_file.tellg()), std::streamoff(0)));
+	m_file.seekg(0);
+
+	SVZHeader fileHeader;
+	if (!Read(m_file, fileHeader) || fileHeader.SVZa != SVZHeader{}.SVZa)
+	{
+		Fail("Not a valid SVZ file!");
+	}
+	else
+	{
+		if (!fileHeader.IsValid())
+			Fail("Not a valid SVZ file!");
+		for (uint32_t chunk = 0; chunk < fileHeader.numChunks; chunk++)
+		{
+			SVZHeaderEntry entry;
+			if (!Read(m_file, entry))
 			{
-				std::cerr << "Compressed data CRC32 mismatch!" << std::endl;
-				return {};
+				Fail("SVZ file is truncated!");
+				break;
 			}
+			m_chunks.push_back({entry.type, entry.offset, entry.size});
+		}
+	}
+
+	m_chunkData.resize(m_chunks.size());
+	m_chunkLoaded.resize(m_chunks.size());
+	m_file.clear();
+	m_file.seekg(0);
+}
+
+const SVZContainer::Chunk *SVZContainer::PatchChunk() const noexcept
+{
+	const auto chunk = std::find_if(m_chunks.begin(), m_chunks.end(), [](const Chunk &c) { return c.type == SVZHeaderEntry::EXTa || c.type == SVZHeaderEntry::MDLa; });
+	return (chunk != m_chunks.end()) ? &*chunk : nullptr;
+}
+
+bool SVZContainer::IsPluginFile() const noexcept
+{
+	const Chunk *chunk = PatchChunk();
+	return chunk && chunk->type == SVZHeaderEntry::EXTa;
+}
+
+bool SVZContainer::IsHardwareFile() const noexcept
+{
+	const Chunk *chunk = PatchChunk();
+	return chunk && chunk->type == SVZHeaderEntry::MDLa;
+}
 
-			mz_ulong uncompressedSize = chunkHeader.uncompressedSize;
-			std::vector<unsigned char> uncompressed(uncompressedSize);
-			if (mz_uncompress(uncompressed.data(), &uncompressedSize, compressed.data(), compressedSize) != Z_OK)
+std::span<const uint8_t> SVZContainer::ChunkData(const Chunk &chunk)
+{
+	const auto it = std::find_if(m_chunks.begin(), m_chunks.end(), [&chunk](const Chunk &c) { return &c == &chunk; });
+	if (it == m_chunks.end())
+		return {};
+
+	const size_t index = static_cast<size_t>(it - m_chunks.begin());
+	if (!m_chunkLoaded[index])
+	{
+		StageTimer timer{Stage::Read};
+		m_chunkLoaded[index] = true;
+		if (uint64_t{chunk.offset} + chunk.size > m_fileSize)
+		{
+			Fail("SVZ file is truncated!");
+			return {};
+		}
+		m_file.clear();
+		m_file.seekg(chunk.offset);
+		if (!ReadVector(m_file, m_chunkData[index], chunk.size))
+		{
+			m_chunkData[index].clear();
+			Fail("SVZ file is truncated!");
+		}
+	}
+	return m_chunkData[index];
+}
+
+uint32_t SVZContainer::NumPatches()
+{
+	LoadPatches();
+	return m_numPatches;
+}
+
+std::span<const uint8_t> SVZContainer::PatchData(const uint32_t index)
+{
+	LoadPatches();
+	if (index >= m_numPatches)
+		return {};
+	return m_patches.subspan(index * size_t(2048), 2048);
+}
+
+SVZModelID SVZContainer::PatchModel(const uint32_t index)
+{
+	const auto patch = PatchData(index);
+	if (patch.empty())
+		return {};
+	return HardwareModelID(patch.data());
+}
+
+bool SVZContainer::PatchCRC32Matches(const uint32_t index)
+{
+	const auto patch = PatchData(index);
+	if (patch.empty())
+		return false;
+	uint32le patchCRC32;
+	std::memcpy(&patchCRC32, m_patchCRC32s.data() + index * sizeof(uint32le), sizeof(patchCRC32));
+	return CRC32(patch.data(), patch.size()) == patchCRC32;
+}
+
+bool SVZContainer::Fail(const char *reason)
+{
+	if (m_error.empty())
+		m_error = reason;
+	return false;
+}
+
+void SVZContainer::LoadPatches()
+{
+	if (m_patchesLoaded)
+		return;
+	m_patchesLoaded = true;
+	if (!IsValid())
+		return;
+
+	const Chunk *chunk = PatchChunk();
+	if (!chunk)
+		Fail("SVZ file does not contain any patches!");
+	else if (chunk->type == SVZHeaderEntry::MDLa)
+		LoadHardwarePatches(*chunk);
+}
+
+bool SVZContainer::LoadHardwarePatches(const Chunk &chunk)
+{
+	const auto data = ChunkData(chunk);
+	SVZChunkHeaderMDLa chunkHeader;
+	if (data.size() < sizeof(chunkHeader))
+		return Fail("Not a valid SVZ file!");
+	std::memcpy(&chunkHeader, data.data(), sizeof(chunkHeader));
+	if (!chunkHeader.IsValid(chunk))
+		return Fail("Not a valid SVZ file!");
+	if (chunk.size != 16 + (sizeof(uint32le) + 2048) * uint64_t{chunkHeader.numPatches})
+		return Fail("SVZ file has unexpected length!");
+
+	m_numPatches = chunkHeader.numPatches;
+	m_patchCRC32s = data.subspan(sizeof(chunkHeader), sizeof(uint32le) * m_numPatches);
+	m_patches = data.subspan(sizeof(chunkHeader) + m_patchCRC32s.size());
+	return true;
+}
+
+// If namesOnly is true, only the name of each patch passed to the callback is valid, and checksums are not verified
+static bool ReadSVZ(std::istream &inFile, std::ostream &log, uint32_t &numCRCMismatches, std::pmr::memory_resource *memory, const bool namesOnly, const std::function<void(const PatchVST &)> &patchFunc)
+{
+	StageTimer timer{Stage::Read};
+	// Only the chunk table is taken from the container. The patches are streamed, so that memory usage does not depend on the number of patches.
+	const SVZContainer container{inFile, memory};
+	if (!container.IsValid())
+	{
+		log << container.Error() << std::endl;
+		return false;
+	}
+
+	const SVZContainer::Chunk *entry = container.PatchChunk();
+	if (!entry)
+		return false;
+
+	inFile.seekg(entry->offset, std::ios::beg);
+	if (container.IsHardwareFile())
+	{
+		SVZChunkHeaderMDLa chunkHeader;
+		if (!Read(inFile, chunkHeader))
+			return false;
+
+		if (!chunkHeader.IsValid(*entry))
+		{
+			log << "Not a valid SVZ file!" << std::endl;
+			return false;
+		}
+
+		if (entry->size != 16 + (sizeof(uint32le) + 2048) * chunkHeader.numPatches)
+		{
+			log << "SVZ file has unexpected length!" << std::endl;
+			return false;
+		}
+
+		const uint32_t numPatches = chunkHeader.numPatches;
+		PatchVST patch;
+		if (namesOnly)
+		{
+			// Skip the checksums and read nothing but the name at the start of each patch
+			const auto patchesStart = inFile.tellg() + std::streamoff(sizeof(uint32le) * numPatches);
+			for (uint32_t i = 0; i < numPatches; i++)
 			{
-				std::cerr << "Error during decompression!" << std::endl;
-				return {};
+				inFile.seekg(patchesStart + std::streamoff(i) * 2048);
+				if (!inFile.read(patch.name.data(), patch.name.size()))
+				{
+					log << "SVZ file is truncated!" << std::endl;
+					return false;
+				}
+				patchFunc(patch);
 			}
+			return true;
+		}
 
-			const SVDxHeader &svdHeader = *reinterpret_cast<const SVDxHeader *>(uncompressed.data());
-			if (!svdHeader.IsValid())
+		std::pmr::vector<uint32le> patchesCRC32{memory};
+		ReadVector(inFile, patchesCRC32, numPatches);
+
+		patch.zenHeader = PatchVST::DEFAULT_ZEN_HEADER;
+		std::array<unsigned char, 2048> patchData;
+		for (uint32_t i = 0; i < numPatches; i++)
+		{
+			if (!inFile.read(reinterpret_cast<char *>(patchData.data()), patchData.size()))
+			{
+				log << "SVZ file is truncated!" << std::endl;
+				return false;
+			}
+			const auto patchCRC32 = CRC32(patchData.data(), patchData.size());
+			if (patchCRC32 != patchesCRC32[i])
+			{
+				log << "Warning, CRC32 mismatch for patch " << (i + 1) << std::endl;
+				numCRCMismatches++;
+			}
+			if (HardwareModelID(patchData.data()) != SVZContainer::JD800_HARDWARE)
 			{
-				std::cerr << "Unexpected header after decompression!" << std::endl;
-				return {};
+				log << "Patches appear to be for different synth model!" << std::endl;
+				return false;
 			}
+			std::memcpy(&patch.name, patchData.data(), HARDWARE_PATCH_DATA_SIZE);
+			patchFunc(patch);
+		}
+		return true;
+	}
+	else
+	{
+		SVZChunkHeaderEXTa chunkHeader;
+		if (!Read(inFile, chunkHeader))
+			return false;
 
-			std::vector<PatchVST> vstPatches(svdHeader.numPatches);
-			std::memcpy(vstPatches.data(), uncompressed.data() + sizeof(svdHeader), vstPatches.size() * sizeof(PatchVST));
-			return vstPatches;
+		if (!chunkHeader.IsValid(*entry))
+		{
+			log << "Not a valid SVZ file!" << std::endl;
+			return false;
 		}
+
+		if (entry->size - 0x20 != chunkHeader.compressedSize)
+		{
+			log << "Compressed data has unexpected length!" << std::endl;
+			return false;
+		}
+
+		return ReadEXTa(inFile, chunkHeader, entry->size - 0x40, log, namesOnly, patchFunc);
 	}
-	return {};
 }
 
-std::vector<PatchVST> ReadSVD(std::istream &inFile)
+static std::pmr::vector<PatchVST> ReadSVZ(std::istream &inFile, std::ostream &log, uint32_t &numCRCMismatches, std::pmr::memory_resource *memory)
+{
+	std::pmr::vector<PatchVST> vstPatches{memory};
+	if (!ReadSVZ(inFile, log, numCRCMismatches, memory, false, [&vstPatches](const PatchVST &patch) { vstPatches.push_back(patch); }))
+		vstPatches.clear();
+	return vstPatches;
+}
+
+// If namesOnly is true, only the name of each patch passed to the callback is valid
+static bool ReadSVD(std::istream &inFile, std::ostream &log, const bool namesOnly, const std::function<void(const PatchVST &)> &patchFunc)
 {
+	StageTimer timer{Stage::Read};
 	static_assert(sizeof(SVDHeader) == 16);
 	static_assert(sizeof(SVDHeaderEntry) == 16);
 	
 	SVDHeader fileHeader;
 	if (!Read(inFile, fileHeader))
-		return {};
+		return false;
 
 	if (fileHeader.magic != SVDHeader{}.magic || fileHeader.headerSize < 30)
 	{
-		std::cerr << "Not a valid SVD file!" << std::endl;
-		return {};
+		log << "Not a valid SVD file!" << std::endl;
+		return false;
 	}
 
 	uint32_t headerOffset = 14, patchOffset = 0, patchSize = 0;
@@ -297,7 +635,7 @@ std::vector<PatchVST> ReadSVD(std::istream &inFile)
 	{
 		SVDHeaderEntry entry;
 		if (!Read(inFile, entry))
-			return {};
+			return false;
 		headerOffset += sizeof(entry);
 		if (entry.type == SVDHeaderEntry::PATCH_ENTRY && entry.dd07 == SVDHeaderEntry{}.dd07)
 		{
@@ -309,56 +647,181 @@ std::vector<PatchVST> ReadSVD(std::istream &inFile)
 
 	if (patchOffset == 0 || patchSize < 16)
 	{
-		std::cerr << "SVD file does not contain any patches!" << std::endl;
-		return {};
+		log << "SVD file does not contain any patches!" << std::endl;
+		return false;
 	}
 
 	inFile.seekg(patchOffset);
 	SVDPatchHeader patchHeader;
 	if (!Read(inFile, patchHeader))
-		return {};
+		return false;
 
 	if (patchHeader.patchSize != 2048)
 	{
-		std::cerr << "SVD file has unexpected patch size!" << std::endl;
-		return {};
+		log << "SVD file has unexpected patch size!" << std::endl;
+		return false;
 	}
 
 	if (patchHeader.unknown1 != SVDPatchHeader{}.unknown1 || patchHeader.unknown2 != SVDPatchHeader{}.unknown2)
 	{
-		std::cerr << "SVD file has unexpected patch header!" << std::endl;
-		return {};
+		log << "SVD file has unexpected patch header!" << std::endl;
+		return false;
 	}
 
-	std::vector<PatchVST> vstPatches(patchHeader.numPatches);
+	// SVD patches start with a header of the same size as the ZEN header and are followed by a small trailer
+	PatchVST patch;
+	std::array<char, 2048> patchData;
+	const auto patchesStart = inFile.tellg();
 	for (uint32_t i = 0; i < patchHeader.numPatches; i++)
 	{
-		PatchVST &patch = vstPatches[i];
-		inFile.read(reinterpret_cast<char *>(&patch.zenHeader), 2048);
-		patch.zenHeader = PatchVST::DEFAULT_ZEN_HEADER;
-		patch.empty.fill(0);
+		if (namesOnly)
+			inFile.seekg(patchesStart + std::streamoff(i) * 2048 + std::streamoff(offsetof(PatchVST, name)));
+		if (namesOnly ? !inFile.read(patch.name.data(), patch.name.size()) : !inFile.read(patchData.data(), patchData.size()))
+		{
+			log << "SVD file is truncated!" << std::endl;
+			return false;
+		}
+		if (!namesOnly)
+		{
+			std::memcpy(&patch, patchData.data(), sizeof(PatchVST));
+			patch.zenHeader = PatchVST::DEFAULT_ZEN_HEADER;
+		}
+		patchFunc(patch);
 	}
+	return true;
+}
+
+static std::pmr::vector<PatchVST> ReadSVD(std::istream &inFile, std::ostream &log, std::pmr::memory_resource *memory)
+{
+	std::pmr::vector<PatchVST> vstPatches{memory};
+	if (!ReadSVD(inFile, log, false, [&vstPatches](const PatchVST &patch) { vstPatches.push_back(patch); }))
+		vstPatches.clear();
 	return vstPatches;
 }
 
-void WriteSVZforPlugin(std::ostream &outFile, const std::vector<PatchVST> &vstPatches)
+std::pmr::vector<PatchVST> ReadSVZ(std::istream &inFile, std::pmr::memory_resource *memory)
+{
+	uint32_t numCRCMismatches = 0;
+	return ReadSVZ(inFile, std::cerr, numCRCMismatches, memory);
+}
+
+bool ReadSVZ(std::istream &inFile, const std::function<void(const PatchVST &patch)> &patchFunc)
+{
+	uint32_t numCRCMismatches = 0;
+	return ReadSVZ(inFile, std::cerr, numCRCMismatches, std::pmr::get_default_resource(), false, patchFunc);
+}
+
+bool ReadSVZNames(std::istream &inFile, const std::function<void(std::string_view name)> &nameFunc)
+{
+	uint32_t numCRCMismatches = 0;
+	return ReadSVZ(inFile, std::cerr, numCRCMismatches, std::pmr::get_default_resource(), true, [&nameFunc](const PatchVST &patch) { nameFunc(ToString(patch.name)); });
+}
+
+std::pmr::vector<PatchVST> ReadSVD(std::istream &inFile, std::pmr::memory_resource *memory)
+{
+	return ReadSVD(inFile, std::cerr, memory);
+}
+
+bool ReadSVDNames(std::istream &inFile, const std::function<void(std::string_view name)> &nameFunc)
+{
+	return ReadSVD(inFile, std::cerr, true, [&nameFunc](const PatchVST &patch) { nameFunc(ToString(patch.name)); });
+}
+
+// Turns the diagnostics of a reader into a single line
+static std::string FirstLine(const std::ostringstream &log)
+{
+	std::string str = log.str();
+	str = str.substr(0, str.find('\n'));
+	return str.empty() ? "Unknown error" : str;
+}
+
+ContainerCheck VerifySVZ(std::istream &inFile, std::pmr::memory_resource *memory)
+{
+	ContainerCheck result;
+	{
+		// Hardware files are checked patch by patch, so that patches for other synth models in mixed files can be counted
+		SVZContainer container{inFile, memory};
+		if (container.IsHardwareFile())
+		{
+			result.numPatches = container.NumPatches();
+			if (!container.IsValid())
+			{
+				result.numPatches = 0;
+				result.error = container.Error();
+				return result;
+			}
+			uint32_t numCRCMismatches = 0, numForeignPatches = 0;
+			for (uint32_t i = 0; i < result.numPatches; i++)
+			{
+				if (!container.PatchCRC32Matches(i))
+					numCRCMismatches++;
+				if (container.PatchModel(i) != SVZContainer::JD800_HARDWARE)
+					numForeignPatches++;
+			}
+			const std::string ofPatches = " of " + std::to_string(result.numPatches) + " patches";
+			if (numCRCMismatches)
+				result.error = "CRC32 mismatch for " + std::to_string(numCRCMismatches) + ofPatches;
+			if (numForeignPatches)
+				result.error += (result.error.empty() ? "" : "; ") + std::to_string(numForeignPatches) + ofPatches + " are for a different synth model";
+			return result;
+		}
+	}
+	inFile.clear();
+	inFile.seekg(0);
+
+	std::ostringstream log;
+	uint32_t numCRCMismatches = 0, numPatches = 0;
+	// The patches are only counted, so that verifying large files does not require much memory
+	const bool success = ReadSVZ(inFile, log, numCRCMismatches, memory, false, [&numPatches](const PatchVST &) { numPatches++; });
+	result.numPatches = success ? numPatches : 0;
+	if (!result.numPatches)
+		result.error = FirstLine(log);
+	else if (numCRCMismatches)
+		result.error = "CRC32 mismatch for " + std::to_string(numCRCMismatches) + " of " + std::to_string(numPatches) + " patches";
+	return result;
+}
+
+ContainerCheck VerifySVD(std::istream &inFile, std::pmr::memory_resource *memory)
 {
-	std::vector<unsigned char> uncompressed(sizeof(SVDxHeader) + vstPatches.size() * sizeof(PatchVST));
+	ContainerCheck result;
+	std::ostringstream log;
+	const auto patches = ReadSVD(inFile, log, memory);
+	result.numPatches = static_cast<uint32_t>(patches.size());
+	if (patches.empty())
+		result.error = FirstLine(log);
+	return result;
+}
+
+void WriteSVZforPlugin(std::ostream &outFile, std::span<const PatchVST> vstPatches, std::pmr::memory_resource *memory)
+{
+	StageTimer timer{Stage::Write};
+	// Zero-initialized, so the padding after each patch is already in place
+	std::pmr::vector<unsigned char> uncompressed(sizeof(SVDxHeader) + vstPatches.size() * PatchVST::FILE_SIZE, memory);
 	SVDxHeader &svdHeader = *reinterpret_cast<SVDxHeader *>(uncompressed.data());
 	svdHeader = SVDxHeader{};
 	svdHeader.numPatches = static_cast<uint32_t>(vstPatches.size());
-	std::memcpy(uncompressed.data() + sizeof(SVDxHeader), vstPatches.data(), vstPatches.size() * sizeof(PatchVST));
+	unsigned char *patchData = uncompressed.data() + sizeof(SVDxHeader);
+	for (const PatchVST &patch : vstPatches)
+	{
+		std::memcpy(patchData, &patch, sizeof(PatchVST));
+		patchData += PatchVST::FILE_SIZE;
+	}
 
 	mz_ulong uncompressedSize = static_cast<mz_ulong>(uncompressed.size());
 	mz_ulong compressedSize = mz_compressBound(uncompressedSize);
-	std::vector<unsigned char> compressed(compressedSize);
-	if (mz_compress2(compressed.data(), &compressedSize, uncompressed.data(), uncompressedSize, MZ_BEST_COMPRESSION) != Z_OK)
+	std::pmr::vector<unsigned char> compressed(compressedSize, memory);
 	{
-		std::cerr << "Error during compression!" << std::endl;
-		return;
+		StageTimer compressTimer{Stage::Compress};
+		if (mz_compress2(compressed.data(), &compressedSize, uncompressed.data(), uncompressedSize, MZ_BEST_COMPRESSION) != Z_OK)
+		{
+			std::cerr << "Error during compression!" << std::endl;
+			return;
+		}
 	}
+	Stats::Add(Counter::BytesUncompressed, uncompressedSize);
+	Stats::Add(Counter::BytesCompressed, compressedSize);
 	compressed.resize(compressedSize);
-	const auto compressedCRC32 = mz_crc32(0, compressed.data(), compressedSize);
+	const auto compressedCRC32 = CRC32(compressed.data(), compressedSize);
 
 	SVZHeader fileHeader{};
 	fileHeader.numChunks = 1;
@@ -378,10 +841,12 @@ void WriteSVZforPlugin(std::ostream &outFile, const std::vector<PatchVST> &vstPa
 	Write(outFile, chunkHeader);
 
 	WriteVector(outFile, compressed);
+	Stats::Add(Counter::BytesWritten, sizeof(fileHeader) + sizeof(entryEXTa) + sizeof(chunkHeader) + compressed.size());
 }
 
-void WriteSVZforHardware(std::ostream &outFile, const std::vector<PatchVST> &vstPatches)
+void WriteSVZforHardware(std::ostream &outFile, std::span<const PatchVST> vstPatches, std::pmr::memory_resource *memory)
 {
+	StageTimer timer{Stage::Write};
 	SVZHeader fileHeader{};
 	fileHeader.numChunks = 2;
 	fileHeader.numChunksRepeated = 2;
@@ -408,24 +873,26 @@ void WriteSVZforHardware(std::ostream &outFile, const std::vector<PatchVST> &vst
 	chunkHeader.chunkSizeTruncated = entryMDLa.size & 0x1FF;
 	Write(outFile, chunkHeader);
 
-	std::vector<uint32le> patchesCRC32(numPatches);
-	std::vector<std::array<unsigned char, 2048>> patches(numPatches);
+	std::pmr::vector<uint32le> patchesCRC32(numPatches, memory);
+	std::pmr::vector<std::array<unsigned char, 2048>> patches(numPatches, memory);
 	for (uint32_t i = 0; i < numPatches; i++)
 	{
 		auto &patch = patches[i];
-		std::memcpy(patch.data(), &vstPatches[i].name, 2048);
+		std::memcpy(patch.data(), &vstPatches[i].name, HARDWARE_PATCH_DATA_SIZE);
 		patch[2042] = 0x44;
 		patch[2045] = 0x01;
 		patch[2046] = 0x09;
-		patchesCRC32[i] = mz_crc32(0, patch.data(), patch.size());
+		patchesCRC32[i] = CRC32(patch.data(), patch.size());
 	}
 
 	WriteVector(outFile, patchesCRC32);
 	WriteVector(outFile, patches);
+	Stats::Add(Counter::BytesWritten, entryMDLa.offset + entryMDLa.size);
 }
 
-void WriteSVD(std::ostream &outFile, const std::vector<PatchVST> &vstPatches, const std::vector<char> &originalSVDfile)
+void WriteSVD(std::ostream &outFile, std::span<const PatchVST> vstPatches, const std::vector<char> &originalSVDfile, std::pmr::memory_resource *memory)
 {
+	StageTimer timer{Stage::Write};
 	// The JD-08 appears to reject SVD files that miss the PRFa, SYSa and/or DIFa chunks.
 	// Even if they only consist of the 16-byte header similar to the SVDPatchHeader struct and zeroing out the size fields in that header,
 	// the device just starts acting strangely. So the only solution for now is to take an existing SVD file and replace the patch data inside.
@@ -438,7 +905,7 @@ void WriteSVD(std::ostream &outFile, const std::vector<PatchVST> &vstPatches, co
 		return;
 	}
 
-	std::vector<SVDHeaderEntry> entries;
+	std::pmr::vector<SVDHeaderEntry> entries{memory};
 	bool hasPatchEntry = false;
 	for (uint32_t headerOffset = 14; headerOffset < fileHeader.headerSize; headerOffset += sizeof(SVDHeaderEntry))
 	{
@@ -474,7 +941,7 @@ void WriteSVD(std::ostream &outFile, const std::vector<PatchVST> &vstPatches, co
 			patchData[2044] = 8;
 			for (const auto &patch : vstPatches)
 			{
-				std::memcpy(patchData.data() + 16, &patch.name, 2016);
+				std::memcpy(patchData.data() + 16, &patch.name, HARDWARE_PATCH_DATA_SIZE);
 				Write(outFile, patchData);
 			}
 		}
@@ -497,5 +964,22 @@ void WriteSVD(std::ostream &outFile, const std::vector<PatchVST> &vstPatches, co
 
 	outFile.seekp(sizeof(fileHeader));
 	WriteVector(outFile, entries);
+	Stats::Add(Counter::BytesWritten, offset);
 }
 
+
+void WriteSVD(std::ostream &outFile, std::span<const PatchVST> vstPatches, std::pmr::memory_resource *memory)
+{
+	// Template file with an empty patch chunk, the header size does not include the size field itself
+	static const std::vector<char> templateFile = []()
+	{
+		SVDHeader fileHeader{};
+		fileHeader.headerSize = static_cast<uint16_t>(sizeof(SVDHeader) + sizeof(SVDHeaderEntry) - 2);
+		const SVDHeaderEntry entry{SVDHeaderEntry::PATCH_ENTRY};
+		std::vector<char> file(sizeof(fileHeader) + sizeof(entry));
+		std::memcpy(file.data(), &fileHeader, sizeof(fileHeader));
+		std::memcpy(file.data() + sizeof(fileHeader), &entry, sizeof(entry));
+		return file;
+	}();
+	WriteSVD(outFile, vstPatches, templateFile, memory);
+}
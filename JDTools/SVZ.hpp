@@ -4,13 +4,110 @@
 
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <iosfwd>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
 #include <vector>
 
 struct PatchVST;
 
-std::vector<PatchVST> ReadSVZ(std::istream &inFile);
-std::vector<PatchVST> ReadSVD(std::istream &inFile);
-void WriteSVZforPlugin(std::ostream &outFile, const std::vector<PatchVST> &vstPatches);
-void WriteSVZforHardware(std::ostream &outFile, const std::vector<PatchVST> &vstPatches);
-void WriteSVD(std::ostream &outFile, const std::vector<PatchVST> &vstPatches, const std::vector<char> &originalSVDfile);
+// Outcome of an integrity check of a patch container
+struct ContainerCheck
+{
+	uint32_t numPatches = 0;
+	std::string error;  // Empty if the file passed all checks
+};
+
+// The memory resource is used for the returned patches and all temporary buffers, e.g. an Arena that is reused for several files.
+std::pmr::vector<PatchVST> ReadSVZ(std::istream &inFile, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+std::pmr::vector<PatchVST> ReadSVD(std::istream &inFile, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+// Passes each patch to the callback as soon as it has been read. BIN files are decompressed incrementally,
+// so that memory usage does not depend on the number of patches. If false is returned, the file turned out to be invalid
+// and the patches that were already passed to the callback must be discarded.
+bool ReadSVZ(std::istream &inFile, const std::function<void(const PatchVST &patch)> &patchFunc);
+// Only read as much of the file as is needed to pass each patch name to the callback.
+// Checksums are not verified, and BIN files are only decompressed up to the last patch name.
+bool ReadSVZNames(std::istream &inFile, const std::function<void(std::string_view name)> &nameFunc);
+bool ReadSVDNames(std::istream &inFile, const std::function<void(std::string_view name)> &nameFunc);
+// Same checks as ReadSVZ / ReadSVD, but the diagnostics are returned instead of printed, and CRC32 mismatches are errors
+ContainerCheck VerifySVZ(std::istream &inFile, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+ContainerCheck VerifySVD(std::istream &inFile, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+// The memory resource is used for temporary buffers
+void WriteSVZforPlugin(std::ostream &outFile, std::span<const PatchVST> vstPatches, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+void WriteSVZforHardware(std::ostream &outFile, std::span<const PatchVST> vstPatches, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+void WriteSVD(std::ostream &outFile, std::span<const PatchVST> vstPatches, const std::vector<char> &originalSVDfile, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+// Writes an SVD file that only consists of the patch chunk. JDTools can read such files, but the JD-08 rejects them.
+void WriteSVD(std::ostream &outFile, std::span<const PatchVST> vstPatches, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+// Identifies the synth model a ZenCore patch was made for. Plugin patches carry the two IDs of their ZEN header,
+// hardware patches only have a single model byte in the trailer that follows the patch data.
+struct SVZModelID
+{
+	uint16_t id1 = 0;
+	uint16_t id2 = 0;
+
+	bool operator==(const SVZModelID &) const noexcept = default;
+};
+
+// Random access to the chunks and patches of an SVZ file of any ZenCore model, e.g. for splitting, merging or filtering files.
+// The chunk table is parsed once on construction. Chunk contents are only read when they are first accessed.
+// Patch access is limited to hardware (MDLa) files; the patches of plugin (BIN) files are decompressed by the streaming ReadSVZ.
+// The stream must outlive the container. Once the file turned out to be invalid, Error() explains why.
+class SVZContainer
+{
+public:
+	struct Chunk
+	{
+		std::array<char, 4> type{};
+		uint32_t offset = 0;
+		uint32_t size = 0;
+	};
+
+	static constexpr SVZModelID JD800_PLUGIN{3, 5};
+	static constexpr SVZModelID JD800_HARDWARE{1, 0};
+
+	explicit SVZContainer(std::istream &inFile, std::pmr::memory_resource *memory = std::pmr::get_default_resource());
+
+	SVZContainer(const SVZContainer &) = delete;
+	SVZContainer &operator=(const SVZContainer &) = delete;
+
+	// The chunk table is also available if the file header has unexpected values, so that the file type can still be detected
+	bool IsValid() const noexcept { return m_error.empty(); }
+	const std::string &Error() const noexcept { return m_error; }
+
+	// The first EXTa (plugin) or MDLa (hardware) chunk, which contains the patches
+	const Chunk *PatchChunk() const noexcept;
+	bool IsPluginFile() const noexcept;
+	bool IsHardwareFile() const noexcept;
+
+	// The patch chunk of hardware files is read on first access. If it is invalid, or this is a plugin file, there are no patches.
+	uint32_t NumPatches();
+	// Hardware patches consist of 2048 bytes including the trailer
+	std::span<const uint8_t> PatchData(uint32_t index);
+	SVZModelID PatchModel(uint32_t index);
+	bool PatchCRC32Matches(uint32_t index);
+
+private:
+	bool Fail(const char *reason);
+	// Contents of one of the chunks, read on first access. Empty if the chunk exceeds the file.
+	std::span<const uint8_t> ChunkData(const Chunk &chunk);
+	void LoadPatches();
+	bool LoadHardwarePatches(const Chunk &chunk);
+
+	std::istream &m_file;
+	std::string m_error;
+	uint64_t m_fileSize = 0;
+	std::pmr::vector<Chunk> m_chunks;
+	std::pmr::vector<std::pmr::vector<uint8_t>> m_chunkData;
+	std::pmr::vector<bool> m_chunkLoaded;
+	std::span<const uint8_t> m_patchCRC32s;
+	std::span<const uint8_t> m_patches;
+	uint32_t m_numPatches = 0;
+	bool m_patchesLoaded = false;
+};
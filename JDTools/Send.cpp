@@ -0,0 +1,137 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Send.hpp"
+#include "InputFile.hpp"
+#include "MidiTransport.hpp"
+#include "Stats.hpp"
+#include "SysEx.hpp"
+#include "Trace.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	// MIDI is transmitted at 31250 baud, with a start and a stop bit around each byte
+	constexpr std::chrono::microseconds WIRE_BYTE_TIME{10 * 1'000'000 / 31250};
+
+	double ToMilliseconds(const Clock::duration duration)
+	{
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+}
+
+int SendSysEx(std::string_view inFilename, std::string_view port, const std::chrono::milliseconds processingTime)
+{
+	const std::string inFilenameStr{inFilename};
+	TraceScope fileScope{"file", "input file", inFilenameStr};
+	std::ifstream inFile{inFilenameStr, std::ios::binary};
+	if (!inFile)
+	{
+		std::cout << "Could not open " << inFilename << " for reading!" << std::endl;
+		return 2;
+	}
+
+	InputFile inputFile{inFile};
+	if (inputFile.GetType() != InputFile::Type::SYX && inputFile.GetType() != InputFile::Type::MID)
+	{
+		std::cout << "Only SysEx dumps (SYX / MID) can be sent! Use the convert verb to create one first." << std::endl;
+		return 2;
+	}
+
+	std::vector<uint8_t> buffer;
+	std::vector<SysExFrame> frames;
+	inputFile.ReadAllSysExMessages(buffer, frames);
+	if (frames.empty())
+	{
+		std::cout << "Input didn't contain any SysEx messages!" << std::endl;
+		return 2;
+	}
+
+	// Everything is checked before the first byte is sent, so that the device never receives only a part of a broken dump
+	std::vector<SysExFrame> checksumFrames;
+	std::vector<size_t> checksumMessages;
+	size_t totalBytes = 0;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const SysExFrame &frame = frames[i];
+		const uint8_t *messageData = buffer.data() + frame.offset;
+		if (frame.size < 2 || messageData[frame.size - 1] != 0xF7)
+		{
+			std::cout << "SysEx message " << (i + 1) << " is truncated!" << std::endl;
+			return 3;
+		}
+		// Roland Data Set messages: manufacturer, device ID, model ID, command, address, data, checksum, EOX
+		if (frame.size >= 7 && messageData[0] == 0x41 && messageData[3] == 0x12)
+		{
+			checksumFrames.push_back({frame.offset + 4, frame.size - 5});
+			checksumMessages.push_back(i);
+		}
+		totalBytes += frame.size + 1;
+	}
+	const std::vector<bool> checksumValid = VerifyRolandChecksums(buffer, checksumFrames);
+	if (const auto invalid = std::find(checksumValid.begin(), checksumValid.end(), false); invalid != checksumValid.end())
+	{
+		std::cout << "Invalid SysEx checksum in message " << (checksumMessages[invalid - checksumValid.begin()] + 1) << "!" << std::endl;
+		return 3;
+	}
+
+	const auto transport = OpenMidiTransport(port);
+	if (!transport)
+		return 2;
+
+	std::cout << "Sending " << frames.size() << " SysEx messages (" << totalBytes << " bytes) to " << transport->Description() << "..." << std::endl;
+
+	// Each message is scheduled for the moment the previous one has left the MIDI cable and has been processed by the device.
+	// If a message is sent late, the schedule continues from there, so that the device never gets less time than it needs.
+	const auto start = Clock::now();
+	auto nextMessage = start, transmissionEnd = start;
+	Clock::duration maxLateness{}, totalLateness{};
+	std::vector<uint8_t> message;
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const SysExFrame &frame = frames[i];
+		message.assign(1, 0xF0);
+		message.insert(message.end(), buffer.begin() + frame.offset, buffer.begin() + frame.offset + frame.size);
+
+		std::this_thread::sleep_until(nextMessage);
+		const auto now = Clock::now();
+		maxLateness = std::max(maxLateness, now - nextMessage);
+		totalLateness += now - nextMessage;
+		{
+			TraceScope messageScope{"send", "SysEx message"};
+			if (!transport->Write(message))
+			{
+				std::cout << "Error while sending SysEx message " << (i + 1) << "!" << std::endl;
+				return 2;
+			}
+		}
+		transmissionEnd = now + WIRE_BYTE_TIME * message.size();
+		nextMessage = transmissionEnd + processingTime;
+	}
+	transport->Drain();
+	std::this_thread::sleep_until(transmissionEnd);
+	const auto elapsed = Clock::now() - start;
+
+	Stats::Add(Counter::BytesWritten, totalBytes);
+
+	const double seconds = std::chrono::duration<double>(elapsed).count();
+	const double bytesPerSecond = totalBytes / std::max(seconds, 1e-9);
+	const double wireBytesPerSecond = 1e6 / WIRE_BYTE_TIME.count();
+	std::cout << std::fixed << std::setprecision(2)
+		<< "Sent " << frames.size() << " SysEx messages (" << totalBytes << " bytes) in " << seconds << " seconds." << std::endl
+		<< "Throughput: " << std::setprecision(0) << bytesPerSecond << " bytes/s, " << (100.0 * bytesPerSecond / wireBytesPerSecond) << "% of the MIDI wire rate." << std::endl
+		<< "Processing time per message: " << processingTime.count() << " ms, messages were sent up to " << std::setprecision(2) << ToMilliseconds(maxLateness)
+		<< " ms late (" << ToMilliseconds(totalLateness / frames.size()) << " ms on average)." << std::endl;
+	return 0;
+}
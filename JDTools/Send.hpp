@@ -0,0 +1,17 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <chrono>
+#include <string_view>
+
+// Time a JD-800 / JD-990 is given to process a Data Set message after it has been received completely.
+// Roland devices generally expect at least 20 ms between consecutive Data Set messages.
+inline constexpr std::chrono::milliseconds DEFAULT_SYSEX_PROCESSING_TIME{20};
+
+// Sends all SysEx messages of a SYX / MID file to a MIDI port (see OpenMidiTransport).
+// Each message is sent as soon as the previous one has been transmitted at MIDI speed and the device had the given time to process it.
+// All checksums are verified before anything is sent. Returns the program exit code.
+int SendSysEx(std::string_view inFilename, std::string_view port, std::chrono::milliseconds processingTime);
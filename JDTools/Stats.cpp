@@ -0,0 +1,130 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Stats.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	constexpr std::array<std::string_view, StatsSnapshot::NUM_STAGES> STAGE_NAMES = { "read", "checksum", "decompress", "convert", "compress", "write" };
+	constexpr std::array<std::string_view, StatsSnapshot::NUM_COUNTERS> COUNTER_NAMES = { "bytesRead", "messagesFramed", "patchesConverted", "bytesUncompressed", "bytesCompressed", "bytesWritten", "heapAllocations", "arenaAllocations" };
+
+	thread_local StageTimer *t_currentTimer = nullptr;
+}
+
+double StatsSnapshot::CompressionRatio() const noexcept
+{
+	const uint64_t uncompressed = (*this)[Counter::BytesUncompressed];
+	return uncompressed ? static_cast<double>((*this)[Counter::BytesCompressed]) / static_cast<double>(uncompressed) : 0.0;
+}
+
+void Stats::AddTime(const Stage stage, const uint64_t nanoseconds) noexcept
+{
+	m_stageNanoseconds[static_cast<size_t>(stage)].fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+StatsSnapshot Stats::Get() noexcept
+{
+	StatsSnapshot stats;
+	for (size_t i = 0; i < StatsSnapshot::NUM_STAGES; i++)
+	{
+		stats.stageNanoseconds[i] = m_stageNanoseconds[i].load(std::memory_order_relaxed);
+		stats.stageCalls[i] = m_stageCalls[i].load(std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < StatsSnapshot::NUM_COUNTERS; i++)
+	{
+		stats.counters[i] = m_counters[i].load(std::memory_order_relaxed);
+	}
+	return stats;
+}
+
+void Stats::Reset() noexcept
+{
+	for (auto &value : m_stageNanoseconds)
+		value.store(0, std::memory_order_relaxed);
+	for (auto &value : m_stageCalls)
+		value.store(0, std::memory_order_relaxed);
+	for (auto &value : m_counters)
+		value.store(0, std::memory_order_relaxed);
+}
+
+void Stats::Print(std::ostream &os, const StatsSnapshot &stats)
+{
+	const auto flags = os.flags();
+	const auto precision = os.precision();
+	os << "\nStatistics (stage times are summed up over all threads):\n";
+	for (size_t i = 0; i < StatsSnapshot::NUM_STAGES; i++)
+	{
+		if (!stats.stageCalls[i])
+			continue;
+		os << "  " << std::left << std::setw(12) << STAGE_NAMES[i] << std::right << std::fixed << std::setprecision(3)
+			<< std::setw(12) << (static_cast<double>(stats.stageNanoseconds[i]) / 1e6) << " ms"
+			<< std::setw(10) << stats.stageCalls[i] << " calls\n";
+	}
+	os << "  Bytes read:              " << stats[Counter::BytesRead] << "\n"
+		<< "  SysEx messages framed:   " << stats[Counter::MessagesFramed] << "\n"
+		<< "  Patches converted:       " << stats[Counter::PatchesConverted] << "\n"
+		<< "  Bytes uncompressed:      " << stats[Counter::BytesUncompressed] << "\n"
+		<< "  Bytes compressed:        " << stats[Counter::BytesCompressed];
+	if (stats[Counter::BytesUncompressed])
+		os << " (ratio " << std::fixed << std::setprecision(3) << stats.CompressionRatio() << ")";
+	os << "\n"
+		<< "  Bytes written:           " << stats[Counter::BytesWritten] << "\n"
+		<< "  Heap allocations:        " << stats[Counter::HeapAllocations] << "\n"
+		<< "  Arena allocations:       " << stats[Counter::ArenaAllocations] << std::endl;
+	os.flags(flags);
+	os.precision(precision);
+}
+
+bool Stats::WriteJSON(std::string_view filename, const StatsSnapshot &stats)
+{
+	std::ofstream f{std::string{filename}, std::ios::trunc};
+	if (!f)
+		return false;
+	f << "{\n  \"stages\": {";
+	for (size_t i = 0; i < StatsSnapshot::NUM_STAGES; i++)
+	{
+		f << (i ? ",\n" : "\n") << "    \"" << STAGE_NAMES[i] << "\": { \"nanoseconds\": " << stats.stageNanoseconds[i] << ", \"calls\": " << stats.stageCalls[i] << " }";
+	}
+	f << "\n  },\n  \"counters\": {";
+	for (size_t i = 0; i < StatsSnapshot::NUM_COUNTERS; i++)
+	{
+		f << (i ? ",\n" : "\n") << "    \"" << COUNTER_NAMES[i] << "\": " << stats.counters[i];
+	}
+	f << "\n  },\n  \"compressionRatio\": " << stats.CompressionRatio() << "\n}\n";
+	return static_cast<bool>(f);
+}
+
+void StageTimer::Start() noexcept
+{
+	if (m_traced)
+		Trace::Begin("stage", STAGE_NAMES[static_cast<size_t>(m_stage)].data());
+	if (!m_enabled)
+		return;
+	m_start = Clock::now();
+	m_parent = t_currentTimer;
+	// Pause the enclosing timer
+	if (m_parent)
+		Stats::AddTime(m_parent->m_stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(m_start - m_parent->m_start).count()));
+	t_currentTimer = this;
+}
+
+void StageTimer::Stop() noexcept
+{
+	if (m_traced)
+		Trace::End();
+	if (!m_enabled)
+		return;
+	const auto now = Clock::now();
+	Stats::AddTime(m_stage, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - m_start).count()));
+	Stats::m_stageCalls[static_cast<size_t>(m_stage)].fetch_add(1, std::memory_order_relaxed);
+	// Resume the enclosing timer
+	if (m_parent)
+		m_parent->m_start = now;
+	t_currentTimer = m_parent;
+}
@@ -0,0 +1,122 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include "Trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string_view>
+
+// Processing stages that are timed while statistics are enabled
+enum class Stage : uint8_t
+{
+	Read,        // Reading and parsing input files
+	Checksum,    // Verifying and calculating SysEx checksums and CRC32
+	Decompress,
+	Convert,     // Converting patches and special setups between formats
+	Compress,
+	Write,       // Serializing and writing output files
+
+	NumStages
+};
+
+// Quantities that are counted while statistics are enabled
+enum class Counter : uint8_t
+{
+	BytesRead,
+	MessagesFramed,     // SysEx messages extracted from SYX and MID files
+	PatchesConverted,   // Includes special setups
+	BytesUncompressed,  // Data before compression or after decompression
+	BytesCompressed,    // Data after compression or before decompression
+	BytesWritten,
+	HeapAllocations,    // Calls to operator new
+	ArenaAllocations,   // Temporary buffers allocated from an Arena instead of the heap
+
+	NumCounters
+};
+
+struct StatsSnapshot
+{
+	static constexpr size_t NUM_STAGES = static_cast<size_t>(Stage::NumStages);
+	static constexpr size_t NUM_COUNTERS = static_cast<size_t>(Counter::NumCounters);
+
+	std::array<uint64_t, NUM_STAGES> stageNanoseconds{};  // Summed up over all threads
+	std::array<uint64_t, NUM_STAGES> stageCalls{};
+	std::array<uint64_t, NUM_COUNTERS> counters{};
+
+	uint64_t operator[](Counter counter) const noexcept { return counters[static_cast<size_t>(counter)]; }
+	// Compressed size relative to uncompressed size, 0 if nothing was compressed
+	double CompressionRatio() const noexcept;
+};
+
+// Process-wide, thread-safe instrumentation of the processing stages.
+// While disabled (the default), recording a value only costs a relaxed atomic load.
+class Stats
+{
+public:
+	static void Enable(bool enable) noexcept { m_enabled.store(enable, std::memory_order_relaxed); }
+	static bool IsEnabled() noexcept { return m_enabled.load(std::memory_order_relaxed); }
+
+	static void Add(Counter counter, uint64_t value) noexcept
+	{
+		if (IsEnabled())
+			m_counters[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+	}
+	static void AddTime(Stage stage, uint64_t nanoseconds) noexcept;
+
+	static StatsSnapshot Get() noexcept;
+	static void Reset() noexcept;
+
+	static void Print(std::ostream &os, const StatsSnapshot &stats);
+	static bool WriteJSON(std::string_view filename, const StatsSnapshot &stats);
+
+private:
+	friend class StageTimer;
+
+	static inline std::atomic<bool> m_enabled = false;
+	static inline std::array<std::atomic<uint64_t>, StatsSnapshot::NUM_STAGES> m_stageNanoseconds{};
+	static inline std::array<std::atomic<uint64_t>, StatsSnapshot::NUM_STAGES> m_stageCalls{};
+	static inline std::array<std::atomic<uint64_t>, StatsSnapshot::NUM_COUNTERS> m_counters{};
+};
+
+// Adds the time until the end of the scope to a stage, and records it as a trace event if tracing is enabled.
+// Timers can be nested: The enclosing timer is paused while an inner timer runs, so that no time is counted twice.
+class StageTimer
+{
+public:
+	explicit StageTimer(Stage stage) noexcept
+		: m_stage{stage}
+		, m_enabled{Stats::IsEnabled()}
+		, m_traced{Trace::IsEnabled()}
+	{
+		if (m_enabled || m_traced)
+			Start();
+	}
+
+	~StageTimer()
+	{
+		if (m_enabled || m_traced)
+			Stop();
+	}
+
+	StageTimer(const StageTimer &) = delete;
+	StageTimer &operator=(const StageTimer &) = delete;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	void Start() noexcept;
+	void Stop() noexcept;
+
+	Stage m_stage;
+	bool m_enabled;
+	bool m_traced;
+	Clock::time_point m_start;
+	StageTimer *m_parent = nullptr;
+};
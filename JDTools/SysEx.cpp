@@ -0,0 +1,102 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "SysEx.hpp"
+#include "Stats.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JDTOOLS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	constexpr uint8_t SYSEX_DEVICE_ID = 0x10;
+}
+
+static uint32_t SumBytes(const uint8_t *data, size_t size) noexcept
+{
+	uint32_t sum = 0;
+#ifdef JDTOOLS_SSE2
+	// PSADBW against zero yields the horizontal sum of each group of 8 bytes
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc = zero;
+	while (size >= 16)
+	{
+		acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), zero));
+		data += 16;
+		size -= 16;
+	}
+	sum = static_cast<uint32_t>(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(acc, acc)));
+#endif
+	while (size--)
+	{
+		sum += *data++;
+	}
+	return sum;
+}
+
+uint8_t RolandChecksum(const uint8_t *data, size_t size) noexcept
+{
+	return static_cast<uint8_t>(0x80 - (SumBytes(data, size) & 0x7F)) & 0x7F;
+}
+
+std::vector<bool> VerifyRolandChecksums(std::span<const uint8_t> buffer, std::span<const SysExFrame> frames)
+{
+	StageTimer timer{Stage::Checksum};
+	std::vector<bool> valid(frames.size());
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		const SysExFrame &frame = frames[i];
+		if (frame.offset <= buffer.size() && frame.size <= buffer.size() - frame.offset)
+			valid[i] = (SumBytes(buffer.data() + frame.offset, frame.size) & 0x7F) == 0;
+	}
+	return valid;
+}
+
+void BuildDataSet(uint32_t address, const bool isJD990, const uint8_t *data, size_t size, const std::function<void(const std::vector<uint8_t> &message)> &messageFunc)
+{
+	// debug stuff
+	for (size_t i = 0; i < size; i++)
+	{
+		if (data[i] >= 0x80)
+		{
+			std::cerr << "invalid byte in SysEx data block at " << i << " - either broken parameter conversion or broken SysEx source!" << std::endl;
+		}
+	}
+
+	// Reused so that writing many messages does not allocate memory for each of them
+	thread_local std::vector<uint8_t> outMessage;
+	size_t offset = 0;
+	while (size)
+	{
+		const size_t amountToCopy = std::min(size, size_t(256));
+		if (isJD990)
+			outMessage.assign({ 0xF0, 0x41, SYSEX_DEVICE_ID, 0x57, 0x12, static_cast<uint8_t>((address >> 21) & 0x7F), static_cast<uint8_t>((address >> 14) & 0x7F), static_cast<uint8_t>((address >> 7) & 0x7F), static_cast<uint8_t>(address & 0x7F) });
+		else
+			outMessage.assign({ 0xF0, 0x41, SYSEX_DEVICE_ID, 0x3D, 0x12, static_cast<uint8_t>((address >> 14) & 0x7F), static_cast<uint8_t>((address >> 7) & 0x7F), static_cast<uint8_t>(address & 0x7F) });
+		outMessage.insert(outMessage.end(), data + offset, data + offset + amountToCopy);
+		outMessage.push_back(RolandChecksum(outMessage.data() + 5, outMessage.size() - 5));
+		outMessage.push_back(0xF7);
+		messageFunc(outMessage);
+
+		address += static_cast<uint32_t>(amountToCopy);
+		size -= amountToCopy;
+		offset += amountToCopy;
+	}
+}
+
+void WriteSysEx(std::ostream &f, uint32_t address, const bool isJD990, const uint8_t *data, size_t size)
+{
+	StageTimer timer{Stage::Write};
+	BuildDataSet(address, isJD990, data, size, [&f](const std::vector<uint8_t> &message)
+	{
+		WriteVector(f, message);
+		Stats::Add(Counter::BytesWritten, message.size());
+	});
+}
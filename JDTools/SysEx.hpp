@@ -0,0 +1,41 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+// Location of a message inside a buffer holding many SysEx messages
+struct SysExFrame
+{
+	size_t offset;
+	size_t size;
+};
+
+// Returns the Roland checksum for the given address and data bytes.
+// When passing the checksum byte as well, the result is 0 for an intact message.
+uint8_t RolandChecksum(const uint8_t *data, size_t size) noexcept;
+
+// Verifies the Roland checksums of all framed messages at once.
+// Each frame must span the address, data and checksum bytes of a Data Set message.
+// Bit n of the result is set if message n passed the test.
+std::vector<bool> VerifyRolandChecksums(std::span<const uint8_t> buffer, std::span<const SysExFrame> frames);
+
+// Builds the Data Set messages (F0 ... F7) that write a block of data to the given address of a JD-800 or JD-990.
+// The data is split into messages of at most 256 bytes, messageFunc is called for each complete message.
+void BuildDataSet(uint32_t address, bool isJD990, const uint8_t *data, size_t size, const std::function<void(const std::vector<uint8_t> &message)> &messageFunc);
+
+// Writes a block of data as Data Set messages to a SysEx file
+void WriteSysEx(std::ostream &f, uint32_t address, bool isJD990, const uint8_t *data, size_t size);
+
+template<typename T>
+void WriteSysEx(std::ostream &f, uint32_t address, bool isJD990, const T &object)
+{
+	WriteSysEx(f, address, isJD990, reinterpret_cast<const uint8_t *>(&object), sizeof(object));
+}
@@ -0,0 +1,209 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Trace.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Event
+	{
+		static constexpr size_t MAX_DETAIL_LENGTH = 62;
+
+		uint64_t timestamp;  // Nanoseconds since tracing was enabled
+		const char *category;
+		const char *name;
+		char phase;  // 'B' or 'E'
+		uint8_t detailLength;
+		char detail[MAX_DETAIL_LENGTH];
+	};
+
+	// Ring buffer that is only ever written by its owning thread.
+	// Its blocks are allocated as they are needed, so that threads which only record a few events stay small.
+	struct ThreadBuffer
+	{
+		static constexpr uint64_t BLOCK_SIZE = 1 << 10;
+		static constexpr uint64_t NUM_BLOCKS = 64;
+		static constexpr uint64_t CAPACITY = BLOCK_SIZE * NUM_BLOCKS;
+
+		Event &operator[](const uint64_t index) const noexcept
+		{
+			return blocks[(index / BLOCK_SIZE) % NUM_BLOCKS][index % BLOCK_SIZE];
+		}
+
+		uint32_t threadID = 0;
+		bool outOfMemory = false;  // Once a block could not be allocated, all further events of the thread are dropped
+		std::array<std::unique_ptr<Event[]>, NUM_BLOCKS> blocks;
+		std::atomic<uint64_t> numEvents = 0;  // Total number of recorded events, including the discarded ones
+	};
+
+	// Buffers outlive their threads so that events of finished worker threads can still be written
+	std::mutex g_buffersMutex;
+	std::vector<std::unique_ptr<ThreadBuffer>> g_buffers;
+	std::atomic<uint32_t> g_generation = 0;  // Incremented when the buffers are freed, so that threads register a new buffer
+	Clock::time_point g_epoch;
+
+	thread_local ThreadBuffer *t_buffer = nullptr;
+	thread_local uint32_t t_generation = 0;
+
+	// Returns nullptr if the buffer could not be allocated
+	ThreadBuffer *GetThreadBuffer() noexcept
+	{
+		const uint32_t generation = g_generation.load(std::memory_order_relaxed);
+		if (!t_buffer || t_generation != generation)
+		{
+			t_buffer = nullptr;
+			try
+			{
+				auto buffer = std::make_unique<ThreadBuffer>();
+				std::lock_guard lock{g_buffersMutex};
+				buffer->threadID = static_cast<uint32_t>(g_buffers.size() + 1);
+				t_buffer = g_buffers.emplace_back(std::move(buffer)).get();
+				t_generation = generation;
+			}
+			catch (const std::bad_alloc &)
+			{
+				return nullptr;
+			}
+		}
+		return t_buffer;
+	}
+
+	uint64_t Now() noexcept
+	{
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - g_epoch).count());
+	}
+
+	void Record(const char phase, const char *category, const char *name, std::string_view detail) noexcept
+	{
+		ThreadBuffer *buffer = GetThreadBuffer();
+		if (!buffer || buffer->outOfMemory)
+			return;
+		const uint64_t index = buffer->numEvents.load(std::memory_order_relaxed);
+		if (auto &block = buffer->blocks[(index / ThreadBuffer::BLOCK_SIZE) % ThreadBuffer::NUM_BLOCKS]; !block)
+		{
+			block.reset(new (std::nothrow) Event[ThreadBuffer::BLOCK_SIZE]);
+			if (!block)
+			{
+				buffer->outOfMemory = true;
+				return;
+			}
+		}
+		Event &event = (*buffer)[index];
+		event.timestamp = Now();
+		event.category = category;
+		event.name = name;
+		event.phase = phase;
+		// Keep the end of long details (usually file paths), without splitting a UTF-8 sequence
+		if (detail.size() > Event::MAX_DETAIL_LENGTH)
+		{
+			size_t start = detail.size() - Event::MAX_DETAIL_LENGTH;
+			while (start < detail.size() && (static_cast<uint8_t>(detail[start]) & 0xC0) == 0x80)
+				start++;
+			detail.remove_prefix(start);
+		}
+		event.detailLength = static_cast<uint8_t>(detail.size());
+		std::memcpy(event.detail, detail.data(), detail.size());
+		buffer->numEvents.store(index + 1, std::memory_order_release);
+	}
+
+	void WriteTimestamp(std::ostream &f, const uint64_t nanoseconds)
+	{
+		// Trace event timestamps are in microseconds
+		const auto fraction = std::to_string(nanoseconds % 1000);
+		f << (nanoseconds / 1000) << '.' << std::string(3 - fraction.size(), '0') << fraction;
+	}
+}
+
+void Trace::Enable(const bool enable) noexcept
+{
+	if (enable && !IsEnabled())
+		g_epoch = Clock::now();
+	m_enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Trace::Begin(const char *category, const char *name, std::string_view detail) noexcept
+{
+	Record('B', category, name, detail);
+}
+
+void Trace::End() noexcept
+{
+	Record('E', nullptr, nullptr, {});
+}
+
+bool Trace::WriteJSON(std::string_view filename)
+{
+	std::ofstream f{std::string{filename}, std::ios::trunc};
+	if (!f)
+		return false;
+
+	const uint64_t now = Now();
+	std::lock_guard lock{g_buffersMutex};
+	f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool first = true;
+	for (const auto &buffer : g_buffers)
+	{
+		const auto threadPrefix = ",\"pid\":1,\"tid\":" + std::to_string(buffer->threadID);
+		// The trace is written by the main thread
+		const std::string threadName = (buffer.get() == t_buffer) ? std::string{"Main thread"} : std::string{"Worker thread "}.append(std::to_string(buffer->threadID));
+		f << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\"" << threadPrefix << ",\"args\":{\"name\":\"" << threadName << "\"}}";
+		first = false;
+
+		const uint64_t numEvents = buffer->numEvents.load(std::memory_order_acquire);
+		const uint64_t firstEvent = numEvents > ThreadBuffer::CAPACITY ? numEvents - ThreadBuffer::CAPACITY : 0;
+		uint64_t depth = 0, lastTimestamp = 0;
+		for (uint64_t i = firstEvent; i < numEvents; i++)
+		{
+			const Event &event = (*buffer)[i];
+			// End events whose begin event was discarded from the ring buffer cannot be matched
+			if (event.phase == 'E' && !depth)
+				continue;
+			f << ",\n{\"ph\":\"" << event.phase << "\",\"ts\":";
+			WriteTimestamp(f, event.timestamp);
+			f << threadPrefix;
+			if (event.phase == 'B')
+			{
+				f << ",\"cat\":\"" << event.category << "\",\"name\":\"" << event.name << "\"";
+				if (event.detailLength)
+					f << ",\"args\":{\"detail\":\"" << EscapeJSON({event.detail, event.detailLength}) << "\"}";
+				depth++;
+			}
+			else
+			{
+				depth--;
+			}
+			f << "}";
+			lastTimestamp = event.timestamp;
+		}
+		// Close scopes that are still open, e.g. if the trace is written from within a scope
+		for (; depth; depth--)
+		{
+			f << ",\n{\"ph\":\"E\",\"ts\":";
+			WriteTimestamp(f, std::max(now, lastTimestamp));
+			f << threadPrefix << "}";
+		}
+	}
+	f << "\n]}\n";
+
+	// The events are not needed anymore. Threads that record further events start over with a new buffer.
+	g_buffers.clear();
+	g_buffers.shrink_to_fit();
+	g_generation++;
+	return static_cast<bool>(f);
+}
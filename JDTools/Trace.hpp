@@ -0,0 +1,54 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <atomic>
+#include <string_view>
+
+// Records begin / end events of processing steps for inspection in Perfetto or chrome://tracing.
+// Every thread records into its own ring buffer, so recording an event never takes a lock.
+// If a thread records more events than fit into its buffer, its oldest events are discarded. If memory runs out, new events are dropped.
+// While disabled (the default), recording an event only costs a relaxed atomic load.
+class Trace
+{
+public:
+	static void Enable(bool enable) noexcept;
+	static bool IsEnabled() noexcept { return m_enabled.load(std::memory_order_relaxed); }
+
+	// category and name must be string literals, detail is copied (and possibly truncated)
+	static void Begin(const char *category, const char *name, std::string_view detail = {}) noexcept;
+	static void End() noexcept;
+
+	// Writes all recorded events in the Chrome Trace Event format and frees them afterwards.
+	// Must not be called while other threads are still recording events.
+	static bool WriteJSON(std::string_view filename);
+
+private:
+	static inline std::atomic<bool> m_enabled = false;
+};
+
+// Records a begin event now and the matching end event at the end of the scope
+class TraceScope
+{
+public:
+	TraceScope(const char *category, const char *name, std::string_view detail = {}) noexcept
+		: m_enabled{Trace::IsEnabled()}
+	{
+		if (m_enabled)
+			Trace::Begin(category, name, detail);
+	}
+
+	~TraceScope()
+	{
+		if (m_enabled)
+			Trace::End();
+	}
+
+	TraceScope(const TraceScope &) = delete;
+	TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+	bool m_enabled;
+};
@@ -4,10 +4,18 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 struct uint16le
@@ -53,8 +61,8 @@ static bool Read(std::istream &f, T &value)
 	return f.read(reinterpret_cast<char *>(&value), sizeof(value)).good();
 }
 
-template<typename T>
-static bool ReadVector(std::istream &f, std::vector<T> &value, const size_t numElements)
+template<typename T, typename Allocator>
+static bool ReadVector(std::istream &f, std::vector<T, Allocator> &value, const size_t numElements)
 {
 	static_assert(alignof(T) == 1);
 	value.resize(numElements);
@@ -68,8 +76,8 @@ static void Write(std::ostream &f, const T &value)
 	f.write(reinterpret_cast<const char *>(&value), sizeof(value));
 }
 
-template<typename T>
-static void WriteVector(std::ostream &f, const std::vector<T> &value)
+template<typename T, typename Allocator>
+static void WriteVector(std::ostream &f, const std::vector<T, Allocator> &value)
 {
 	static_assert(alignof(T) == 1);
 	f.write(reinterpret_cast<const char *>(value.data()), value.size() * sizeof(T));
@@ -96,6 +104,131 @@ static bool CompareMagic(const std::array<char, N> &left, const char(&right)[N +
 	return !std::memcmp(left.data(), right, N);
 }
 
+// The converters report lossy conversions on std::cerr. While patches are converted on several threads, std::cerr can be redirected to this buffer,
+// which keeps the output of each thread separate so that it can be attributed to the patch being converted.
+class ThreadLocalCapture : public std::streambuf
+{
+public:
+	static std::string &Buffer()
+	{
+		thread_local std::string buffer;
+		return buffer;
+	}
+
+protected:
+	int_type overflow(int_type ch) override
+	{
+		if (!traits_type::eq_int_type(ch, traits_type::eof()))
+			Buffer().push_back(traits_type::to_char_type(ch));
+		return traits_type::not_eof(ch);
+	}
+
+	std::streamsize xsputn(const char *s, std::streamsize count) override
+	{
+		Buffer().append(s, static_cast<size_t>(count));
+		return count;
+	}
+};
+
+// Inserts the bank number before the file extension, e.g. "patches.syx" becomes "patches.2.syx" for the second bank
+static inline std::string BankFilename(std::string_view baseName, size_t bank, std::string_view ext)
+{
+	std::string filename;
+	if (baseName.size() > 4 && baseName[baseName.size() - 4] == '.')
+		filename.append(baseName.substr(0, baseName.size() - 3)).append(std::to_string(bank + 1)).append(baseName.substr(baseName.size() - 4));
+	else
+		filename.append(baseName).append(".").append(std::to_string(bank + 1)).append(".").append(ext);
+	return filename;
+}
+
+// Patch position as shown on the device, e.g. "I11" for the first internal patch or "B88" for the last patch of the second bank
+static inline std::string GetPatchIndex(const uint32_t patch, const uint32_t numPatches, const bool isCard = false)
+{
+	std::string patchIndex;
+	if (isCard)
+		patchIndex = 'C';
+	else if (numPatches <= 64)
+		patchIndex = 'I';
+	else
+		patchIndex = 'A' + static_cast<char>(patch / 64u);
+	patchIndex += '1' + ((patch / 8u) % 8u);
+	patchIndex += '1' + (patch % 8u);
+	return patchIndex;
+}
+
+static inline std::string EscapeJSON(std::string_view str)
+{
+	std::string escaped;
+	escaped.reserve(str.size());
+	for (const char c : str)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+			escaped += c;
+		}
+		else if (static_cast<unsigned char>(c) < 0x20)
+		{
+			static constexpr char HEX[] = "0123456789abcdef";
+			escaped += "\\u00";
+			escaped += HEX[(c >> 4) & 0x0F];
+			escaped += HEX[c & 0x0F];
+		}
+		else
+		{
+			escaped += c;
+		}
+	}
+	return escaped;
+}
+
+// Set while the current thread is running ParallelFor work items. Nested ParallelFor calls then run serially, as all cores are already busy.
+inline bool &IsInParallelFor()
+{
+	thread_local bool inParallelFor = false;
+	return inParallelFor;
+}
+
+// Number of threads that a ParallelFor call with the given number of work items uses, including the calling thread
+inline size_t ParallelThreadCount(const size_t count)
+{
+	if (IsInParallelFor())
+		return std::min(count, size_t(1));
+	return std::min(count, size_t(std::max(std::thread::hardware_concurrency(), 1u)));
+}
+
+// Calls func(index) for every index in [0, count), spread over all CPU cores. The calling thread takes part in the work.
+// func may take the number of the thread (0 ... ParallelThreadCount(count) - 1) as a second argument to keep per-thread state.
+template<typename Func>
+void ParallelFor(const size_t count, const Func &func)
+{
+	std::atomic<size_t> nextIndex = 0;
+	const auto worker = [&](const size_t thread)
+	{
+		const bool wasInParallelFor = std::exchange(IsInParallelFor(), true);
+		for (size_t index = nextIndex++; index < count; index = nextIndex++)
+		{
+			if constexpr (std::is_invocable_v<const Func &, size_t, size_t>)
+				func(index, thread);
+			else
+				func(index);
+		}
+		IsInParallelFor() = wasInParallelFor;
+	};
+
+	const size_t numThreads = ParallelThreadCount(count);
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < numThreads; i++)
+	{
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for (auto &thread : threads)
+	{
+		thread.join();
+	}
+}
+
 template<typename T, typename... Targs>
 void Reconstruct(T &x, Targs &&... args)
 {
@@ -0,0 +1,232 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "Validate.hpp"
+#include "ParameterTables.hpp"
+#include "WaveformNames.hpp"
+
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JDTOOLS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+	// Per-byte representation of the parameter ranges of a struct, so that a whole patch can be range-checked in one pass:
+	// A byte is valid if ((value ^ bias) - low) <= span, computed with 8-bit wraparound.
+	// Signed parameters are biased by 0x80 to make their range contiguous, bytes without a parameter accept any value.
+	// 16-bit parameters cannot be expressed this way and are checked separately.
+	struct RangeMask
+	{
+		std::vector<uint8_t> bias, low, span;
+		std::vector<std::pair<uint32_t, const ParameterInfo *>> wideParameters;
+	};
+
+	RangeMask BuildRangeMask(std::span<const ParameterGroup> groups)
+	{
+		size_t size = 0;
+		for (const ParameterGroup &group : groups)
+		{
+			for (const ParameterInfo &param : group.parameters)
+			{
+				if (param.type == ParameterType::U8 || param.type == ParameterType::S8)
+					size = std::max(size, size_t(group.offset) + param.offset + 1);
+			}
+		}
+
+		RangeMask mask;
+		mask.bias.resize(size, 0);
+		mask.low.resize(size, 0);
+		mask.span.resize(size, 0xFF);
+		for (const ParameterGroup &group : groups)
+		{
+			for (const ParameterInfo &param : group.parameters)
+			{
+				const uint32_t offset = group.offset + param.offset;
+				if (param.type == ParameterType::U8 || param.type == ParameterType::S8)
+				{
+					const uint8_t bias = (param.type == ParameterType::S8) ? 0x80 : 0x00;
+					mask.bias[offset] = bias;
+					mask.low[offset] = static_cast<uint8_t>(param.minValue ^ bias);
+					mask.span[offset] = static_cast<uint8_t>(param.maxValue - param.minValue);
+				}
+				else
+				{
+					mask.wideParameters.emplace_back(offset, &param);
+				}
+			}
+		}
+		return mask;
+	}
+
+	template<typename T>
+	const RangeMask &GetRangeMask()
+	{
+		static const RangeMask mask = BuildRangeMask(ParameterGroups<T>());
+		return mask;
+	}
+
+	bool IsInRange(const void *patch, const RangeMask &mask) noexcept
+	{
+		const uint8_t *data = static_cast<const uint8_t *>(patch);
+		const size_t size = mask.span.size();
+		size_t i = 0;
+		bool outOfRange = false;
+#ifdef JDTOOLS_SSE2
+		// Saturating subtraction of the span yields zero for all valid bytes
+		__m128i excess = _mm_setzero_si128();
+		for (; i + 16 <= size; i += 16)
+		{
+			const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			const __m128i bias = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask.bias.data() + i));
+			const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask.low.data() + i));
+			const __m128i span = _mm_loadu_si128(reinterpret_cast<const __m128i *>(mask.span.data() + i));
+			excess = _mm_or_si128(excess, _mm_subs_epu8(_mm_sub_epi8(_mm_xor_si128(value, bias), low), span));
+		}
+		outOfRange = _mm_movemask_epi8(_mm_cmpeq_epi8(excess, _mm_setzero_si128())) != 0xFFFF;
+#endif
+		for (; i < size; i++)
+		{
+			outOfRange |= static_cast<uint8_t>((data[i] ^ mask.bias[i]) - mask.low[i]) > mask.span[i];
+		}
+
+		for (const auto &[offset, param] : mask.wideParameters)
+		{
+			const int32_t value = GetParameter(patch, offset, param->type);
+			outOfRange |= (value < param->minValue) | (value > param->maxValue);
+		}
+		return !outOfRange;
+	}
+
+	// Consistency checks that cannot be expressed as a simple range.
+	// report(prefix, name, value, message) is called for every issue.
+	template<typename Report>
+	void CheckTone(const Tone800 &tone, std::string_view prefix, Report &report)
+	{
+		if (tone.wg.waveSource == 0 && (tone.wg.waveformMSB != 0 || tone.wg.waveformLSB >= NUM_WAVEFORMS_800))
+			report(prefix, "wg.waveformLSB", (tone.wg.waveformMSB << 7) | tone.wg.waveformLSB, "Unknown internal waveform");
+	}
+
+	template<typename Report>
+	void CheckTone(const Tone990 &tone, std::string_view prefix, Report &report)
+	{
+		if (tone.wg.waveSource == 0 && static_cast<uint32_t>((tone.wg.waveformMSB << 7) | tone.wg.waveformLSB) >= NUM_WAVEFORMS_990)
+			report(prefix, "wg.waveformLSB", (tone.wg.waveformMSB << 7) | tone.wg.waveformLSB, "Unknown internal waveform");
+	}
+
+	template<typename Report>
+	void CheckKeyRange(const uint8_t low, const uint8_t high, std::string_view name, Report &report)
+	{
+		if (low > high)
+			report("", name, low, "Lower key range is above upper key range");
+	}
+
+	template<typename Report>
+	void CheckConsistency(const Patch800 &patch, Report &report)
+	{
+		CheckKeyRange(patch.common.keyRangeLowA, patch.common.keyRangeHighA, "common.keyRangeLowA", report);
+		CheckKeyRange(patch.common.keyRangeLowB, patch.common.keyRangeHighB, "common.keyRangeLowB", report);
+		CheckKeyRange(patch.common.keyRangeLowC, patch.common.keyRangeHighC, "common.keyRangeLowC", report);
+		CheckKeyRange(patch.common.keyRangeLowD, patch.common.keyRangeHighD, "common.keyRangeLowD", report);
+		CheckTone(patch.toneA, "toneA.", report);
+		CheckTone(patch.toneB, "toneB.", report);
+		CheckTone(patch.toneC, "toneC.", report);
+		CheckTone(patch.toneD, "toneD.", report);
+	}
+
+	template<typename Report>
+	void CheckConsistency(const Patch990 &patch, Report &report)
+	{
+		CheckKeyRange(patch.keyRanges.keyRangeLowA, patch.keyRanges.keyRangeHighA, "keyRanges.keyRangeLowA", report);
+		CheckKeyRange(patch.keyRanges.keyRangeLowB, patch.keyRanges.keyRangeHighB, "keyRanges.keyRangeLowB", report);
+		CheckKeyRange(patch.keyRanges.keyRangeLowC, patch.keyRanges.keyRangeHighC, "keyRanges.keyRangeLowC", report);
+		CheckKeyRange(patch.keyRanges.keyRangeLowD, patch.keyRanges.keyRangeHighD, "keyRanges.keyRangeLowD", report);
+		CheckTone(patch.toneA, "toneA.", report);
+		CheckTone(patch.toneB, "toneB.", report);
+		CheckTone(patch.toneC, "toneC.", report);
+		CheckTone(patch.toneD, "toneD.", report);
+	}
+
+	template<typename Report>
+	void CheckConsistency(const PatchVST &patch, Report &report)
+	{
+		CheckKeyRange(patch.common.keyRangeLowA, patch.common.keyRangeHighA, "common.keyRangeLowA", report);
+		CheckKeyRange(patch.common.keyRangeLowB, patch.common.keyRangeHighB, "common.keyRangeLowB", report);
+		CheckKeyRange(patch.common.keyRangeLowC, patch.common.keyRangeHighC, "common.keyRangeLowC", report);
+		CheckKeyRange(patch.common.keyRangeLowD, patch.common.keyRangeHighD, "common.keyRangeLowD", report);
+	}
+
+	template<typename Setup, typename Report>
+	void CheckSetupConsistency(const Setup &setup, Report &report)
+	{
+		// Group layout: common block, then key parameters and tone parameters for each key
+		const auto groups = ParameterGroups<Setup>();
+		for (size_t key = 0; key < setup.keys.size(); key++)
+		{
+			CheckTone(setup.keys[key].tone, groups[2 + key * 2].prefix, report);
+		}
+	}
+
+	template<typename Report>
+	void CheckConsistency(const SpecialSetup800 &setup, Report &report)
+	{
+		CheckSetupConsistency(setup, report);
+	}
+
+	template<typename Report>
+	void CheckConsistency(const SpecialSetup990 &setup, Report &report)
+	{
+		CheckSetupConsistency(setup, report);
+	}
+
+	template<typename T>
+	bool IsValid(const T &patch)
+	{
+		if (!IsInRange(&patch, GetRangeMask<T>()))
+			return false;
+		bool valid = true;
+		auto report = [&valid](std::string_view, std::string_view, int32_t, std::string_view) { valid = false; };
+		CheckConsistency(patch, report);
+		return valid;
+	}
+
+	template<typename T>
+	std::vector<ValidationIssue> Validate(const T &patch)
+	{
+		std::vector<ValidationIssue> issues;
+		ForEachOutOfRange(ParameterGroups<T>(), &patch, [&issues](const ParameterGroup &group, const ParameterInfo &param, const int32_t value)
+		{
+			issues.push_back({ParameterPath(group, param), value, "Value out of range " + std::to_string(param.minValue) + "-" + std::to_string(param.maxValue)});
+		});
+		auto report = [&issues](std::string_view prefix, std::string_view name, const int32_t value, std::string_view message)
+		{
+			issues.push_back({std::string{prefix}.append(name), value, std::string{message}});
+		};
+		CheckConsistency(patch, report);
+		return issues;
+	}
+}
+
+bool IsPatchValid(const Patch800 &patch) { return IsValid(patch); }
+bool IsPatchValid(const Patch990 &patch) { return IsValid(patch); }
+bool IsPatchValid(const PatchVST &patch) { return IsValid(patch); }
+bool IsPatchValid(const SpecialSetup800 &setup) { return IsValid(setup); }
+bool IsPatchValid(const SpecialSetup990 &setup) { return IsValid(setup); }
+
+std::vector<ValidationIssue> ValidatePatch(const Patch800 &patch) { return Validate(patch); }
+std::vector<ValidationIssue> ValidatePatch(const Patch990 &patch) { return Validate(patch); }
+std::vector<ValidationIssue> ValidatePatch(const PatchVST &patch) { return Validate(patch); }
+std::vector<ValidationIssue> ValidatePatch(const SpecialSetup800 &setup) { return Validate(setup); }
+std::vector<ValidationIssue> ValidatePatch(const SpecialSetup990 &setup) { return Validate(setup); }
+
+bool PrintValidationIssues(std::string_view patchIndex, std::string_view name, const std::vector<ValidationIssue> &issues)
+{
+	for (const ValidationIssue &issue : issues)
+	{
+		std::cout << patchIndex << ": " << name << ": " << issue.parameter << " = " << issue.value << ": " << issue.message << std::endl;
+	}
+	return issues.empty();
+}
@@ -0,0 +1,41 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct Patch800;
+struct Patch990;
+struct PatchVST;
+struct SpecialSetup800;
+struct SpecialSetup990;
+
+struct ValidationIssue
+{
+	std::string parameter;  // Parameter path as found in the parameter tables, e.g. "toneA.tvf.cutoffFreq"
+	int32_t value;          // Stored value
+	std::string message;
+};
+
+// Quick check whether all parameters are within their legal range and consistent with each other.
+// This is the fast path for screening large numbers of patches, use ValidatePatch to find out what is wrong.
+bool IsPatchValid(const Patch800 &patch);
+bool IsPatchValid(const Patch990 &patch);
+bool IsPatchValid(const PatchVST &patch);
+bool IsPatchValid(const SpecialSetup800 &setup);
+bool IsPatchValid(const SpecialSetup990 &setup);
+
+// Returns a list of all invalid parameters. An empty list means that the patch is valid.
+std::vector<ValidationIssue> ValidatePatch(const Patch800 &patch);
+std::vector<ValidationIssue> ValidatePatch(const Patch990 &patch);
+std::vector<ValidationIssue> ValidatePatch(const PatchVST &patch);
+std::vector<ValidationIssue> ValidatePatch(const SpecialSetup800 &setup);
+std::vector<ValidationIssue> ValidatePatch(const SpecialSetup990 &setup);
+
+// Prints all issues of a patch, prefixed with the patch index and name. Returns false if there were any issues.
+bool PrintValidationIssues(std::string_view patchIndex, std::string_view name, const std::vector<ValidationIssue> &issues);
@@ -0,0 +1,215 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#include "VerifyTree.hpp"
+#include "Arena.hpp"
+#include "InputFile.hpp"
+#include "SVZ.hpp"
+#include "SysEx.hpp"
+#include "Trace.hpp"
+#include "Utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+	enum FileKind
+	{
+		KIND_SYSEX,
+		KIND_BIN,
+		KIND_SVZ,
+		KIND_SVD,
+		NUM_KINDS,
+	};
+
+	constexpr std::array<const char *, NUM_KINDS> KIND_NAMES = { "SYX/MID", "BIN", "SVZ", "SVD" };
+
+	struct FileResult
+	{
+		std::filesystem::path path;
+		FileKind kind = KIND_SYSEX;
+		uint32_t numItems = 0;  // SysEx messages or patches
+		std::string error;
+	};
+
+	bool HasVerifiableExtension(const std::filesystem::path &path)
+	{
+		std::string ext = path.extension().string();
+		std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+		return ext == ".syx" || ext == ".mid" || ext == ".bin" || ext == ".svd" || ext == ".svz";
+	}
+
+	void VerifySysEx(InputFile &inputFile, FileResult &result)
+	{
+		std::vector<uint8_t> buffer;
+		std::vector<SysExFrame> frames, checksumFrames;
+		inputFile.ReadAllSysExMessages(buffer, frames);
+		for (const SysExFrame &frame : frames)
+		{
+			const uint8_t *message = buffer.data() + frame.offset;
+			if (frame.size >= 6 && message[0] == 0x41 && (message[2] == 0x3D || message[2] == 0x57) && message[3] == 0x12)
+				checksumFrames.push_back({frame.offset + 4, frame.size - 5});
+		}
+
+		result.numItems = static_cast<uint32_t>(checksumFrames.size());
+		if (checksumFrames.empty())
+		{
+			result.error = "No SysEx messages for either JD-800 or JD-990";
+		}
+		else
+		{
+			const std::vector<bool> valid = VerifyRolandChecksums(buffer, checksumFrames);
+			const auto numInvalid = std::count(valid.begin(), valid.end(), false);
+			if (numInvalid)
+				result.error = "Invalid SysEx checksum in " + std::to_string(numInvalid) + " of " + std::to_string(valid.size()) + " messages";
+		}
+
+		// Structural problems of MIDI files fail the file as well, even if all messages that could be extracted are fine
+		for (const std::string &warning : inputFile.Warnings())
+		{
+			if (!result.error.empty())
+				result.error += "; ";
+			result.error += warning;
+		}
+	}
+
+	void VerifyFile(FileResult &result, Arena &scratch)
+	{
+		TraceScope fileScope{"file", "verify file", result.path.generic_string()};
+		std::ifstream inFile{result.path, std::ios::binary};
+		if (!inFile)
+		{
+			result.error = "Could not open file for reading";
+			return;
+		}
+
+		// Trust the contents more than the file extension
+		// Warnings become part of the result instead of being printed, so that they are attributed to the file
+		InputFile inputFile{inFile, false};
+		ContainerCheck check;
+		switch (inputFile.GetType())
+		{
+		case InputFile::Type::SYX:
+		case InputFile::Type::MID:
+			result.kind = KIND_SYSEX;
+			VerifySysEx(inputFile, result);
+			return;
+		case InputFile::Type::SVZplugin:
+			result.kind = KIND_BIN;
+			check = VerifySVZ(inFile, &scratch);
+			break;
+		case InputFile::Type::SVZhardware:
+			result.kind = KIND_SVZ;
+			check = VerifySVZ(inFile, &scratch);
+			break;
+		case InputFile::Type::SVD:
+			result.kind = KIND_SVD;
+			check = VerifySVD(inFile, &scratch);
+			break;
+		}
+		result.numItems = check.numPatches;
+		result.error = std::move(check.error);
+	}
+
+	bool WriteFailuresJSON(const std::string &filename, std::string_view rootDir, const std::vector<FileResult> &results, const size_t numFailed)
+	{
+		std::ofstream f{filename, std::ios::trunc};
+		if (!f)
+			return false;
+
+		f << "{\n  \"root\": \"" << EscapeJSON(rootDir) << "\",\n"
+			<< "  \"files\": " << results.size() << ",\n"
+			<< "  \"failed\": " << numFailed << ",\n"
+			<< "  \"failures\": [";
+		bool first = true;
+		for (const auto &result : results)
+		{
+			if (result.error.empty())
+				continue;
+			f << (first ? "\n" : ",\n")
+				<< "    {\"path\": \"" << EscapeJSON(result.path.generic_string())
+				<< "\", \"type\": \"" << KIND_NAMES[result.kind]
+				<< "\", \"error\": \"" << EscapeJSON(result.error) << "\"}";
+			first = false;
+		}
+		f << (first ? "]\n}\n" : "\n  ]\n}\n");
+		return f.good();
+	}
+}
+
+int VerifyTree(const std::string_view rootDir, const std::string_view jsonFilename)
+{
+	std::vector<FileResult> results;
+	std::error_code ec;
+	std::filesystem::recursive_directory_iterator it{std::filesystem::path{rootDir}, std::filesystem::directory_options::skip_permission_denied, ec};
+	for (; !ec && it != std::filesystem::recursive_directory_iterator{}; it.increment(ec))
+	{
+		if (it->is_regular_file(ec) && HasVerifiableExtension(it->path()))
+			results.push_back({it->path()});
+	}
+	if (ec)
+	{
+		std::cout << "Could not scan " << rootDir << ": " << ec.message() << std::endl;
+		return 2;
+	}
+	if (results.empty())
+	{
+		std::cout << "No SYX / MID / BIN / SVD / SVZ files found in " << rootDir << "!" << std::endl;
+		return 2;
+	}
+
+	// Directory iteration order is unspecified, keep the report stable
+	std::sort(results.begin(), results.end(), [](const FileResult &l, const FileResult &r) { return l.path < r.path; });
+
+	std::cout << "Verifying " << results.size() << " files in " << rootDir << "..." << std::endl;
+
+	// MIDI files are tokenized serially within each worker, as the files are already spread over all cores
+	std::vector<Arena> scratch(ParallelThreadCount(results.size()));
+	ParallelFor(results.size(), [&](const size_t file, const size_t thread)
+	{
+		scratch[thread].Reset();
+		VerifyFile(results[file], scratch[thread]);
+	});
+
+	std::array<size_t, NUM_KINDS> numFiles{}, numFailedFiles{}, numItems{};
+	size_t numFailed = 0;
+	for (const auto &result : results)
+	{
+		numFiles[result.kind]++;
+		numItems[result.kind] += result.numItems;
+		if (!result.error.empty())
+		{
+			std::cout << "FAILED: " << result.path.string() << ": " << result.error << std::endl;
+			numFailedFiles[result.kind]++;
+			numFailed++;
+		}
+	}
+
+	std::cout << std::endl << "Summary:" << std::endl;
+	for (size_t kind = 0; kind < NUM_KINDS; kind++)
+	{
+		if (!numFiles[kind])
+			continue;
+		std::cout << "  " << KIND_NAMES[kind] << ": " << numFiles[kind] << " files, " << numFailedFiles[kind] << " failed, "
+			<< numItems[kind] << (kind == KIND_SYSEX ? " SysEx messages" : " patches") << std::endl;
+	}
+	std::cout << results.size() << " files verified, " << numFailed << " failed." << std::endl;
+
+	if (!jsonFilename.empty() && !WriteFailuresJSON(std::string{jsonFilename}, rootDir, results, numFailed))
+	{
+		std::cout << "Could not write " << jsonFilename << "!" << std::endl;
+		return 2;
+	}
+
+	return numFailed ? 3 : 0;
+}
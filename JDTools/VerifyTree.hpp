@@ -0,0 +1,11 @@
+// JDTools - Patch conversion utility for Roland JD-800 / JD-990
+// 2022 - 2024 by Johannes Schultz
+// License: BSD 3-clause
+
+#pragma once
+
+#include <string_view>
+
+// Recursively verifies all SYX / MID / BIN / SVD / SVZ files below a directory.
+// Optionally writes the list of failed files as JSON. Returns the program exit code.
+int VerifyTree(std::string_view rootDir, std::string_view jsonFilename);
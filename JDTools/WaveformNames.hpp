@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <iterator>
+
 static constexpr const char *WaveformNames[] =
 {
 	"None",
@@ -203,3 +206,7 @@ static constexpr const char *WaveformNames[] =
 	"Loop 3",
 	"Loop 4",
 };
+
+// WaveformNames starts with "None", followed by the 108 JD-800 waveforms and the additional JD-990 waveforms
+static constexpr uint32_t NUM_WAVEFORMS_800 = 108;
+static constexpr uint32_t NUM_WAVEFORMS_990 = static_cast<uint32_t>(std::size(WaveformNames) - 1);